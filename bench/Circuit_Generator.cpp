@@ -0,0 +1,208 @@
+/// ------------------------------------------
+/// @file Circuit_Generator.cpp
+///
+/// @brief Source for synthetic netlist generators used by the benchmarks
+/// ------------------------------------------
+
+#include "Circuit_Generator.h"
+
+#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+///--------------------------------------------------------
+std::string topologyName(const Circuit_Topology_t& topology)
+{
+    switch(topology)
+    {
+        case Circuit_Topology_t::rc_ladder:
+            return "ladder";
+
+        case Circuit_Topology_t::mesh_2d:
+            return "mesh2d";
+
+        case Circuit_Topology_t::mesh_3d:
+            return "mesh3d";
+
+        case Circuit_Topology_t::random_graph:
+            return "random";
+
+        case Circuit_Topology_t::star:
+            return "star";
+    }
+
+    throw std::invalid_argument("Unknown topology");
+}
+
+///--------------------------------------------------------
+Circuit_Topology_t topologyFromName(const std::string& name)
+{
+    for (Circuit_Topology_t topology : allTopologies())
+    {
+        if (topologyName(topology) == name)
+        {
+            return topology;
+        }
+    }
+
+    throw std::invalid_argument("Unknown topology: " + name);
+}
+
+///--------------------------------------------------------
+std::vector<Circuit_Topology_t> allTopologies()
+{
+    return {
+        Circuit_Topology_t::rc_ladder,
+        Circuit_Topology_t::mesh_2d,
+        Circuit_Topology_t::mesh_3d,
+        Circuit_Topology_t::random_graph,
+        Circuit_Topology_t::star
+        };
+}
+
+///--------------------------------------------------------
+std::string generateNetlist(const Circuit_Topology_t& topology, const size_t& nodes, const bool& ac, const uint32_t& seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> resistance(1, 100);
+
+    // Node to node branches, ground is -1
+    std::vector<std::pair<long, long>> branches;
+    size_t nodeCount = nodes;
+
+    switch(topology)
+    {
+        case Circuit_Topology_t::rc_ladder:
+            for (size_t i = 0; i + 1 < nodeCount; i++)
+            {
+                branches.push_back({i, i + 1});
+            }
+            break;
+
+        case Circuit_Topology_t::mesh_2d:
+        {
+            size_t side = std::max<size_t>(2, std::lround(std::sqrt((double) nodes)));
+            nodeCount = side * side;
+            for (size_t i = 0; i < side; i++)
+            {
+                for (size_t j = 0; j < side; j++)
+                {
+                    size_t node = i * side + j;
+                    if (j + 1 < side)
+                    {
+                        branches.push_back({node, node + 1});
+                    }
+                    if (i + 1 < side)
+                    {
+                        branches.push_back({node, node + side});
+                    }
+                }
+            }
+            break;
+        }
+
+        case Circuit_Topology_t::mesh_3d:
+        {
+            size_t side = std::max<size_t>(2, std::lround(std::cbrt((double) nodes)));
+            nodeCount = side * side * side;
+            for (size_t i = 0; i < side; i++)
+            {
+                for (size_t j = 0; j < side; j++)
+                {
+                    for (size_t k = 0; k < side; k++)
+                    {
+                        size_t node = (i * side + j) * side + k;
+                        if (k + 1 < side)
+                        {
+                            branches.push_back({node, node + 1});
+                        }
+                        if (j + 1 < side)
+                        {
+                            branches.push_back({node, node + side});
+                        }
+                        if (i + 1 < side)
+                        {
+                            branches.push_back({node, node + side * side});
+                        }
+                    }
+                }
+            }
+            break;
+        }
+
+        case Circuit_Topology_t::random_graph:
+        {
+            // chain keeps the graph connected, extra branches give an average degree of ~6
+            std::uniform_int_distribution<size_t> pick(0, nodeCount - 1);
+            for (size_t i = 0; i + 1 < nodeCount; i++)
+            {
+                branches.push_back({i, i + 1});
+            }
+            for (size_t i = 0; i < 2 * nodeCount; i++)
+            {
+                size_t a = pick(rng);
+                size_t b = pick(rng);
+                if (a != b)
+                {
+                    branches.push_back({a, b});
+                }
+            }
+            break;
+        }
+
+        case Circuit_Topology_t::star:
+            for (size_t i = 1; i < nodeCount; i++)
+            {
+                branches.push_back({0, i});
+            }
+            break;
+    }
+
+    std::string netlist;
+    netlist.reserve((branches.size() + 2 * nodeCount) * 24);
+
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        netlist += "N" + std::to_string(i) + (i + 1 == nodeCount ? "\n" : " ");
+    }
+
+    if (ac)
+    {
+        netlist += "1k\n";
+    }
+
+    netlist += ac ? "I 1,0 N0 GND\n" : "I 1 N0 GND\n";
+
+    // Every eighth branch is an inductor in AC so all three passive types are present
+    for (size_t b = 0; b < branches.size(); b++)
+    {
+        std::string first = "N" + std::to_string(branches[b].first);
+        std::string second = "N" + std::to_string(branches[b].second);
+        if (ac and b % 8 == 7)
+        {
+            netlist += "L " + std::to_string(resistance(rng)) + "m " + first + " " + second + "\n";
+        }
+        else
+        {
+            netlist += "R " + std::to_string(resistance(rng)) + " " + first + " " + second + "\n";
+        }
+    }
+
+    // Shunts to ground keep every system non singular
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        std::string node = "N" + std::to_string(i);
+        if (ac)
+        {
+            netlist += "C " + std::to_string(resistance(rng)) + "n " + node + " GND\n";
+        }
+
+        if (!ac or topology == Circuit_Topology_t::rc_ladder)
+        {
+            netlist += "R " + std::to_string(resistance(rng)) + "k " + node + " GND\n";
+        }
+    }
+
+    return netlist;
+}
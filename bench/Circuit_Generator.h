@@ -0,0 +1,68 @@
+/// ------------------------------------------
+/// @file Circuit_Generator.h
+///
+/// @brief Header for synthetic netlist generators used by the benchmarks
+/// ------------------------------------------
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/// @brief Shapes of generated circuits
+enum class Circuit_Topology_t
+{
+    /// @brief Chain of series resistors with a shunt to ground at every node, like input/ACTest.txt
+    rc_ladder,
+
+    /// @brief Square grid of resistors
+    mesh_2d,
+
+    /// @brief Cubic grid of resistors
+    mesh_3d,
+
+    /// @brief Spanning chain plus random extra resistors, average degree ~6
+    random_graph,
+
+    /// @brief One hub node connected to every other node
+    star
+};
+
+///--------------------------------------------------------
+/// @brief Gets the short name of a topology, used on the command line and in results
+///
+/// @param topology topology to name
+///
+/// @return name of the topology
+std::string topologyName(const Circuit_Topology_t& topology);
+
+///--------------------------------------------------------
+/// @brief Finds a topology from its short name
+///
+/// @param name name given by topologyName()
+///
+/// @return matching topology
+///
+/// @throws std::invalid_argument if no topology has the name
+Circuit_Topology_t topologyFromName(const std::string& name);
+
+///--------------------------------------------------------
+/// @brief Lists every topology
+///
+/// @return all topologies
+std::vector<Circuit_Topology_t> allTopologies();
+
+///--------------------------------------------------------
+/// @brief Generates the text of a netlist in the same format as the input files
+///
+/// @note Meshes are rounded to the nearest full square/cube so may have
+/// slightly fewer or more nodes than requested
+///
+/// @param topology shape of the circuit
+/// @param nodes approximate number of non-ground nodes
+/// @param ac generate an AC netlist (frequency line, capacitors and inductors)
+/// rather than a resistor only DC netlist
+/// @param seed random seed, the same seed always gives the same netlist
+///
+/// @return netlist text
+std::string generateNetlist(const Circuit_Topology_t& topology, const size_t& nodes, const bool& ac, const uint32_t& seed);
@@ -0,0 +1,283 @@
+/// ------------------------------------------
+/// @file Nodal_Analysis_bench.cpp
+///
+/// @brief Start point for the nodal analysis benchmarks, times each stage of
+/// DC and AC analyses on generated circuits and prints the results as CSV or JSON
+/// ------------------------------------------
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <limits>
+
+#include "Circuit_Generator.h"
+#include "../inc/Netlist_Parser.h"
+#include "../inc/Nodal_Analysis.h"
+#include "../inc/Sparse_LU.h"
+
+using std::cout;
+using std::endl;
+
+/// @brief Timings of a single benchmark case, each stage is the fastest of all repetitions
+struct Bench_Result_t
+{
+    /// @brief Generated topology
+    Circuit_Topology_t topology;
+
+    /// @brief Was the AC analysis run (true) or the DC analysis (false)
+    bool ac;
+
+    /// @brief Number of non-ground nodes
+    size_t nodes;
+
+    /// @brief Number of components in the netlist
+    size_t components;
+
+    /// @brief Stored entries in the admittance matrix
+    size_t matrix_non_zeros;
+
+    /// @brief Stored entries in the L and U factors
+    size_t factor_non_zeros;
+
+    /// @brief Seconds to parse the netlist text
+    double parse_time = std::numeric_limits<double>::max();
+
+    /// @brief Seconds to stamp the components into the system
+    double stamp_time = std::numeric_limits<double>::max();
+
+    /// @brief Seconds to order and factor the system
+    double factor_time = std::numeric_limits<double>::max();
+
+    /// @brief Seconds to solve for the node voltages
+    double solve_time = std::numeric_limits<double>::max();
+
+    /// @brief Seconds to format the voltages as text
+    double output_time = std::numeric_limits<double>::max();
+};
+
+///--------------------------------------------------------
+/// @brief Runs a function and keeps the fastest time seen
+///
+/// @param best fastest time so far in seconds, updated in place
+/// @param func function to time
+template <typename F>
+void timeStage(double& best, F&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+}
+
+///--------------------------------------------------------
+/// @brief Times every stage of a single analysis of a netlist
+///
+/// @tparam Analysis_T Nodal_Analysis_DC_t or Nodal_Analysis_AC_t
+/// @tparam T value type of the system, double or Complex_C_t
+///
+/// @param netlistText generated netlist
+/// @param result results to fill, stage timings are kept as the fastest run
+/// @param compile function stamping a parsed netlist into an analysis
+/// @param admittance function getting the admittance matrix of an analysis
+template <typename Analysis_T, typename T>
+void benchAnalysis(const std::string& netlistText, Bench_Result_t& result,
+    const std::function<Analysis_T(const Netlist_t&)>& compile,
+    const std::function<const Sparse_Matrix<T>&(const Analysis_T&)>& admittance)
+{
+    Netlist_t netlist;
+    timeStage(result.parse_time, [&]() { netlist = parseNetlist(netlistText, result.ac ? 1 : 0); });
+
+    Analysis_T analysis = compile(netlist);
+    timeStage(result.stamp_time, [&]() { analysis = compile(netlist); });
+
+    Sparse_LU<T> lu;
+    timeStage(result.factor_time, [&]()
+    {
+        lu.analyze(admittance(analysis));
+        lu.factor(admittance(analysis));
+    });
+
+    Matrix<T> voltages(1, 1);
+    timeStage(result.solve_time, [&]() { voltages = lu.solve(analysis.net_currents); });
+
+    std::ostringstream out;
+    timeStage(result.output_time, [&]()
+    {
+        for (auto res : expandNodeVoltages(analysis.node_names, analysis.reduction, voltages))
+        {
+            out << res.first << ": " << res.second << '\n';
+        }
+    });
+
+    result.nodes = netlist.node_names.size();
+    result.components = netlist.components.size();
+    result.matrix_non_zeros = admittance(analysis).getNonZeroCount();
+    result.factor_non_zeros = lu.getFactorNonZeroCount();
+}
+
+///--------------------------------------------------------
+/// @brief Splits a comma seperated argument value
+///
+/// @param list text to split
+///
+/// @return each non-empty item of the list
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+///--------------------------------------------------------
+/// @brief Prints all results as CSV, one row per case
+///
+/// @param results results to print
+void printCSV(const std::vector<Bench_Result_t>& results)
+{
+    cout << "topology,analysis,nodes,components,matrix_nnz,factor_nnz,parse_s,stamp_s,factor_s,solve_s,output_s" << endl;
+    for (const Bench_Result_t& res : results)
+    {
+        cout << topologyName(res.topology) << "," << (res.ac ? "AC" : "DC") << "," << res.nodes << "," <<
+            res.components << "," << res.matrix_non_zeros << "," << res.factor_non_zeros << "," <<
+            res.parse_time << "," << res.stamp_time << "," << res.factor_time << "," <<
+            res.solve_time << "," << res.output_time << endl;
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Prints all results as a JSON array, one object per case
+///
+/// @param results results to print
+void printJSON(const std::vector<Bench_Result_t>& results)
+{
+    cout << "[" << endl;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Bench_Result_t& res = results[i];
+        cout << "  {\"topology\": \"" << topologyName(res.topology) << "\", \"analysis\": \"" << (res.ac ? "AC" : "DC") <<
+            "\", \"nodes\": " << res.nodes << ", \"components\": " << res.components <<
+            ", \"matrix_nnz\": " << res.matrix_non_zeros << ", \"factor_nnz\": " << res.factor_non_zeros <<
+            ", \"parse_s\": " << res.parse_time << ", \"stamp_s\": " << res.stamp_time <<
+            ", \"factor_s\": " << res.factor_time << ", \"solve_s\": " << res.solve_time <<
+            ", \"output_s\": " << res.output_time << "}" << (i + 1 == results.size() ? "" : ",") << endl;
+    }
+    cout << "]" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string format = "csv";
+    std::vector<size_t> sizes = {100, 1000, 10000};
+    std::vector<Circuit_Topology_t> topologies = allTopologies();
+    std::vector<std::string> analyses = {"DC", "AC"};
+    size_t repetitions = 3;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        size_t equals = arg.find('=');
+        std::string key = arg.substr(0, equals);
+        std::string value = (equals == std::string::npos) ? "" : arg.substr(equals + 1);
+
+        if (key == "format" and (value == "csv" or value == "json"))
+        {
+            format = value;
+        }
+        else if (key == "sizes")
+        {
+            sizes.clear();
+            for (const std::string& size : splitList(value))
+            {
+                sizes.push_back(std::stoul(size));
+            }
+        }
+        else if (key == "topologies")
+        {
+            topologies.clear();
+            for (const std::string& name : splitList(value))
+            {
+                topologies.push_back(topologyFromName(name));
+            }
+        }
+        else if (key == "analyses")
+        {
+            analyses = splitList(value);
+        }
+        else if (key == "reps")
+        {
+            repetitions = std::max<size_t>(1, std::stoul(value));
+        }
+        else if (key == "seed")
+        {
+            seed = std::stoul(value);
+        }
+        else
+        {
+            cout << "Arguments: [format=csv|json] [sizes=100,1000,...] [topologies=ladder,mesh2d,mesh3d,random,star] " <<
+                "[analyses=DC,AC] [reps=3] [seed=1]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Bench_Result_t> results;
+    for (Circuit_Topology_t topology : topologies)
+    {
+        for (const std::string& analysis : analyses)
+        {
+            bool ac = (analysis == "AC");
+            if (!ac and analysis != "DC")
+            {
+                cout << "Unknown analysis type: " + analysis << endl;
+                return EXIT_FAILURE;
+            }
+
+            for (size_t size : sizes)
+            {
+                std::string netlistText = generateNetlist(topology, size, ac, seed);
+
+                Bench_Result_t result;
+                result.topology = topology;
+                result.ac = ac;
+
+                for (size_t rep = 0; rep < repetitions; rep++)
+                {
+                    if (ac)
+                    {
+                        benchAnalysis<Nodal_Analysis_AC_t, Complex_C_t>(netlistText, result, compileACAnalysis,
+                            [](const Nodal_Analysis_AC_t& a) -> const Sparse_Matrix<Complex_C_t>& { return a.admittance_mat; });
+                    }
+                    else
+                    {
+                        benchAnalysis<Nodal_Analysis_DC_t, double>(netlistText, result, compileDCAnalysis,
+                            [](const Nodal_Analysis_DC_t& a) -> const Sparse_Matrix<double>& { return a.conductance_mat; });
+                    }
+                }
+
+                results.push_back(result);
+            }
+        }
+    }
+
+    if (format == "json")
+    {
+        printJSON(results);
+    }
+    else
+    {
+        printCSV(results);
+    }
+
+    return EXIT_SUCCESS;
+}
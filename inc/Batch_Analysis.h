@@ -0,0 +1,73 @@
+/// ------------------------------------------
+/// @file Batch_Analysis.h
+///
+/// @brief Header for solving many netlists in one process
+///
+/// @note Files are parsed and solved concurrently, each file's output is collected
+/// as text and written in list order so runs with any thread count match
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Nodal_Analysis.h"
+
+/// @brief One netlist of a batch
+struct Batch_Entry_t
+{
+    /// @brief Analysis to run, 'A' (AC) or 'D' (DC)
+    char type;
+
+    /// @brief Path of the netlist file
+    std::string path;
+};
+
+/// @brief Outcome of a batch
+struct Batch_Stats_t
+{
+    /// @brief Netlists solved
+    size_t solved = 0;
+
+    /// @brief Netlists that could not be read or solved
+    size_t failed = 0;
+};
+
+///--------------------------------------------------------
+/// @brief Reads a batch manifest, each line is in the form [A/D] [path]
+///
+/// @note Relative paths are relative to the manifest's directory
+///
+/// @param filename local path of the manifest
+///
+/// @return entries in manifest order
+///
+/// @throws std::invalid_argument if a line is malformed or has an unknown type
+std::vector<Batch_Entry_t> readBatchManifest(const std::string& filename);
+
+///--------------------------------------------------------
+/// @brief Lists every regular file of a directory as a batch
+///
+/// @param directory local path of the directory
+/// @param type analysis to run on every file, 'A' or 'D'
+///
+/// @return entries sorted by path
+///
+/// @throws std::invalid_argument if the directory cannot be read or the type is unknown
+std::vector<Batch_Entry_t> listBatchDirectory(const std::string& directory, const char& type);
+
+///--------------------------------------------------------
+/// @brief Parses and solves every netlist of a batch with the sparse LU solver
+///
+/// @note A file that fails only produces an error line in its own section. Sections
+/// are written in entry order, a window of entries at a time
+///
+/// @param entries netlists to solve
+/// @param out stream receiving one section per entry: a "[type] path" line followed
+/// by one "node: voltage" line per node or a single "Error: message" line
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return number of netlists solved and failed
+Batch_Stats_t batchNodalAnalysis(const std::vector<Batch_Entry_t>& entries, std::ostream& out,
+    const size_t& threadCount = 0);
@@ -0,0 +1,159 @@
+/// ------------------------------------------
+/// @file Complex_F.h
+///
+/// @brief Header file for the single precision cartesian complex number structure
+///
+/// @note Only used as the storage type of low precision factorizations, half the
+/// size of Complex_C_t so factoring and solving move half the memory. Arithmetic
+/// is done in single precision, mixed precision solvers convert with
+/// cartToSingle() and singleToCart()
+/// ------------------------------------------
+#pragma once
+
+#include "Complex_C.h"
+
+/// @brief Complex number structure, cartesian form, single precision
+struct Complex_F_t
+{
+    /// @brief real component of complex
+    float m_real;
+
+    /// @brief imaginary component of complex
+    float m_imagine;
+
+    ///--------------------------------------------------------
+    /// @brief Default constructor
+    Complex_F_t()
+    {
+        m_real = 0;
+        m_imagine = 0;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Constructor
+    ///
+    /// @param real real component
+    /// @param imagine imaginary component
+    Complex_F_t(const float& real, const float& imagine)
+    {
+        m_real = real;
+        m_imagine = imagine;
+    }
+
+    ///--------------------------------------------------------
+    /// @brief Cast constructor using a real number
+    /// @param num real number to cast to complex
+    Complex_F_t(const float& real)
+    {
+        m_real = real;
+        m_imagine = 0;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Find the conjugate of complex number
+    ///
+    /// @return conjugate of complex
+    Complex_F_t conjugate() const;
+
+    /// @brief Find the absolute value of the input com
+    ///
+    /// @return absolute value of complex number
+    double absolute() const;
+};
+
+///--------------------------------------------------------
+/// @brief Overload of +, adds two complex numbers together
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_F_t operator+(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of -, subtracts two complex numbers
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_F_t operator-(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of *, multiplies two complex numbers together
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_F_t operator*(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of /, divides two complex numbers
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return resulting complex number
+Complex_F_t operator/(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of /, divides a complex by a real number
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return resulting complex number
+Complex_F_t operator/(const Complex_F_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of ==, checks if two complex numbers are equal
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return are the complex numbers equal?
+bool operator==(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of ==, checks if a complex number equals a real number
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return are the numbers equal?
+bool operator==(const Complex_F_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Overload of !=, checks if two complex numbers differ
+///
+/// @param lcom left hand complex
+/// @param rcom right hand complex
+///
+/// @return are the complex numbers not equal?
+bool operator!=(const Complex_F_t& lcom, const Complex_F_t& rcom);
+
+///--------------------------------------------------------
+/// @brief Overload of !=, checks if a complex number differs from a real number
+///
+/// @param lcom left hand complex
+/// @param rreal right hand real
+///
+/// @return are the numbers not equal?
+bool operator!=(const Complex_F_t& lcom, const double& rreal);
+
+///--------------------------------------------------------
+/// @brief Rounds a double precision complex number to single precision
+///
+/// @param cart double precision complex number
+///
+/// @return nearest single precision complex number
+Complex_F_t cartToSingle(const Complex_C_t& cart);
+
+///--------------------------------------------------------
+/// @brief Widens a single precision complex number to double precision, exactly
+///
+/// @param single single precision complex number
+///
+/// @return double precision complex number
+Complex_C_t singleToCart(const Complex_F_t& single);
@@ -68,6 +68,12 @@ struct Complex_P_t
     ///
     /// @returns imaginary component of the polar complex
     double imaginary() const;
+
+    ///--------------------------------------------------------
+    /// @brief Find the absolute value of the polar complex
+    ///
+    /// @return absolute value of complex number
+    double absolute() const;
 };
 
 ///--------------------------------------------------------
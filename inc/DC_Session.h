@@ -0,0 +1,132 @@
+/// ------------------------------------------
+/// @file DC_Session.h
+///
+/// @brief Header for a DC solve session that keeps its factorization across component edits
+///
+/// @note A changed resistor between unknowns r1 and r2 changes G by dg*u*u' with
+/// u = e_r1 - e_r2, so k edited resistors are a rank k correction. These are applied
+/// with the Sherman-Morrison-Woodbury identity
+///     (A + U*D*U')^-1 b = x - Z*(D^-1 + U'*Z)^-1 * U'*x,  x = A^-1 b, Z = A^-1 U
+/// where A is the factored matrix, each column of Z costs one solve when its edit is
+/// made, and each re-solve costs one solve plus O(n*k + k^3)
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "Matrix.h"
+#include "Sparse_LU.h"
+#include "Netlist_Parser.h"
+#include "Nodal_Analysis.h"
+
+/// @brief One resistor whose conductance differs from the factored matrix
+struct Rank_Update_t
+{
+    /// @brief Index of the resistor in the netlist components
+    size_t component;
+
+    /// @brief Unknown of node 1, -1 if the node is fixed
+    int row1;
+
+    /// @brief Unknown of node 2, -1 if the node is fixed
+    int row2;
+
+    /// @brief Current conductance minus the factored conductance
+    double delta;
+
+    /// @brief Factored matrix solved against u = e_row1 - e_row2
+    std::vector<double> solved;
+};
+
+/// @brief DC analysis of one netlist whose component values are edited between solves
+class DC_Session
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, compiles and factors the netlist
+        ///
+        /// @param netlist parsed DC netlist
+        /// @param maxRank once more resistors than this differ from the factored matrix it is refactored
+        ///
+        /// @throws std::invalid_argument if the netlist is not a valid DC netlist
+        DC_Session(const Netlist_t& netlist, const size_t& maxRank = 16);
+
+        ///--------------------------------------------------------
+        /// @brief Changes the value of one component
+        ///
+        /// @note Resistors become low rank updates, current sources only change the
+        /// net currents, voltage sources recompile the net currents and offsets
+        ///
+        /// @param index index of the component in the netlist components
+        /// @param value new value, resistance for R, magnitude for I and V
+        ///
+        /// @throws std::invalid_argument if the index is out of range, a resistance is not positive or
+        /// a voltage source loop no longer sums to zero, the session is left unchanged
+        void setComponentValue(const size_t& index, const double& value);
+
+        ///--------------------------------------------------------
+        /// @brief Solves the network with every edit made so far
+        ///
+        /// @return Pairs of node names and their voltages
+        ///
+        /// @throws std::invalid_argument if the edits make the network singular
+        std::vector<std::pair<std::string, double>> solve() const;
+
+        ///--------------------------------------------------------
+        /// @brief Get the parsed netlist with the edited values
+        ///
+        /// @return netlist
+        const Netlist_t& getNetlist() const;
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of resistors that differ from the factored matrix
+        ///
+        /// @return rank of the pending correction
+        size_t getUpdateRank() const;
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of numeric factorizations made, including the first
+        ///
+        /// @return number of factorizations
+        size_t getFactorizationCount() const;
+
+    private:
+        /// @brief Netlist holding the current component values
+        Netlist_t m_netlist;
+
+        /// @brief Compiled analysis, the matrix holds the current conductances
+        Nodal_Analysis_DC_t m_analysis;
+
+        /// @brief Factorization of the matrix as it was when last factored
+        Sparse_LU<double> m_lu;
+
+        /// @brief Conductance of each component when last factored, 0 for non resistors
+        std::vector<double> m_factored;
+
+        /// @brief Resistors changed since the last factorization
+        std::vector<Rank_Update_t> m_updates;
+
+        /// @brief Rank that triggers a refactor
+        size_t m_max_rank;
+
+        /// @brief Number of numeric factorizations made
+        size_t m_factorizations = 0;
+
+        ///--------------------------------------------------------
+        /// @brief Refactors the current matrix and clears the pending updates
+        void _refactor();
+};
+
+///--------------------------------------------------------
+/// @brief Reads a list of component edits
+///
+/// @note Each line is in the form [netlist line] [value], naming the component by
+/// the line of the netlist file it was read from
+///
+/// @param filename local path of file to read
+/// @param netlist parsed netlist the edits apply to
+///
+/// @return pairs of component index and new value, in file order
+std::vector<std::pair<size_t, double>> readEditFile(const std::string& filename, const Netlist_t& netlist);
@@ -0,0 +1,148 @@
+/// ------------------------------------------
+/// @file Dense_Kernels.h
+///
+/// @brief Header for the dense multiply and transpose kernels behind Matrix
+///
+/// @note double and interleaved complex (Complex_C_t) have cache blocked, register
+/// tiled AVX2 and AVX-512 kernels chosen at runtime from the CPU, every other type
+/// (and CPUs without AVX2) uses the portable templates below. All storage is row major
+/// ------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <algorithm>
+
+#include "Complex_C.h"
+#include "Complex_F.h"
+
+/// @brief Instruction set used by the dense kernels
+enum class Simd_Level_t
+{
+    scalar,
+    avx2,
+    avx512
+};
+
+/// @brief Rows/cols of the square tiles the transpose moves at a time
+const size_t transpose_block = 32;
+
+///--------------------------------------------------------
+/// @brief Gets the name of an instruction set level
+///
+/// @param level instruction set level
+///
+/// @return level name
+std::string simdLevelName(const Simd_Level_t& level);
+
+///--------------------------------------------------------
+/// @brief Finds the best instruction set level the CPU supports
+///
+/// @return highest supported level
+Simd_Level_t detectSimdLevel();
+
+///--------------------------------------------------------
+/// @brief Gets the instruction set level the kernels currently use
+///
+/// @return active level, detectSimdLevel() unless lowered by setSimdLevel()
+Simd_Level_t getSimdLevel();
+
+///--------------------------------------------------------
+/// @brief Changes the instruction set level the kernels use, e.g. to compare paths
+///
+/// @param level requested level, capped at detectSimdLevel()
+void setSimdLevel(const Simd_Level_t& level);
+
+///--------------------------------------------------------
+/// @brief Portable dense product, out += a * b
+///
+/// @note i-k-j order so the inner loop is contiguous in both b and out
+///
+/// @tparam T value type with + and * implemented
+///
+/// @param rows rows of a and out
+/// @param inner cols of a, rows of b
+/// @param cols cols of b and out
+/// @param a (rows,inner) values
+/// @param b (inner,cols) values
+/// @param out (rows,cols) values, accumulated into
+template <typename T>
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols, const T* a, const T* b, T* out)
+{
+    for (size_t i = 0; i < rows; i++)
+    {
+        T* outRow = out + i * cols;
+        for (size_t k = 0; k < inner; k++)
+        {
+            const T aik = a[i * inner + k];
+            if (aik == 0)
+            {
+                continue;
+            }
+
+            const T* bRow = b + k * cols;
+            for (size_t j = 0; j < cols; j++)
+            {
+                outRow[j] = outRow[j] + aik * bRow[j];
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Dense product of doubles, out += a * b, dispatched on getSimdLevel()
+///
+/// @note A single column b (matrix-vector) uses a row dot product kernel
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out);
+
+///--------------------------------------------------------
+/// @brief Dense product of complex values, out += a * b, dispatched on getSimdLevel()
+///
+/// @note A single column b (matrix-vector) uses a row dot product kernel
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const Complex_C_t* a, const Complex_C_t* b, Complex_C_t* out);
+
+///--------------------------------------------------------
+/// @brief Dense product of single precision complex values, out += a * b, dispatched on getSimdLevel()
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const Complex_F_t* a, const Complex_F_t* b, Complex_F_t* out);
+
+///--------------------------------------------------------
+/// @brief Portable blocked transpose, dst = src'
+///
+/// @note Square tiles keep both the rows read and the rows written in cache
+///
+/// @tparam T value type
+///
+/// @param rows rows of src
+/// @param cols cols of src
+/// @param src (rows,cols) values
+/// @param dst (cols,rows) values
+template <typename T>
+void denseTranspose(const size_t& rows, const size_t& cols, const T* src, T* dst)
+{
+    for (size_t ii = 0; ii < rows; ii += transpose_block)
+    {
+        size_t iEnd = std::min(ii + transpose_block, rows);
+        for (size_t jj = 0; jj < cols; jj += transpose_block)
+        {
+            size_t jEnd = std::min(jj + transpose_block, cols);
+            for (size_t i = ii; i < iEnd; i++)
+            {
+                for (size_t j = jj; j < jEnd; j++)
+                {
+                    dst[j * rows + i] = src[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Blocked transpose of doubles, dst = src', dispatched on getSimdLevel()
+void denseTranspose(const size_t& rows, const size_t& cols, const double* src, double* dst);
+
+///--------------------------------------------------------
+/// @brief Blocked transpose of complex values, dst = src', dispatched on getSimdLevel()
+void denseTranspose(const size_t& rows, const size_t& cols, const Complex_C_t* src, Complex_C_t* dst);
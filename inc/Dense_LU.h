@@ -0,0 +1,433 @@
+/// ------------------------------------------
+/// @file Dense_LU.h
+///
+/// @brief Header/Source file for a multithreaded blocked dense LU factorization object
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <memory>
+#include <future>
+#include <functional>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Dense_Kernels.h"
+#include "Thread_Pool.h"
+
+/// @brief Dense LU factorization with partial pivoting, P*A = L*U
+///
+/// @note Right looking and blocked: each step factors a panel of block columns, applies
+/// its row swaps and triangular solve to every other column block, then updates the
+/// trailing matrix tile by tile with the dense multiply kernels. Column blocks and tiles
+/// are tasks on a thread pool, and the next panel is factored while the rest of the
+/// trailing update is still running (one step of lookahead).
+/// The factor is packed the same way as Matrix::luFactor()
+///
+/// @tparam T double, Complex_C_t or any type Matrix can LU factor
+template <typename T>
+class Dense_LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for an empty factorization, factor() must be called before solving
+        ///
+        /// @param threadCount number of worker threads, 0 uses the hardware thread count,
+        /// 1 factors on the calling thread
+        /// @param blockSize columns per panel and per trailing update tile
+        ///
+        /// @throws std::invalid_argument if blockSize is 0
+        Dense_LU(const size_t& threadCount = 0, const size_t& blockSize = 64) :
+            m_lu(1, 1)
+        {
+            if (blockSize < 1)
+            {
+                throw std::invalid_argument("Dense LU block size must be above 0");
+            }
+
+            m_block = blockSize;
+            if (threadCount != 1)
+            {
+                m_pool = std::make_unique<Thread_Pool>(threadCount);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, factors the given matrix
+        ///
+        /// @param mat square matrix to factor
+        /// @param threadCount number of worker threads, 0 uses the hardware thread count,
+        /// 1 factors on the calling thread
+        /// @param blockSize columns per panel and per trailing update tile
+        ///
+        /// @throws std::invalid_argument if the matrix is not square or is singular
+        Dense_LU(const Matrix<T>& mat, const size_t& threadCount = 0, const size_t& blockSize = 64) :
+            Dense_LU(threadCount, blockSize)
+        {
+            factor(mat);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Numerically factors the matrix
+        ///
+        /// @param mat square matrix to factor
+        ///
+        /// @throws std::invalid_argument if the matrix is not square or is singular
+        void factor(const Matrix<T>& mat)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be LU factored");
+            }
+
+            m_lu = mat;
+            m_n = mat.getRowCount();
+            m_pivots.assign(m_n, 0);
+            m_factored = false;
+
+            const size_t n = m_n;
+            const size_t nb = m_block;
+            const size_t tileRows = nb * tile_row_blocks;
+            T* a = m_lu.get_data();
+
+            // -L21 and U12 of the current step, packed contiguous for the multiply kernels
+            std::vector<T> lower;
+            std::vector<T> upper;
+
+            _factor_panel(0, std::min(nb, n));
+            for (size_t k0 = 0; k0 < n; k0 += nb)
+            {
+                const size_t k1 = std::min(k0 + nb, n);
+                const size_t width = k1 - k0;
+                const size_t rest = n - k1;
+                upper.resize(width * rest);
+
+                // Every other column block takes the panel's row swaps, blocks right of
+                // the panel are then solved for their rows of U and packed
+                std::vector<std::function<void()>> blockTasks;
+                for (size_t c0 = 0; c0 < n; c0 += nb)
+                {
+                    if (c0 == k0)
+                    {
+                        continue;
+                    }
+
+                    const size_t c1 = std::min(c0 + nb, n);
+                    blockTasks.push_back([this, a, k0, k1, c0, c1, &upper]()
+                    {
+                        _swap_rows(k0, k1, c0, c1);
+                        if (c0 > k0)
+                        {
+                            _solve_upper(k0, k1, c0, c1, upper.data() + (k1 - k0) * (c0 - k1));
+                        }
+                    });
+                }
+                std::vector<std::future<void>> blockResults = _submit(blockTasks);
+                _wait(blockResults);
+
+                if (rest == 0)
+                {
+                    break;
+                }
+
+                lower.resize(rest * width);
+                for (size_t i = 0; i < rest; i++)
+                {
+                    for (size_t p = 0; p < width; p++)
+                    {
+                        lower[i * width + p] = (T) 0 - a[(k1 + i) * n + k0 + p];
+                    }
+                }
+
+                // Tiles of the next panel's columns are queued first so it can be factored early
+                std::vector<std::function<void()>> panelTiles;
+                std::vector<std::function<void()>> otherTiles;
+                for (size_t c0 = k1; c0 < n; c0 += nb)
+                {
+                    const size_t c1 = std::min(c0 + nb, n);
+                    for (size_t r0 = k1; r0 < n; r0 += tileRows)
+                    {
+                        const size_t r1 = std::min(r0 + tileRows, n);
+                        auto tile = [this, a, k0, k1, r0, r1, c0, c1, &lower, &upper]()
+                        {
+                            _update_tile(r0, r1, c0, c1, k1 - k0, lower.data() + (k1 - k0) * (r0 - k1),
+                                upper.data() + (k1 - k0) * (c0 - k1));
+                        };
+                        (c0 == k1 ? panelTiles : otherTiles).push_back(tile);
+                    }
+                }
+
+                std::vector<std::future<void>> panelResults = _submit(panelTiles);
+                std::vector<std::future<void>> otherResults = _submit(otherTiles);
+                try
+                {
+                    _wait(panelResults);
+                    _factor_panel(k1, std::min(k1 + nb, n));
+                }
+                catch (...)
+                {
+                    // Tasks still refer to the packed buffers
+                    _wait_all(otherResults);
+                    throw;
+                }
+                _wait(otherResults);
+            }
+
+            m_factored = true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A*X = B using the factorization
+        ///
+        /// @param rhs (n,k) matrix B, each column is solved for independently
+        ///
+        /// @return (n,k) matrix X
+        ///
+        /// @throws std::invalid_argument if not factored or the rhs has the wrong row count
+        Matrix<T> solve(Matrix<T> rhs) const
+        {
+            if (!m_factored)
+            {
+                throw std::invalid_argument("Dense LU must be factored before solving");
+            }
+
+            return m_lu.luSolve(m_pivots, std::move(rhs));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the packed L and U factors, in the layout of Matrix::luFactor()
+        ///
+        /// @return packed LU factor
+        const Matrix<T>& getFactor() const
+        {
+            return m_lu;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the row swaps, the row swapped with row i at step i
+        ///
+        /// @return row swaps in the order they were made
+        const std::vector<size_t>& getPivots() const
+        {
+            return m_pivots;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of threads the factorization runs on
+        ///
+        /// @return number of worker threads, 1 when factoring on the calling thread
+        size_t getThreadCount() const
+        {
+            return m_pool ? m_pool->getThreadCount() : 1;
+        };
+
+    private:
+        /// @brief Trailing update tiles are this many panels tall
+        static const size_t tile_row_blocks = 4;
+
+        /// @brief Packed L and U factors
+        Matrix<T> m_lu;
+
+        /// @brief Row swapped with row i at step i
+        std::vector<size_t> m_pivots;
+
+        /// @brief Dimension of the factored matrix
+        size_t m_n = 0;
+
+        /// @brief Columns per panel and per tile
+        size_t m_block;
+
+        /// @brief Has factor() completed
+        bool m_factored = false;
+
+        /// @brief Workers for the column block and tile tasks, null when factoring on the calling thread
+        std::unique_ptr<Thread_Pool> m_pool;
+
+        ///--------------------------------------------------------
+        /// @brief Factors columns [k0, k1) of the rows below k0, swapping rows
+        /// only within the panel
+        ///
+        /// @throws std::invalid_argument if a column has no non-zero pivot
+        void _factor_panel(const size_t& k0, const size_t& k1)
+        {
+            const size_t n = m_n;
+            T* a = m_lu.get_data();
+
+            for (size_t c = k0; c < k1; c++)
+            {
+                // Pick the largest magnitude value in the column as the pivot
+                size_t pivotRow = c;
+                double pivotMag = absoluteValue(a[c * n + c]);
+                for (size_t i = c + 1; i < n; i++)
+                {
+                    double mag = absoluteValue(a[i * n + c]);
+                    if (mag > pivotMag)
+                    {
+                        pivotMag = mag;
+                        pivotRow = i;
+                    }
+                }
+
+                if (pivotMag == 0)
+                {
+                    throw std::invalid_argument("Matrix is singular, no LU factor exists");
+                }
+
+                m_pivots[c] = pivotRow;
+                if (pivotRow != c)
+                {
+                    std::swap_ranges(a + c * n + k0, a + c * n + k1, a + pivotRow * n + k0);
+                }
+
+                T pivot = a[c * n + c];
+                for (size_t i = c + 1; i < n; i++)
+                {
+                    if (a[i * n + c] == 0)
+                    {
+                        continue;
+                    }
+
+                    T l = a[i * n + c] / pivot;
+                    a[i * n + c] = l;
+                    for (size_t j = c + 1; j < k1; j++)
+                    {
+                        a[i * n + j] = a[i * n + j] - l * a[c * n + j];
+                    }
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Applies the row swaps of panel [k0, k1) to columns [c0, c1)
+        void _swap_rows(const size_t& k0, const size_t& k1, const size_t& c0, const size_t& c1)
+        {
+            const size_t n = m_n;
+            T* a = m_lu.get_data();
+
+            for (size_t c = k0; c < k1; c++)
+            {
+                if (m_pivots[c] != c)
+                {
+                    std::swap_ranges(a + c * n + c0, a + c * n + c1, a + m_pivots[c] * n + c0);
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves L11 * U12 = A12 in place for panel rows [k0, k1) and
+        /// columns [c0, c1), then packs the block of U12
+        ///
+        /// @param packed (k1 - k0, c1 - c0) destination of the solved block
+        void _solve_upper(const size_t& k0, const size_t& k1, const size_t& c0, const size_t& c1, T* packed)
+        {
+            const size_t n = m_n;
+            const size_t cols = c1 - c0;
+            T* a = m_lu.get_data();
+
+            for (size_t r = k0 + 1; r < k1; r++)
+            {
+                T* row = a + r * n + c0;
+                for (size_t p = k0; p < r; p++)
+                {
+                    T l = a[r * n + p];
+                    if (l == 0)
+                    {
+                        continue;
+                    }
+
+                    const T* above = a + p * n + c0;
+                    for (size_t j = 0; j < cols; j++)
+                    {
+                        row[j] = row[j] - l * above[j];
+                    }
+                }
+            }
+
+            for (size_t r = k0; r < k1; r++)
+            {
+                std::copy_n(a + r * n + c0, cols, packed + (r - k0) * cols);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Updates tile [r0, r1) x [c0, c1) of the trailing matrix, A22 -= L21 * U12
+        ///
+        /// @param inner width of the panel
+        /// @param lower (r1 - r0, inner) negated rows of L21
+        /// @param upper (inner, c1 - c0) block of U12
+        void _update_tile(const size_t& r0, const size_t& r1, const size_t& c0, const size_t& c1,
+            const size_t& inner, const T* lower, const T* upper)
+        {
+            const size_t n = m_n;
+            const size_t rows = r1 - r0;
+            const size_t cols = c1 - c0;
+            T* a = m_lu.get_data();
+
+            // The kernels need a contiguous output, the copy is small next to the product
+            std::vector<T> tile(rows * cols);
+            for (size_t i = 0; i < rows; i++)
+            {
+                std::copy_n(a + (r0 + i) * n + c0, cols, tile.data() + i * cols);
+            }
+
+            denseMultiply(rows, inner, cols, lower, upper, tile.data());
+
+            for (size_t i = 0; i < rows; i++)
+            {
+                std::copy_n(tile.data() + i * cols, cols, a + (r0 + i) * n + c0);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Starts tasks on the pool, or runs them in order when there is no pool
+        ///
+        /// @param tasks tasks to start
+        ///
+        /// @return futures holding the result of each task
+        std::vector<std::future<void>> _submit(std::vector<std::function<void()>>& tasks)
+        {
+            std::vector<std::future<void>> results;
+            results.reserve(tasks.size());
+            for (std::function<void()>& task : tasks)
+            {
+                if (m_pool)
+                {
+                    results.push_back(m_pool->submit(std::move(task)));
+                }
+                else
+                {
+                    std::packaged_task<void()> packaged(std::move(task));
+                    results.push_back(packaged.get_future());
+                    packaged();
+                }
+            }
+
+            return results;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Waits for every task to finish, ignoring any exceptions
+        void _wait_all(std::vector<std::future<void>>& results)
+        {
+            for (std::future<void>& result : results)
+            {
+                result.wait();
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Waits for every task to finish
+        ///
+        /// @throws the first exception thrown by any task
+        void _wait(std::vector<std::future<void>>& results)
+        {
+            _wait_all(results);
+            for (std::future<void>& result : results)
+            {
+                result.get();
+            }
+        };
+};
@@ -0,0 +1,99 @@
+/// ------------------------------------------
+/// @file Domain_Decomposition.h
+///
+/// @brief Header for solving a sparse system by subdomains and the Schur complement of their interface
+///
+/// @note Unknowns are split into subdomains that share no entries, and interface unknowns
+/// that couple them. With the subdomains ordered first the system is
+///     [ A_DD  A_DG ] [x_D]   [b_D]
+///     [ A_GD  A_GG ] [x_G] = [b_G]
+/// where A_DD is block diagonal, so every subdomain factors on its own. The interface is
+/// solved from S * x_G = b_G - A_GD * A_DD^-1 * b_D with S = A_GG - A_GD * A_DD^-1 * A_DG,
+/// then each subdomain back-substitutes x_D = A_DD^-1 * (b_D - A_DG * x_G)
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Matrix.h"
+#include "Sparse_Matrix.h"
+
+/// @brief Split of the unknowns of a system into subdomains and the interface between them
+struct Domain_Partition_t
+{
+    /// @brief Subdomain of every unknown, -1 for interface unknowns
+    std::vector<int> domain;
+
+    /// @brief Number of subdomains, every one holds at least one unknown
+    size_t domain_count = 0;
+};
+
+///--------------------------------------------------------
+/// @brief Partitions the pattern A + A^T into subdomains from its nested dissection tree
+///
+/// @note The largest subtree is split at its separator until there are enough subdomains,
+/// the separators split on the way form the interface
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+/// @param domainCount subdomains wanted, fewer are made when the tree runs out of separators
+///
+/// @return subdomain of every unknown
+Domain_Partition_t partitionDomains(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, const size_t& domainCount);
+
+///--------------------------------------------------------
+/// @brief Turns a given assignment of unknowns to subdomains into a partition, every
+/// entry joining two subdomains moves one of its unknowns onto the interface
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+/// @param domain subdomain of every unknown, -1 to place it on the interface
+///
+/// @return partition with empty subdomains dropped and the rest renumbered in order
+///
+/// @throws std::invalid_argument if domain does not have one entry per unknown or has an id below -1
+Domain_Partition_t separateDomains(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<int> domain);
+
+///--------------------------------------------------------
+/// @brief Moves every subdomain unknown with a zero diagonal onto the interface
+///
+/// @note Such an unknown (e.g. a node where an inductor and a capacitor resonate) can
+/// only be pivoted on through its off diagonal entries, when those lead onto the
+/// interface its subdomain block is singular even though A is not
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (n, n) compressed system matrix
+/// @param partition partition of the unknowns of mat, subdomains left empty are dropped
+/// and the rest renumbered in order
+///
+/// @throws std::invalid_argument if the partition does not have one entry per unknown
+template <typename T>
+void interfaceZeroDiagonals(const Sparse_Matrix<T>& mat, Domain_Partition_t& partition);
+
+///--------------------------------------------------------
+/// @brief Solves A*x = b by factoring every subdomain in parallel, solving the dense
+/// interface Schur complement, then back-substituting into every subdomain
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (n, n) compressed system matrix
+/// @param rhs (n, 1) right hand side
+/// @param partition subdomains of the unknowns, see partitionDomains() and separateDomains()
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @note A subdomain block that is singular anyway is not an error, the whole system
+/// is then solved with the sparse LU
+///
+/// @return (n, 1) solution
+///
+/// @throws std::invalid_argument if the partition does not match the matrix, or the matrix is singular
+template <typename T>
+Matrix<T> schurComplementSolve(const Sparse_Matrix<T>& mat, const Matrix<T>& rhs,
+    const Domain_Partition_t& partition, const size_t& threadCount = 0);
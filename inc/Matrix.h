@@ -11,18 +11,77 @@
 #include <iostream>
 #include <sstream>
 #include <string>
-#include <cstring>
 #include <cmath>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
 
-/// @brief Templated class for storing, acsessing and performing operations on a matrix of values
+#include "Matrix_Policies.h"
+#include "Matrix_Expression.h"
+#include "Dense_Kernels.h"
+
+///--------------------------------------------------------
+/// @brief Finds the magnitude of a matrix value, used for pivot selection
+///
+/// @tparam T real type or complex type implementing absolute()
+///
+/// @param val value to find the magnitude of
+///
+/// @returns absolute value for real types, modulus for complex types
 template <typename T>
-class Matrix
+double absoluteValue(const T& val)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        return std::fabs(val);
+    }
+    else
+    {
+        return val.absolute();
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Finds the complex conjugate of a matrix value, used for adjoint solves
+///
+/// @tparam T real type or complex type implementing conjugate()
+///
+/// @param val value to conjugate
+///
+/// @returns the value itself for real types, its conjugate for complex types
+template <typename T>
+T conjugateValue(const T& val)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+    {
+        return val;
+    }
+    else
+    {
+        return val.conjugate();
+    }
+}
+
+/// @brief Templated class for storing, acsessing and performing operations on a matrix of values
+///
+/// @note Element wise +, -, * and scalar *, / are lazy expressions (see Matrix_Expression.h)
+/// evaluated in one loop when assigned to a matrix
+///
+/// @tparam Bounds bounds checking policy of get()/set()/row()/col(), checked unless NDEBUG
+/// @tparam Storage where the values live, see Matrix_Policies.h, on the heap by default
+template <typename T, typename Bounds, typename Storage>
+class Matrix : public Matrix_Expression<Matrix<T, Bounds, Storage>>
 {
     public:
+        /// @brief Type of the stored values
+        using value_type = T;
+
         ///--------------------------------------------------------
         /// @brief Constructor for a matrix object
         ///
-        /// @note Memory will only be allocated with no construction taking place
+        /// @note All values are value initialised (zero for numeric types)
         ///
         /// @tparam T type to store in the matrix, type must be copy
         /// constructable and have all maths operations (+-*/) implemented
@@ -42,7 +101,16 @@ class Matrix
             m_cols = cols;
             m_rows = rows;
 
-            m_data = new T[m_cols * m_rows];
+            m_storage.allocate(m_cols * m_rows);
+            try
+            {
+                std::uninitialized_value_construct_n(get_data(), m_cols * m_rows);
+            }
+            catch (...)
+            {
+                m_storage.deallocate(m_cols * m_rows);
+                throw;
+            }
         };
 
         /// @brief Constructor using
@@ -72,16 +140,22 @@ class Matrix
             m_cols = colLen;
             m_rows = matData.size();
 
-            m_data = new T[m_cols * m_rows];
-            size_t row = 0;
-            for (auto rowData : matData)
+            // Rows are copy constructed straight into place, any already built are destroyed on a throw
+            m_storage.allocate(m_cols * m_rows);
+            size_t built = 0;
+            try
             {
-                size_t col = 0;
-                for (T val : rowData)
+                for (auto rowData : matData)
                 {
-                    set(row, col++, val);
+                    std::uninitialized_copy(rowData.begin(), rowData.end(), get_data() + built);
+                    built += m_cols;
                 }
-                row++;
+            }
+            catch (...)
+            {
+                std::destroy_n(get_data(), built);
+                m_storage.deallocate(m_cols * m_rows);
+                throw;
             }
         };
 
@@ -91,157 +165,224 @@ class Matrix
         /// @tparam T type stored by matrix
         ///
         /// @param mat reference to copied matrix
-        Matrix<T>(Matrix<T> const& mat)
+        Matrix(Matrix const& mat)
         {
             m_cols = mat.getColCount();
             m_rows = mat.getRowCount();
 
-            m_data = new T[m_cols * m_rows];
-            memcpy(m_data, mat.get_data(), m_rows * m_cols * sizeof(T));
+            m_storage.allocate(m_cols * m_rows);
+            try
+            {
+                std::uninitialized_copy_n(mat.get_data(), m_rows * m_cols, get_data());
+            }
+            catch (...)
+            {
+                m_storage.deallocate(m_cols * m_rows);
+                throw;
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Move constructor, takes the storage of the moved matrix
+        ///
+        /// @note The moved from matrix is left empty (0,0), it may only be assigned to or destroyed
+        ///
+        /// @param mat matrix to take the storage of
+        Matrix(Matrix&& mat) noexcept(noexcept(std::declval<Storage&>().take(std::declval<Storage&>(), 0)))
+        {
+            m_storage.take(mat.m_storage, mat.m_rows * mat.m_cols);
+            m_cols = std::exchange(mat.m_cols, 0);
+            m_rows = std::exchange(mat.m_rows, 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor evaluating an expression, each value is constructed
+        /// in place in one pass with no intermediate matricies
+        ///
+        /// @param expr element wise expression of matricies
+        template <typename E>
+        Matrix(const Matrix_Expression<E>& expr)
+        {
+            const E& values = expr.self();
+            m_cols = values.getColCount();
+            m_rows = values.getRowCount();
+
+            m_storage.allocate(m_cols * m_rows);
+            T* data = get_data();
+            size_t built = 0;
+            try
+            {
+                for (; built < m_cols * m_rows; built++)
+                {
+                    ::new (static_cast<void*>(data + built)) T(values[built]);
+                }
+            }
+            catch (...)
+            {
+                std::destroy_n(data, built);
+                m_storage.deallocate(m_cols * m_rows);
+                throw;
+            }
         };
 
         ///--------------------------------------------------------
         /// @brief Destructor
         ~Matrix()
         {
-            delete[] m_data;
+            _release();
         };
 
         /// @brief Assignment operator
         /// @param mat matrix object being assigned from
         /// @return reference to assigned matrix
-        Matrix<T>& operator=(Matrix<T> const& mat)
+        Matrix& operator=(Matrix const& mat)
         {
-            m_cols = mat.getColCount();
-            m_rows = mat.getRowCount();
+            if (this == &mat)
+            {
+                return *this;
+            }
 
-            // assigned so data will already be present, delete old array to resize
-            delete[] m_data;
-            m_data = new T[m_cols * m_rows];
-            memcpy(m_data, mat.get_data(), m_rows * m_cols * sizeof(T));
+            // Same size keeps the existing storage, otherwise copy first so a throw leaves this unchanged
+            if (mat.getColCount() * mat.getRowCount() == m_cols * m_rows)
+            {
+                std::copy_n(mat.get_data(), m_rows * m_cols, get_data());
+                m_cols = mat.getColCount();
+                m_rows = mat.getRowCount();
+                return *this;
+            }
+
+            Matrix copy(mat);
+            *this = std::move(copy);
             return *this;
         }
 
-        ///--------------------------------------------------------
-        /// @brief Operator overload of +, implements matrix addition
+        /// @brief Move assignment operator, takes the storage of the moved matrix
+        /// @param mat matrix object being moved from, left empty (0,0)
+        /// @return reference to assigned matrix
+        Matrix& operator=(Matrix&& mat) noexcept(noexcept(std::declval<Storage&>().take(std::declval<Storage&>(), 0)))
+        {
+            if (this != &mat)
+            {
+                _release();
+                m_storage.take(mat.m_storage, mat.m_rows * mat.m_cols);
+                m_cols = std::exchange(mat.m_cols, 0);
+                m_rows = std::exchange(mat.m_rows, 0);
+            }
+            return *this;
+        }
+
+        /// @brief Assignment from an expression, evaluated straight into the existing
+        /// storage when the dimensions match
         ///
-        /// @param mat reference to rval matrix
+        /// @note Element wise expressions only read index i to write index i, so the
+        /// matrix being assigned may also appear in the expression
         ///
-        /// @return result of summed matricies
-        Matrix<T> operator+(Matrix<T> const& mat)
+        /// @param expr element wise expression of matricies
+        /// @return reference to assigned matrix
+        template <typename E>
+        Matrix& operator=(const Matrix_Expression<E>& expr)
         {
-            if (mat.getColCount() != m_cols or mat.getRowCount() != m_rows)
+            const E& values = expr.self();
+            if (values.getColCount() * values.getRowCount() != m_cols * m_rows)
             {
-                throw std::invalid_argument("Matrix addition requires matricies of same dimensions");
+                return *this = Matrix(expr);
             }
 
-            Matrix<T> outMat(m_rows, m_cols);
-
-            // Can sum the memory regions as both have same dimensions
+            m_cols = values.getColCount();
+            m_rows = values.getRowCount();
             for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                outMat.get_data()[i] = m_data[i] + mat.get_data()[i];
+                get_data()[i] = values[i];
             }
 
-            return outMat;
+            return *this;
         }
 
         ///--------------------------------------------------------
-        /// @brief Operator overload of -, implements matrix subtraction
+        /// @brief Operator overload of +=, adds a matrix or expression in place
         ///
-        /// @param mat reference to rval matrix
+        /// @param expr reference to rval expression
         ///
-        /// @return result of subtracted matricies
-        Matrix<T> operator-(Matrix<T> const& mat)
+        /// @return reference to this matrix
+        template <typename E>
+        Matrix& operator+=(const Matrix_Expression<E>& expr)
         {
-            if (mat.getColCount() != m_cols or mat.getRowCount() != m_rows)
-            {
-                throw std::invalid_argument("Matrix subtraction requires matricies of same dimensions");
-            }
-
-            Matrix<T> outMat(m_rows, m_cols);
-
-            // Can sub the memory regions as both have same dimensions
+            const E& values = _check_same_size(expr, "Matrix addition requires matricies of same dimensions");
             for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                outMat.get_data()[i] = m_data[i] - mat.get_data()[i];
+                get_data()[i] = get_data()[i] + values[i];
             }
 
-            return outMat;
+            return *this;
         }
 
         ///--------------------------------------------------------
-        /// @brief Operator overload of *, implements matrix dot product
+        /// @brief Operator overload of -=, subtracts a matrix or expression in place
         ///
-        /// @param mat reference to rval matrix
+        /// @param expr reference to rval expression
         ///
-        /// @return result of dot product matricies
-        Matrix<T> operator*(Matrix<T> const& mat)
+        /// @return reference to this matrix
+        template <typename E>
+        Matrix& operator-=(const Matrix_Expression<E>& expr)
         {
-            if (mat.getColCount() != m_cols or mat.getRowCount() != m_rows)
-            {
-                throw std::invalid_argument("Dot product requires matricies of same dimensions");
-            }
-
-            Matrix<T> outMat(m_rows, m_cols);
-
-            // Can product the memory regions as both have same dimensions
+            const E& values = _check_same_size(expr, "Matrix subtraction requires matricies of same dimensions");
             for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                outMat.get_data()[i] = m_data[i] * mat.get_data()[i];
+                get_data()[i] = get_data()[i] - values[i];
             }
 
-            return outMat;
+            return *this;
         }
 
-        /// @brief Operator overload of /, implements number division of matrix
+        ///--------------------------------------------------------
+        /// @brief Operator overload of *=, element wise product with a matrix or expression in place
         ///
-        /// @param num to divide matrix by
+        /// @param expr reference to rval expression
         ///
-        /// @return multiplied matrix
-        Matrix<T> operator/(T const& num)
+        /// @return reference to this matrix
+        template <typename E>
+        Matrix& operator*=(const Matrix_Expression<E>& expr)
         {
-            Matrix<T> outMat(m_rows, m_cols);
-
-            for (size_t i = 0; i < m_rows * m_cols; i++)
+            const E& values = _check_same_size(expr, "Dot product requires matricies of same dimensions");
+            for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                outMat.get_data()[i] = m_data[i] / num;
+                get_data()[i] = get_data()[i] * values[i];
             }
 
-            return outMat;
-        };
+            return *this;
+        }
 
         ///--------------------------------------------------------
-        /// @brief Operator overload of %, implements matrix cross product
+        /// @brief Operator overload of *=, multiplies by a number in place
         ///
-        /// @param mat reference to rval matrix
+        /// @param num to multiply matrix by
         ///
-        /// @return result of dot product matricies
-        Matrix<T> operator%(Matrix<T> const& mat)
+        /// @return reference to this matrix
+        Matrix& operator*=(double const& num)
         {
-            if (m_cols != mat.getRowCount())
+            for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+                get_data()[i] = get_data()[i] * num;
             }
 
-            Matrix<T> outMat(m_rows, mat.getColCount());
+            return *this;
+        }
 
-            for (size_t i = 0; i < outMat.getRowCount(); i++)
+        ///--------------------------------------------------------
+        /// @brief Operator overload of /=, divides by a number in place
+        ///
+        /// @param num to divide matrix by
+        ///
+        /// @return reference to this matrix
+        Matrix& operator/=(T const& num)
+        {
+            for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                for (size_t j = 0; j < outMat.getColCount(); j++)
-                {
-                    T sum = 0;
-                    for (size_t idx = 0; idx < m_cols; idx++)
-                    {
-                        T product = get(i, idx) * mat.get(idx, j);
-                        sum += product;
-                    }
-                    outMat.set(i,j, sum);
-                }
+                get_data()[i] = get_data()[i] / num;
             }
 
-            return outMat;
-        };
+            return *this;
+        }
 
         ///--------------------------------------------------------
         /// @brief Operator overload of ==, compares two matricies
@@ -249,7 +390,7 @@ class Matrix
         /// @param mat rval mat to compare
         ///
         /// @return are matricies equal in dimension and content?
-        bool operator==(Matrix<T> const& mat)
+        bool operator==(Matrix const& mat) const
         {
             if (mat.getColCount() != m_cols or mat.getRowCount() != m_rows)
             {
@@ -258,10 +399,10 @@ class Matrix
 
             for (size_t i = 0; i < m_cols * m_rows; i++)
             {
-                if (m_data[i] != mat.get_data()[i])
+                if (get_data()[i] != mat.get_data()[i])
                 {
                     std::cout << "failed: (" << i / m_cols << "," << i % m_rows << "), " <<
-                    m_data[i] << " != " << mat.get_data()[i] << std::endl;
+                    get_data()[i] << " != " << mat.get_data()[i] << std::endl;
                     return false;
                 }
             }
@@ -275,29 +416,20 @@ class Matrix
         /// @param mat rval mat to compare
         ///
         /// @return are matricies not equal in dimension or content?
-        bool operator!=(Matrix<T> const& mat)
+        bool operator!=(Matrix const& mat) const
         {
             return !(*this == mat);
         };
 
         ///--------------------------------------------------------
-        /// @brief Operator overload of *, implements number multiplication of matrix
-        ///
-        /// @note all numbers cast to double to ensure floating point compatability
+        /// @brief Gets a value by its flat row major index, without bounds checks
         ///
-        /// @param num to multiply matrix by
+        /// @param i index into the internal array
         ///
-        /// @return multiplied matrix
-        Matrix<T> operator*(double const& num)
+        /// @returns value at the index
+        const T& operator[](const size_t& i) const
         {
-            Matrix<T> outMat(m_rows, m_cols);
-
-            for (size_t i = 0; i < m_rows * m_cols; i++)
-            {
-                outMat.get_data()[i] = m_data[i] * num;
-            }
-
-            return outMat;
+            return get_data()[i];
         };
 
         ///--------------------------------------------------------
@@ -309,7 +441,7 @@ class Matrix
         /// @returns value at given location
         T get(const size_t& row, const size_t& col) const
         {
-            return m_data[_trans_coord(row, col)];
+            return get_data()[_trans_coord(row, col)];
         };
 
         /// @brief Sets the value at the row col position
@@ -319,7 +451,43 @@ class Matrix
         /// @param val to set coordinate to
         void set(const size_t& row, const size_t& col, const T& val)
         {
-            m_data[_trans_coord(row, col)] = val;
+            get_data()[_trans_coord(row, col)] = val;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets a view of one row, contiguous so loops over it vectorise
+        ///
+        /// @param row to view
+        ///
+        /// @returns span of the row's m_cols values
+        ///
+        /// @throws std::invalid_argument if checked and the row is out of bounds
+        Matrix_Span_t<T> row(const size_t& row)
+        {
+            return Matrix_Span_t<T>{get_data() + _trans_coord(row, 0), m_cols, 1};
+        };
+
+        Matrix_Span_t<const T> row(const size_t& row) const
+        {
+            return Matrix_Span_t<const T>{get_data() + _trans_coord(row, 0), m_cols, 1};
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets a view of one column, strided by the row length
+        ///
+        /// @param col to view
+        ///
+        /// @returns span of the column's m_rows values
+        ///
+        /// @throws std::invalid_argument if checked and the column is out of bounds
+        Matrix_Span_t<T> col(const size_t& col)
+        {
+            return Matrix_Span_t<T>{get_data() + _trans_coord(0, col), m_rows, m_cols};
+        };
+
+        Matrix_Span_t<const T> col(const size_t& col) const
+        {
+            return Matrix_Span_t<const T>{get_data() + _trans_coord(0, col), m_rows, m_cols};
         };
 
         ///--------------------------------------------------------
@@ -330,7 +498,7 @@ class Matrix
         /// @returns reference of internal array
         T* get_data() const
         {
-            return m_data;
+            return m_storage.data();
         };
 
         ///--------------------------------------------------------
@@ -355,18 +523,11 @@ class Matrix
         /// @brief Create the transpose of the matrix
         ///
         /// @return the transposed form of the matrix
-        Matrix<T> transpose() const
+        Matrix transpose() const
         {
-            // Create matrix with transposed dimensions
-            Matrix<T> transposeMat(m_cols, m_rows);
-
-            for (size_t i = 0; i < m_rows; i++)
-            {
-                for (size_t j = 0; j < m_cols; j++)
-                {
-                    transposeMat.set(j, i, get(i,j));
-                }
-            }
+            // Create matrix with transposed dimensions, filled tile by tile
+            Matrix transposeMat(m_cols, m_rows);
+            denseTranspose(m_rows, m_cols, get_data(), transposeMat.get_data());
 
             return transposeMat;
         };
@@ -378,9 +539,9 @@ class Matrix
         /// @param col to exclude when creating new matrix
         ///
         /// @returns matrix of (m-1,n-1) size with given row/col excluded
-        Matrix<T> createSubMatrix(const size_t& row, const size_t& col) const
+        Matrix createSubMatrix(const size_t& row, const size_t& col) const
         {
-            Matrix<T> outMat(m_rows-1, m_cols-1);
+            Matrix outMat(m_rows-1, m_cols-1);
 
             size_t rowSkip = 0;
             for (size_t i = 0; i < m_rows; i++)
@@ -434,6 +595,8 @@ class Matrix
         ///--------------------------------------------------------
         /// @brief Calculates the determinant for the matrix
         ///
+        /// @note Found from the product of the LU factor pivots, O(n^3)
+        ///
         /// @returns value of the determinant for the matrix
         T determinant() const
         {
@@ -442,24 +605,25 @@ class Matrix
                 throw std::invalid_argument("Matrix must be square to have a determinant");
             }
 
-            if (m_cols == 2)
+            Matrix lu(*this);
+            std::vector<size_t> pivots;
+            if (!lu._lu_decompose(pivots))
             {
-                return get(0,0) * get(1,1) - get(1,0) * get(0,1);
+                return (T) 0;
             }
-            else if (m_cols == 1)
+
+            T det = lu.get(0,0);
+            for (size_t i = 1; i < m_rows; i++)
             {
-                return get(0,0);
+                det = det * lu.get(i,i);
             }
 
-            size_t workingRow = _find_zeros_row();
-
-            T det = 0;
-            for (size_t j = 0; j < m_cols; j++)
+            // Each row swap flips the sign of the determinant
+            for (size_t i = 0; i < m_rows; i++)
             {
-                if (get(workingRow, j) != 0)
+                if (pivots.at(i) != i)
                 {
-                    T res = get(workingRow, j) * cofactor(workingRow, j);
-                    det += res;
+                    det = (T) 0 - det;
                 }
             }
 
@@ -470,9 +634,9 @@ class Matrix
         /// @brief Calculates the adjoint matrix
         ///
         /// @returns the adjoint matrix of the matrix
-        Matrix<T> adjoint() const
+        Matrix adjoint() const
         {
-            Matrix<T> outMat(m_rows, m_cols);
+            Matrix outMat(m_rows, m_cols);
 
             for (size_t i = 0; i < m_rows; i++)
             {
@@ -488,34 +652,151 @@ class Matrix
         ///--------------------------------------------------------
         /// @brief Calculate the inverse matrix
         ///
+        /// @note Prefer solve() when only the product of the inverse with
+        /// another matrix is needed, forming the inverse is n times the work
+        ///
         /// @return the inverse matrix
-        Matrix<T> inverse() const
+        Matrix inverse() const
         {
             if (m_cols == 1 and m_rows == 1)
             {
                 return reciprocal();
             }
 
-            T det = determinant();
-            if (det == (T)0)
+            return solve(identity(m_rows));
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Factors the matrix into the form P*A = L*U using gaussian
+        /// elimination with partial pivoting
+        ///
+        /// @note L and U are packed into the returned matrix, L is unit lower
+        /// triangular (diagonal of ones not stored) and U is upper triangular
+        ///
+        /// @param pivots filled with the row swapped with row i at step i
+        ///
+        /// @return packed LU factor of the matrix
+        ///
+        /// @throws std::invalid_argument if the matrix is not square or is singular
+        Matrix luFactor(std::vector<size_t>& pivots) const
+        {
+            if (m_cols != m_rows)
+            {
+                throw std::invalid_argument("Matrix must be square to be LU factored");
+            }
+
+            Matrix lu(*this);
+            if (!lu._lu_decompose(pivots))
             {
-                throw std::invalid_argument("Matrix determinant is zero, no inverse exists");
+                throw std::invalid_argument("Matrix is singular, no LU factor exists");
             }
 
-            return adjoint() / det;
+            return lu;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A*X = B using a packed LU factor created by luFactor()
+        ///
+        /// @note Must be called on the packed LU factor, not the original matrix
+        ///
+        /// @param pivots row swaps returned by luFactor()
+        /// @param rhs (n,k) matrix B, each column is solved for independently. Taken by
+        /// value and solved in place, so a temporary rhs is never copied
+        ///
+        /// @return (n,k) matrix X
+        Matrix luSolve(const std::vector<size_t>& pivots, Matrix rhs) const
+        {
+            if (rhs.getRowCount() != m_rows or pivots.size() != m_rows)
+            {
+                throw std::invalid_argument("LU solve requires a rhs with the same row count as the factor");
+            }
+
+            Matrix x(std::move(rhs));
+            size_t rhsCols = x.getColCount();
+            T* xData = x.get_data();
+
+            // Apply the row swaps in the order they were made
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                if (pivots[i] != i)
+                {
+                    for (size_t c = 0; c < rhsCols; c++)
+                    {
+                        std::swap(xData[i * rhsCols + c], xData[pivots[i] * rhsCols + c]);
+                    }
+                }
+            }
+
+            // Forward substitution, L*y = P*b
+            for (size_t i = 1; i < m_rows; i++)
+            {
+                for (size_t j = 0; j < i; j++)
+                {
+                    T l = get_data()[i * m_cols + j];
+                    if (l == 0)
+                    {
+                        continue;
+                    }
+
+                    for (size_t c = 0; c < rhsCols; c++)
+                    {
+                        xData[i * rhsCols + c] = xData[i * rhsCols + c] - l * xData[j * rhsCols + c];
+                    }
+                }
+            }
+
+            // Back substitution, U*x = y
+            for (size_t i = m_rows; i-- > 0;)
+            {
+                for (size_t j = i + 1; j < m_cols; j++)
+                {
+                    T u = get_data()[i * m_cols + j];
+                    if (u == 0)
+                    {
+                        continue;
+                    }
+
+                    for (size_t c = 0; c < rhsCols; c++)
+                    {
+                        xData[i * rhsCols + c] = xData[i * rhsCols + c] - u * xData[j * rhsCols + c];
+                    }
+                }
+
+                for (size_t c = 0; c < rhsCols; c++)
+                {
+                    xData[i * rhsCols + c] = xData[i * rhsCols + c] / get_data()[i * m_cols + i];
+                }
+            }
+
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A*X = B for X without forming the inverse of A
+        ///
+        /// @param rhs (n,k) matrix B
+        ///
+        /// @return (n,k) matrix X
+        ///
+        /// @throws std::invalid_argument if the matrix is singular
+        Matrix solve(Matrix rhs) const
+        {
+            std::vector<size_t> pivots;
+            Matrix lu = luFactor(pivots);
+            return lu.luSolve(pivots, std::move(rhs));
         };
 
         ///--------------------------------------------------------
         /// @brief Returns a matrix with each value of the input reciprocated
         ///
         /// @return reciprocated matrix
-        Matrix<T> reciprocal() const
+        Matrix reciprocal() const
         {
-            Matrix<T> outMat(m_rows, m_cols);
+            Matrix outMat(m_rows, m_cols);
 
             for (size_t i = 0; i < m_rows * m_cols; i++)
             {
-                outMat.get_data()[i] = 1 / m_data[i];
+                outMat.get_data()[i] = 1 / get_data()[i];
             }
 
             return outMat;
@@ -527,9 +808,9 @@ class Matrix
         /// @param len side length of the identity matrix
         ///
         /// @return identity matrix of requested size
-        static Matrix<T> identity(const size_t& len)
+        static Matrix identity(const size_t& len)
         {
-            Matrix<T> id(len, len);
+            Matrix id(len, len);
             for (size_t i = 0; i < len; i++)
             {
                 for (size_t j = 0; j < len; j++)
@@ -550,7 +831,7 @@ class Matrix
 
     private:
         /// @brief Stores all matrix values, one dimensional to exploit memory adjacency benifits
-        T* m_data;
+        Storage m_storage;
 
         /// @brief the number of columns in the matrix
         size_t m_cols;
@@ -558,6 +839,41 @@ class Matrix
         /// @brief the number of rows in the matrix
         size_t m_rows;
 
+        ///--------------------------------------------------------
+        /// @brief Checks an expression has the dimensions of this matrix
+        ///
+        /// @param expr expression to check
+        /// @param error message if the dimensions do not match
+        ///
+        /// @returns the concrete expression
+        ///
+        /// @throws std::invalid_argument if the dimensions do not match
+        template <typename E>
+        const E& _check_same_size(const Matrix_Expression<E>& expr, const char* error) const
+        {
+            const E& values = expr.self();
+            if (values.getColCount() != m_cols or values.getRowCount() != m_rows)
+            {
+                throw std::invalid_argument(error);
+            }
+
+            return values;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Destroys all values and frees the storage, leaving the matrix empty
+        void _release()
+        {
+            // Empty (moved from) matricies hold no values
+            if (m_rows * m_cols > 0)
+            {
+                std::destroy_n(get_data(), m_rows * m_cols);
+                m_storage.deallocate(m_rows * m_cols);
+                m_rows = 0;
+                m_cols = 0;
+            }
+        };
+
         ///--------------------------------------------------------
         /// @brief Translates a coordinate to the index location of the value
         ///
@@ -569,71 +885,69 @@ class Matrix
         /// @throws std::invalid_argument if row/col location is out of bounds
         size_t _trans_coord(const size_t& row, const size_t& col) const
         {
-            if (!_check_bounds(row, col))
-            {
-               std::string err = _gen_coord_err_string(row, col);
-               throw std::invalid_argument(err.c_str());
-            }
-
-           return row * m_cols + col;
+            Bounds::check(row, col, m_rows, m_cols);
+            return row * m_cols + col;
         };
 
         ///--------------------------------------------------------
-        /// @brief Finds the row containing the most zeros
+        /// @brief Performs an in place LU decomposition with partial pivoting
         ///
-        /// @note if no zeros are found, row 1 (0) will be returned
+        /// @param pivots filled with the row swapped with row k at step k
         ///
-        /// @returns index of row with most zeros
-        size_t _find_zeros_row() const
+        /// @returns false if a zero pivot column was found (singular matrix)
+        bool _lu_decompose(std::vector<size_t>& pivots)
         {
-            size_t highestZerosCount = 0;
-            size_t zerosRow = 0;
+            pivots.assign(m_rows, 0);
+            T* data = get_data();
 
-            for (size_t i = 0; i < m_rows; i++)
+            for (size_t k = 0; k < m_rows; k++)
             {
-                size_t zeroCount = 0;
-                for (size_t j = 0; j < m_cols; j++)
+                // Pick the largest magnitude value in the column as the pivot
+                size_t pivotRow = k;
+                double pivotMag = absoluteValue(data[k * m_cols + k]);
+                for (size_t i = k + 1; i < m_rows; i++)
                 {
-                    if (get(i,j) == 0)
+                    double mag = absoluteValue(data[i * m_cols + k]);
+                    if (mag > pivotMag)
                     {
-                        zeroCount++;
+                        pivotMag = mag;
+                        pivotRow = i;
                     }
                 }
 
-                if (zeroCount > highestZerosCount)
+                pivots[k] = pivotRow;
+                if (pivotMag == 0)
                 {
-                    highestZerosCount = zeroCount;
-                    zerosRow = i;
+                    return false;
                 }
-            }
 
-            return zerosRow;
-        };
+                if (pivotRow != k)
+                {
+                    for (size_t j = 0; j < m_cols; j++)
+                    {
+                        std::swap(data[k * m_cols + j], data[pivotRow * m_cols + j]);
+                    }
+                }
 
-        ///--------------------------------------------------------
-        /// @brief Determines if a coordinate is out of bounds for this matrix
-        ///
-        /// @param row of coordinate (i in common notation)
-        /// @param col of coordinate (j in common notation)
-        ///
-        /// @returns is coordinate in bounds of this array?
-        bool _check_bounds(const size_t& row, const size_t& col) const
-        {
-            // True if both coords are in bounds
-            return (row < m_rows) and (col < m_cols);
-        };
+                T pivot = data[k * m_cols + k];
+                for (size_t i = k + 1; i < m_rows; i++)
+                {
+                    if (data[i * m_cols + k] == 0)
+                    {
+                        continue;
+                    }
 
-        ///--------------------------------------------------------
-        /// @brief Generates the string needed for the error reporting for a bad coord
-        ///
-        /// @param row offending coord row
-        /// @param col offending coord col
-        /// @return string of error message
-        std::string _gen_coord_err_string(const size_t& row, const size_t& col) const
-        {
-            std::stringstream err;
-            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of (" << m_rows - 1 << "," << m_cols - 1 << ")";
-            return err.str();
+                    T l = data[i * m_cols + k] / pivot;
+                    data[i * m_cols + k] = l;
+
+                    for (size_t j = k + 1; j < m_cols; j++)
+                    {
+                        data[i * m_cols + j] = data[i * m_cols + j] - l * data[k * m_cols + j];
+                    }
+                }
+            }
+
+            return true;
         };
 };
 
@@ -644,8 +958,8 @@ class Matrix
 /// @param mat matrix to push to output stream
 ///
 /// @return output stream
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const Matrix<T>& mat)
+template <typename T, typename B, typename S>
+std::ostream& operator<<(std::ostream& os, const Matrix<T, B, S>& mat)
 {
     for (size_t i = 0; i < mat.getRowCount(); i++)
     {
@@ -666,3 +980,51 @@ std::ostream& operator<<(std::ostream& os, const Matrix<T>& mat)
 
     return os;
 }
+
+///--------------------------------------------------------
+/// @brief Evaluates an expression operand, matricies are passed through by reference
+///
+/// @param expr matrix or expression
+///
+/// @return const reference to the matrix, or a new matrix holding the evaluated expression
+template <typename E>
+decltype(auto) evaluateExpression(const E& expr)
+{
+    if constexpr (is_matrix<E>::value)
+    {
+        return (expr);
+    }
+    else
+    {
+        return Matrix<typename E::value_type>(expr);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Operator overload of %, implements matrix cross product
+///
+/// @note Not lazy, every output value depends on a whole row and column. Expression
+/// operands are evaluated once first, then multiplied by the dense kernels
+/// (blocked SIMD for double and Complex_C_t, see Dense_Kernels.h)
+///
+/// @param lhs (m,p) matrix or expression
+/// @param rhs (p,n) matrix or expression
+///
+/// @return (m,n) product
+template <typename L, typename R, typename = enable_binary_expression_t<L, R>>
+Matrix<typename L::value_type> operator%(const L& lhs, const R& rhs)
+{
+    using T = typename L::value_type;
+    const auto& a = evaluateExpression(lhs);
+    const auto& b = evaluateExpression(rhs);
+
+    if (a.getColCount() != b.getRowCount())
+    {
+        throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+    }
+
+    Matrix<T> outMat(a.getRowCount(), b.getColCount());
+    denseMultiply(a.getRowCount(), a.getColCount(), b.getColCount(), a.get_data(), b.get_data(), outMat.get_data());
+
+    return outMat;
+}
@@ -0,0 +1,227 @@
+/// ------------------------------------------
+/// @file Matrix_Expression.h
+///
+/// @brief Header/Source file for lazily evaluated element wise matrix expressions
+///
+/// @note a + b - c * 2.0 builds a small tree of expression objects instead of a
+/// matrix per operator. The tree is only evaluated when it is assigned to (or used
+/// to construct) a Matrix, in a single loop writing straight into the destination.
+/// Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Matrix_Policies.h"
+
+/// @brief Base of every matrix expression, Derived is the concrete expression type (CRTP)
+///
+/// @note Derived must provide value_type, getRowCount(), getColCount() and
+/// operator[](i) giving the value at flat row major index i
+template <typename Derived>
+class Matrix_Expression
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Gets the concrete expression
+        ///
+        /// @return reference to this as the derived type
+        const Derived& self() const
+        {
+            return static_cast<const Derived&>(*this);
+        };
+};
+
+/// @brief True for types deriving from Matrix_Expression
+template <typename E>
+constexpr bool is_matrix_expression_v = std::is_base_of_v<Matrix_Expression<std::decay_t<E>>, std::decay_t<E>>;
+
+/// @brief True for Matrix<T> with any policies
+template <typename E>
+struct is_matrix : std::false_type {};
+
+template <typename T, typename Bounds, typename Storage>
+struct is_matrix<Matrix<T, Bounds, Storage>> : std::true_type {};
+
+/// @brief How an operand is held inside an expression. Matrix lvalues are held by
+/// reference, everything else (temporaries, expressions) by value so that nothing
+/// an expression refers to can be destroyed before it is evaluated
+template <typename E>
+using expression_operand_t = std::conditional_t<std::is_lvalue_reference_v<E> and is_matrix<std::decay_t<E>>::value,
+    const std::decay_t<E>&, std::decay_t<E>>;
+
+/// @brief Element wise operations, applied per value
+struct Expression_Add_t
+{
+    template <typename L, typename R>
+    static auto apply(const L& lhs, const R& rhs) { return lhs + rhs; }
+};
+
+struct Expression_Sub_t
+{
+    template <typename L, typename R>
+    static auto apply(const L& lhs, const R& rhs) { return lhs - rhs; }
+};
+
+struct Expression_Mul_t
+{
+    template <typename L, typename R>
+    static auto apply(const L& lhs, const R& rhs) { return lhs * rhs; }
+};
+
+struct Expression_Div_t
+{
+    template <typename L, typename R>
+    static auto apply(const L& lhs, const R& rhs) { return lhs / rhs; }
+};
+
+/// @brief Element wise combination of two expressions of the same dimensions
+template <typename L, typename R, typename Op>
+class Matrix_Binary_Expression : public Matrix_Expression<Matrix_Binary_Expression<L, R, Op>>
+{
+    public:
+        using value_type = typename std::decay_t<L>::value_type;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor
+        ///
+        /// @param lhs left operand
+        /// @param rhs right operand
+        /// @param error message if the dimensions do not match
+        ///
+        /// @throws std::invalid_argument if the operands differ in dimensions
+        template <typename LA, typename RA>
+        Matrix_Binary_Expression(LA&& lhs, RA&& rhs, const char* error) :
+            m_lhs(std::forward<LA>(lhs)),
+            m_rhs(std::forward<RA>(rhs))
+        {
+            if (m_lhs.getRowCount() != m_rhs.getRowCount() or m_lhs.getColCount() != m_rhs.getColCount())
+            {
+                throw std::invalid_argument(error);
+            }
+        };
+
+        size_t getRowCount() const
+        {
+            return m_lhs.getRowCount();
+        };
+
+        size_t getColCount() const
+        {
+            return m_lhs.getColCount();
+        };
+
+        value_type operator[](const size_t& i) const
+        {
+            return Op::apply(m_lhs[i], m_rhs[i]);
+        };
+
+    private:
+        /// @brief Left operand
+        L m_lhs;
+
+        /// @brief Right operand
+        R m_rhs;
+};
+
+/// @brief Element wise combination of an expression with one scalar
+template <typename E, typename S, typename Op>
+class Matrix_Scalar_Expression : public Matrix_Expression<Matrix_Scalar_Expression<E, S, Op>>
+{
+    public:
+        using value_type = typename std::decay_t<E>::value_type;
+
+        ///--------------------------------------------------------
+        /// @brief Constructor
+        ///
+        /// @param expr matrix operand
+        /// @param scalar applied to every value of expr
+        template <typename EA>
+        Matrix_Scalar_Expression(EA&& expr, const S& scalar) :
+            m_expr(std::forward<EA>(expr)),
+            m_scalar(scalar)
+        {
+        };
+
+        size_t getRowCount() const
+        {
+            return m_expr.getRowCount();
+        };
+
+        size_t getColCount() const
+        {
+            return m_expr.getColCount();
+        };
+
+        value_type operator[](const size_t& i) const
+        {
+            return Op::apply(m_expr[i], m_scalar);
+        };
+
+    private:
+        /// @brief Matrix operand
+        E m_expr;
+
+        /// @brief Scalar operand
+        S m_scalar;
+};
+
+/// @brief Enables the element wise operators for two expressions holding the same value type
+template <typename L, typename R>
+using enable_binary_expression_t = std::enable_if_t<is_matrix_expression_v<L> and is_matrix_expression_v<R> and
+    std::is_same_v<typename std::decay_t<L>::value_type, typename std::decay_t<R>::value_type>>;
+
+/// @brief Enables the scalar operators for an expression and a non expression
+template <typename E, typename S>
+using enable_scalar_expression_t = std::enable_if_t<is_matrix_expression_v<E> and !is_matrix_expression_v<S>>;
+
+///--------------------------------------------------------
+/// @brief Operator overload of +, lazy matrix addition
+///
+/// @throws std::invalid_argument if the operands differ in dimensions
+template <typename L, typename R, typename = enable_binary_expression_t<L, R>>
+auto operator+(L&& lhs, R&& rhs)
+{
+    return Matrix_Binary_Expression<expression_operand_t<L>, expression_operand_t<R>, Expression_Add_t>(
+        std::forward<L>(lhs), std::forward<R>(rhs), "Matrix addition requires matricies of same dimensions");
+}
+
+///--------------------------------------------------------
+/// @brief Operator overload of -, lazy matrix subtraction
+///
+/// @throws std::invalid_argument if the operands differ in dimensions
+template <typename L, typename R, typename = enable_binary_expression_t<L, R>>
+auto operator-(L&& lhs, R&& rhs)
+{
+    return Matrix_Binary_Expression<expression_operand_t<L>, expression_operand_t<R>, Expression_Sub_t>(
+        std::forward<L>(lhs), std::forward<R>(rhs), "Matrix subtraction requires matricies of same dimensions");
+}
+
+///--------------------------------------------------------
+/// @brief Operator overload of *, lazy element wise (dot) product
+///
+/// @throws std::invalid_argument if the operands differ in dimensions
+template <typename L, typename R, typename = enable_binary_expression_t<L, R>>
+auto operator*(L&& lhs, R&& rhs)
+{
+    return Matrix_Binary_Expression<expression_operand_t<L>, expression_operand_t<R>, Expression_Mul_t>(
+        std::forward<L>(lhs), std::forward<R>(rhs), "Dot product requires matricies of same dimensions");
+}
+
+///--------------------------------------------------------
+/// @brief Operator overload of *, lazy multiplication of every value by a scalar
+template <typename E, typename S, typename = enable_scalar_expression_t<E, S>>
+auto operator*(E&& expr, const S& scalar)
+{
+    return Matrix_Scalar_Expression<expression_operand_t<E>, S, Expression_Mul_t>(std::forward<E>(expr), scalar);
+}
+
+///--------------------------------------------------------
+/// @brief Operator overload of /, lazy division of every value by a scalar
+template <typename E, typename S, typename = enable_scalar_expression_t<E, S>>
+auto operator/(E&& expr, const S& scalar)
+{
+    return Matrix_Scalar_Expression<expression_operand_t<E>, S, Expression_Div_t>(std::forward<E>(expr), scalar);
+}
@@ -0,0 +1,250 @@
+/// ------------------------------------------
+/// @file Matrix_Policies.h
+///
+/// @brief Header/Source file for the bounds checking and storage policies of Matrix,
+/// and the row/column spans it hands out
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+
+/// @brief Bounds policy that throws on any coordinate outside the matrix
+struct Checked_Bounds_t
+{
+    ///--------------------------------------------------------
+    /// @brief Checks a coordinate lies within the matrix
+    ///
+    /// @param row coord to check
+    /// @param col coord to check
+    /// @param rows number of rows in the matrix
+    /// @param cols number of columns in the matrix
+    ///
+    /// @throws std::invalid_argument if row/col location is out of bounds
+    static void check(const size_t& row, const size_t& col, const size_t& rows, const size_t& cols)
+    {
+        if (row >= rows or col >= cols)
+        {
+            std::stringstream err;
+            err << "Bad coordinate, (" << row << "," << col << ") is not within the bounds of (" << rows - 1 << "," << cols - 1 << ")";
+            throw std::invalid_argument(err.str());
+        }
+    };
+};
+
+/// @brief Bounds policy that trusts every coordinate, so accessors inline to a plain load/store
+struct Unchecked_Bounds_t
+{
+    static void check(const size_t&, const size_t&, const size_t&, const size_t&)
+    {
+    };
+};
+
+/// @brief Checked in debug builds, unchecked once NDEBUG is defined (release builds)
+#ifdef NDEBUG
+using Default_Bounds_t = Unchecked_Bounds_t;
+#else
+using Default_Bounds_t = Checked_Bounds_t;
+#endif
+
+/// @brief Storage policy on the heap through std::allocator
+///
+/// @note Every storage policy provides the same members, Matrix constructs and
+/// destroys the values itself:
+/// - data(): start of the values
+/// - allocate(count): uninitialised room for count values, storage must be empty
+/// - deallocate(count): frees the room, values must already be destroyed
+/// - take(other, count): takes the count values of other, leaving other empty
+template <typename T>
+class Heap_Storage
+{
+    public:
+        T* data() const
+        {
+            return m_data;
+        };
+
+        void allocate(const size_t& count)
+        {
+            m_data = std::allocator<T>().allocate(count);
+        };
+
+        void deallocate(const size_t& count)
+        {
+            std::allocator<T>().deallocate(m_data, count);
+            m_data = nullptr;
+        };
+
+        void take(Heap_Storage& other, const size_t&) noexcept
+        {
+            m_data = std::exchange(other.m_data, nullptr);
+        };
+
+    private:
+        /// @brief Start of the heap block, nullptr when empty
+        T* m_data = nullptr;
+};
+
+/// @brief Storage policy on the heap, starting on an Alignment byte boundary (a cache line by default)
+/// so aligned SIMD loads can be used on the first row
+template <typename T, size_t Alignment = 64>
+class Aligned_Heap_Storage
+{
+    static_assert(Alignment >= alignof(T) and (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2 no smaller than alignof(T)");
+
+    public:
+        T* data() const
+        {
+            return m_data;
+        };
+
+        void allocate(const size_t& count)
+        {
+            m_data = static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        };
+
+        void deallocate(const size_t&)
+        {
+            ::operator delete(m_data, std::align_val_t(Alignment));
+            m_data = nullptr;
+        };
+
+        void take(Aligned_Heap_Storage& other, const size_t&) noexcept
+        {
+            m_data = std::exchange(other.m_data, nullptr);
+        };
+
+    private:
+        /// @brief Start of the heap block, nullptr when empty
+        T* m_data = nullptr;
+};
+
+/// @brief Storage policy inside the matrix object for up to Capacity values, never touches the heap
+///
+/// @note Moving a matrix with this storage moves each value
+template <typename T, size_t Capacity>
+class Fixed_Storage
+{
+    public:
+        Fixed_Storage() = default;
+        Fixed_Storage(const Fixed_Storage&) = delete;
+        Fixed_Storage& operator=(const Fixed_Storage&) = delete;
+
+        T* data() const
+        {
+            return std::launder(reinterpret_cast<T*>(const_cast<unsigned char*>(m_buffer)));
+        };
+
+        ///--------------------------------------------------------
+        /// @throws std::invalid_argument if count is over Capacity
+        void allocate(const size_t& count)
+        {
+            if (count > Capacity)
+            {
+                throw std::invalid_argument("Fixed matrix storage holds " + std::to_string(Capacity) +
+                    " values, " + std::to_string(count) + " were requested");
+            }
+        };
+
+        void deallocate(const size_t&)
+        {
+        };
+
+        void take(Fixed_Storage& other, const size_t& count) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            std::uninitialized_move_n(other.data(), count, data());
+            std::destroy_n(other.data(), count);
+        };
+
+    private:
+        /// @brief Raw room for the values, constructed in place by Matrix
+        alignas(T) unsigned char m_buffer[Capacity * sizeof(T)];
+};
+
+/// @brief View of one row or column of a matrix, valid while the matrix is unchanged
+///
+/// @note Rows are contiguous (stride 1), columns step a whole row (stride = column count)
+///
+/// @tparam T value type, const for views of a const matrix
+template <typename T>
+struct Matrix_Span_t
+{
+    /// @brief First value
+    T* data;
+
+    /// @brief Number of values
+    size_t size;
+
+    /// @brief Distance in values between neighbours
+    size_t stride;
+
+    /// @brief Walks the span in order, a random access iterator over strided memory
+    class Iterator
+    {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            Iterator(T* ptr, const size_t& stride) : m_ptr(ptr), m_stride(stride) {};
+
+            reference operator*() const { return *m_ptr; };
+            reference operator[](const difference_type& n) const { return m_ptr[n * (difference_type) m_stride]; };
+            Iterator& operator++() { m_ptr += m_stride; return *this; };
+            Iterator operator++(int) { Iterator old = *this; m_ptr += m_stride; return old; };
+            Iterator& operator--() { m_ptr -= m_stride; return *this; };
+            Iterator operator--(int) { Iterator old = *this; m_ptr -= m_stride; return old; };
+            Iterator& operator+=(const difference_type& n) { m_ptr += n * (difference_type) m_stride; return *this; };
+            Iterator& operator-=(const difference_type& n) { m_ptr -= n * (difference_type) m_stride; return *this; };
+            Iterator operator+(const difference_type& n) const { return Iterator(*this) += n; };
+            Iterator operator-(const difference_type& n) const { return Iterator(*this) -= n; };
+            difference_type operator-(const Iterator& other) const { return (m_ptr - other.m_ptr) / (difference_type) m_stride; };
+            bool operator==(const Iterator& other) const { return m_ptr == other.m_ptr; };
+            bool operator!=(const Iterator& other) const { return m_ptr != other.m_ptr; };
+            bool operator<(const Iterator& other) const { return m_ptr < other.m_ptr; };
+
+        private:
+            /// @brief Current value
+            T* m_ptr;
+
+            /// @brief Distance in values between neighbours
+            size_t m_stride;
+    };
+
+    ///--------------------------------------------------------
+    /// @brief Gets a value of the span, without bounds checks
+    ///
+    /// @param i index along the span
+    ///
+    /// @returns reference to the value
+    T& operator[](const size_t& i) const
+    {
+        return data[i * stride];
+    };
+
+    Iterator begin() const
+    {
+        return Iterator(data, stride);
+    };
+
+    Iterator end() const
+    {
+        return Iterator(data + size * stride, stride);
+    };
+};
+
+/// @brief Matrix of values of type T, see Matrix.h
+///
+/// @tparam Bounds bounds checking policy (Checked_Bounds_t, Unchecked_Bounds_t)
+/// @tparam Storage storage policy (Heap_Storage, Aligned_Heap_Storage, Fixed_Storage)
+template <typename T, typename Bounds = Default_Bounds_t, typename Storage = Heap_Storage<T>>
+class Matrix;
@@ -0,0 +1,260 @@
+/// ------------------------------------------
+/// @file Netlist_Parser.h
+///
+/// @brief Header for reading netlist text into components
+///
+/// @note Text is read in place through std::string_view, nothing is copied
+/// per line, only node names are copied once when first interned
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstring>
+
+#include "Complex.h"
+#include "Thread_Pool.h"
+
+/// @brief All whitespace chars for comparing
+const std::string whitespace(" \r\n\t\v\f");
+
+/// @brief GND is a reserved node name
+const std::string ground_node_name("GND");
+
+/// @brief A node declaration line holding only this marker declares nodes on first use
+const std::string implicit_nodes_marker("*");
+
+/// @brief Component lines are parsed in chunks of about this many bytes, one chunk per task,
+/// text shorter than two chunks is parsed on the calling thread
+const size_t parse_chunk_bytes = 1 << 22;
+
+/// @brief Key:
+/// I: current source
+/// V: voltage source
+/// R: resistor
+/// C: capacitor
+/// L: inductor
+const std::vector<char> valid_component_symbols({'I','V','R','L','C'});
+
+/// @brief Read only memory mapping of a whole file
+class Mapped_File
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, maps the file into memory
+        ///
+        /// @param filename local path of file to map
+        ///
+        /// @throws std::invalid_argument if the file cannot be opened or mapped
+        Mapped_File(const std::string& filename);
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, unmaps the file
+        ~Mapped_File();
+
+        Mapped_File(const Mapped_File&) = delete;
+        Mapped_File& operator=(const Mapped_File&) = delete;
+
+        ///--------------------------------------------------------
+        /// @brief Gets the mapped file contents
+        ///
+        /// @return view of the whole file, valid for the lifetime of this object
+        std::string_view getContent() const;
+
+    private:
+        /// @brief Start of the mapping, nullptr for an empty file
+        char* m_data = nullptr;
+
+        /// @brief Size of the mapping in bytes
+        size_t m_size = 0;
+};
+
+/// @brief Assigns dense integer ids to node names in order of first insertion
+class Node_Table
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Finds the id of a node name, adding it if not present
+        ///
+        /// @param name node name to intern
+        ///
+        /// @return dense id of the node
+        int intern(std::string_view name);
+
+        ///--------------------------------------------------------
+        /// @brief Finds the id of a node name
+        ///
+        /// @param name node name to look up
+        ///
+        /// @return dense id of the node, -1 if not present
+        int find(std::string_view name) const;
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of interned nodes
+        ///
+        /// @return number of interned nodes
+        size_t size() const;
+
+        ///--------------------------------------------------------
+        /// @brief Gets all interned names
+        ///
+        /// @return names indexed by id
+        std::vector<std::string> getNames() const;
+
+    private:
+        /// @brief Owned copies of the names, deque keeps the views in m_ids valid
+        std::deque<std::string> m_names;
+
+        /// @brief Lookup from name to id
+        std::unordered_map<std::string_view, int> m_ids;
+};
+
+/// @brief A single parsed component command
+struct Component_t
+{
+    /// @brief Component symbol, one of valid_component_symbols
+    char symbol;
+
+    /// @brief Value of the component, magnitude for sources
+    double value;
+
+    /// @brief Phase of a source in radians, 0 for passive components
+    double phase;
+
+    /// @brief Node id of node 1, -1 indicates ground
+    int node1;
+
+    /// @brief Node id of node 2, -1 indicates ground
+    int node2;
+
+    /// @brief Line of the netlist the component was read from, starting at 1
+    size_t line;
+};
+
+/// @brief All components of a netlist and the names of the nodes they connect
+struct Netlist_t
+{
+    /// @brief Node names indexed by node id
+    std::vector<std::string> node_names;
+
+    /// @brief Non-component lines following the node declaration (e.g. frequency), whitespace trimmed
+    std::vector<std::string> header;
+
+    /// @brief Line number of each header line, starting at 1
+    std::vector<size_t> header_lines;
+
+    /// @brief Components in file order
+    std::vector<Component_t> components;
+};
+
+///--------------------------------------------------------
+/// @brief Calls onLine for every non-blank, non-comment line of the text
+///
+/// @tparam F callable taking (std::string_view line, size_t lineNumber)
+///
+/// @param content text to walk through
+/// @param onLine called with each whitespace trimmed line and its line number
+/// @param firstLine line number of the first line of content, for text cut from a larger file
+template <typename F>
+void forEachLine(std::string_view content, F&& onLine, const size_t& firstLine = 1)
+{
+    size_t lineNumber = firstLine - 1;
+    size_t pos = 0;
+    while (pos < content.size())
+    {
+        lineNumber++;
+        const char* lineEnd = static_cast<const char*>(memchr(content.data() + pos, '\n', content.size() - pos));
+        size_t end = (lineEnd == nullptr) ? content.size() : lineEnd - content.data();
+
+        std::string_view line = content.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t first = line.find_first_not_of(whitespace);
+        if (first == std::string_view::npos)
+        {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(whitespace) - first + 1);
+
+        // Skip lines commented out
+        if (line.substr(0, 2) == "//")
+        {
+            continue;
+        }
+
+        onLine(line, lineNumber);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Splits a line into whitespace separated tokens
+///
+/// @param line line to split
+/// @param tokens output array of at least maxTokens views
+/// @param maxTokens most tokens to store
+///
+/// @return number of tokens in the line, may be more than maxTokens
+size_t tokenize(std::string_view line, std::string_view* tokens, const size_t& maxTokens);
+
+///--------------------------------------------------------
+/// @brief Parses netlist text into node names and components
+///
+/// @note The first line declares node names, or holds only implicit_nodes_marker
+/// to declare each node on first use. The next headerLines lines are stored
+/// unparsed in the header, every line after is a component:
+/// [Symbol char] [component value] [Node1] [Node2]
+///
+/// Large text is cut into line aligned chunks of parse_chunk_bytes parsed in parallel.
+/// Node ids, component order, line numbers and the error reported (the first bad
+/// line of the file) are the same as parsing on one thread
+///
+/// @param content netlist text
+/// @param headerLines number of lines between the node names and the components
+/// @param threadCount number of worker threads for large text, 0 uses the hardware thread count
+///
+/// @return parsed netlist
+Netlist_t parseNetlist(std::string_view content, const size_t& headerLines, const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Maps and parses a netlist file
+///
+/// @param filename local path of file to read
+/// @param headerLines number of lines between the node names and the components
+/// @param threadCount number of worker threads for large files, 0 uses the hardware thread count
+///
+/// @return parsed netlist
+Netlist_t readNetlistFile(const std::string& filename, const size_t& headerLines, const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Finds the nodes with no path to ground through the given components
+///
+/// @note Union-find over the component graph, near linear in the netlist size
+/// and run before stamping so a floating node is reported by name instead of
+/// as a singular matrix
+///
+/// @param netlist parsed netlist
+/// @param conducting symbols of the components that form a path (e.g. "RV" for DC)
+///
+/// @return ids of the nodes not joined to ground, in id order
+std::vector<int> findUngroundedNodes(const Netlist_t& netlist, std::string_view conducting);
+
+///--------------------------------------------------------
+/// @brief Decodes a phasor from a string in the form [mag],[phase]
+///
+/// @param phasorStr string containing phasor in form
+///
+/// @return complex phasor
+Complex_P_t decodePhasor(std::string_view phasorStr);
+
+///--------------------------------------------------------
+/// @brief Converts a component value string into a double value
+/// e.g: 20k -> 20,000, 10m -> 0.001
+///
+/// @param comp string to convert to value
+///
+/// @return resoved value of the component string
+double convertCompToValue(std::string_view comp);
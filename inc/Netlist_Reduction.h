@@ -0,0 +1,89 @@
+/// ------------------------------------------
+/// @file Netlist_Reduction.h
+///
+/// @brief Header for collapsing a parsed netlist before it is stamped
+///
+/// @note Parallel elements are merged, internal series nodes are eliminated and
+/// dangling branches that carry no current are pruned. Every removed node keeps a
+/// rule rebuilding its voltage from the nodes that remain, so results can be
+/// reported for the original netlist
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Netlist_Parser.h"
+#include "Complex.h"
+
+/// @brief A node removed from the netlist, its voltage is
+/// weight * V(node_a) + (1 - weight) * V(node_b)
+struct Eliminated_Node_t
+{
+    /// @brief Id of the removed node in the original netlist
+    int node;
+
+    /// @brief First node its voltage is taken from, -1 indicates ground
+    int node_a;
+
+    /// @brief Second node its voltage is taken from, -1 indicates ground
+    int node_b;
+
+    /// @brief Share of V(node_a) in the voltage, 1 for a node with no current through it
+    double weight;
+};
+
+/// @brief A collapsed netlist and how to rebuild the voltages of the original one
+struct Netlist_Reduction_t
+{
+    /// @brief Collapsed netlist, solved in place of the original
+    Netlist_t netlist;
+
+    /// @brief Node names of the original netlist
+    std::vector<std::string> node_names;
+
+    /// @brief Id in the collapsed netlist of every original node, -1 if removed
+    std::vector<int> reduced_ids;
+
+    /// @brief Removed nodes in the order they were removed
+    std::vector<Eliminated_Node_t> eliminated;
+
+    /// @brief Elements folded into a parallel element
+    size_t parallel_merges = 0;
+
+    /// @brief Series nodes eliminated
+    size_t series_merges = 0;
+
+    /// @brief Dangling nodes pruned
+    size_t pruned_nodes = 0;
+};
+
+///--------------------------------------------------------
+/// @brief Collapses a netlist before stamping, merging parallel elements, eliminating
+/// internal series nodes and pruning current free dangling subtrees
+///
+/// @note Only elements of the same symbol are combined, so the admittance ratio of any
+/// two is real at every frequency and series nodes rebuild exactly. Nodes touching a
+/// source, and nodes with no path to ground (reported by the analysis), are kept
+///
+/// @param netlist parsed netlist
+/// @param mergeable symbols of the passive elements that may be combined ("R" for DC,
+/// "RLC" for AC), the path to ground is checked through these and voltage sources
+///
+/// @return collapsed netlist and the rules to rebuild removed nodes
+Netlist_Reduction_t reduceNetlist(const Netlist_t& netlist, std::string_view mergeable);
+
+///--------------------------------------------------------
+/// @brief Rebuilds the voltage of every node of the original netlist
+///
+/// @tparam T type of the node voltages (pure real, complex)
+///
+/// @param reduction collapsed netlist and its rebuild rules
+/// @param reducedResults voltages of the collapsed netlist in its node order
+///
+/// @return list of original node names matched with their voltage, in original node order
+template <typename T>
+std::vector<std::pair<std::string, T>> restoreNodeVoltages(const Netlist_Reduction_t& reduction,
+    const std::vector<std::pair<std::string, T>>& reducedResults);
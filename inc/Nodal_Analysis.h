@@ -12,23 +12,44 @@
 #include <fstream>
 #include <algorithm>
 #include <stdexcept>
+#include <functional>
 
 #include "Matrix.h"
+#include "Sparse_Matrix.h"
+#include "Sparse_LU.h"
+#include "Supernodal_LU.h"
+#include "Domain_Decomposition.h"
+#include "Dense_LU.h"
+#include "Sparse_PCG.h"
 #include "Complex.h"
+#include "Complex_F.h"
+#include "Thread_Pool.h"
+#include "Netlist_Parser.h"
 
-/// @brief All whitespace chars for comparing
-const std::string whitespace(" \r\n\t\v\f");
+/// @brief Maps every node onto the unknowns left once voltage sources are eliminated
+///
+/// @note Nodes joined by floating voltage sources share one unknown (a supernode),
+/// nodes tied to ground through voltage sources are fixed and have no unknown,
+/// so the reduced matrix keeps the symmetry and definiteness of the full one
+///
+/// @tparam T type of the node voltages (pure real, complex)
+template <typename T>
+struct Node_Reduction_t
+{
+    /// @brief Unknown of each node, -1 for nodes fixed by grounded sources
+    std::vector<int> node_rows;
 
-/// @brief GND is a reserved node name
-const std::string ground_node_name("GND");
+    /// @brief Voltage of each node above its unknown, or its absolute voltage when fixed
+    std::vector<T> node_offsets;
 
-/// @brief Key:
-/// I: current source
-/// V: voltage source
-/// R: resistor
-/// C: capacitor
-/// L: inductor
-const std::vector<char> valid_component_symbols({'I','V','R','L','C'});
+    /// @brief Number of unknowns left in the reduced system
+    size_t unknown_count;
+};
+
+/// @brief Currents added to rows of a net current matrix, in stamping order, so
+/// separate threads can stamp without an (m, 1) matrix each
+template <typename T>
+using Current_Stamps_t = std::vector<std::pair<int, T>>;
 
 /// @brief Stores the needed matricies and net names required for a DC analysis
 struct Nodal_Analysis_DC_t
@@ -38,11 +59,18 @@ struct Nodal_Analysis_DC_t
     /// and net current on the net_currents list.
     std::vector<std::string> node_names;
 
-    /// @brief (n,n) Matrix of conductances between nodes
-    Matrix<double> conductance_mat;
+    /// @brief (m,m) Sparse matrix of conductances between unknowns
+    Sparse_Matrix<double> conductance_mat;
 
-    /// @brief (n, 1) Matrix of net currents on each node
+    /// @brief (m, 1) Matrix of net currents into each unknown, including the
+    /// currents driven by voltage sources
     Matrix<double> net_currents;
+
+    /// @brief Mapping of node voltages onto the m unknowns
+    Node_Reduction_t<double> reduction;
+
+    /// @brief (m, 1) Part of net_currents driven by voltage sources alone
+    Matrix<double> constraint_currents;
 };
 
 /// @brief Stores the needed matricies and net names required for a AC analysis
@@ -53,13 +81,191 @@ struct Nodal_Analysis_AC_t
     /// and net current on the net_currents list.
     std::vector<std::string> node_names;
 
-    /// @brief (n,n) Matrix of admittances between nodes
-    Matrix<Complex_P_t> admittance_mat;
+    /// @brief (m,m) Sparse matrix of admittances between unknowns, cartesian
+    /// so stamping and elimination never need trig
+    Sparse_Matrix<Complex_C_t> admittance_mat;
+
+    /// @brief (m, 1) Matrix of net current phasors into each unknown, cartesian,
+    /// including the currents driven by voltage sources
+    Matrix<Complex_C_t> net_currents;
 
-    /// @brief (n, 1) Matrix of net current phasors on each node
-    Matrix<Complex_P_t> net_currents;
+    /// @brief Mapping of node voltage phasors onto the m unknowns
+    Node_Reduction_t<Complex_C_t> reduction;
 };
 
+/// @brief Stores the frequency independent parts of an AC network so the
+/// admittance matrix can be rebuilt for any frequency,
+/// Y(w) = G + jwC + Gamma/(jw)
+struct Nodal_Analysis_AC_Sweep_t
+{
+    /// @brief Names of the node names used in analysis
+    /// Order of the names corrisponds to both row on the matricies
+    /// and net current on the net_currents list.
+    std::vector<std::string> node_names;
+
+    /// @brief (m,m) Sparse matrix of resistor conductances between unknowns (G)
+    Sparse_Matrix<double> conductance_mat;
+
+    /// @brief (m,m) Sparse matrix of capacitances between unknowns (C)
+    Sparse_Matrix<double> capacitance_mat;
+
+    /// @brief (m,m) Sparse matrix of inverse inductances between unknowns (Gamma)
+    Sparse_Matrix<double> inv_inductance_mat;
+
+    /// @brief (m, 1) Matrix of frequency independent net current phasors into
+    /// each unknown, cartesian, from current sources and voltage sources across G
+    Matrix<Complex_C_t> net_currents;
+
+    /// @brief (m, 1) Currents driven by voltage sources across C, scaled by jw
+    Matrix<Complex_C_t> capacitance_currents;
+
+    /// @brief (m, 1) Currents driven by voltage sources across Gamma, scaled by 1/(jw)
+    Matrix<Complex_C_t> inv_inductance_currents;
+
+    /// @brief Mapping of node voltage phasors onto the m unknowns
+    Node_Reduction_t<Complex_C_t> reduction;
+
+    /// @brief First frequency of the sweep, Hz
+    double start_freq;
+
+    /// @brief Last frequency of the sweep, Hz
+    double stop_freq;
+
+    /// @brief Number of frequency points, including start and stop
+    size_t points;
+
+    /// @brief Are points spaced logarithmically (true) or linearly (false)
+    bool log_spacing;
+};
+
+/// @brief Stores the matricies of a network for time stepping from rest, with
+/// every source switched on at t = 0,
+/// G*v + C*dv/dt + i_L = i, di_L/dt = Gamma*v - i_Gamma
+struct Nodal_Analysis_Transient_t
+{
+    /// @brief Names of the node names used in analysis
+    /// Order of the names corrisponds to both row on the matricies
+    /// and net current on the net_currents list.
+    std::vector<std::string> node_names;
+
+    /// @brief (m,m) Sparse matrix of resistor conductances between unknowns (G)
+    Sparse_Matrix<double> conductance_mat;
+
+    /// @brief (m,m) Sparse matrix of capacitances between unknowns (C)
+    Sparse_Matrix<double> capacitance_mat;
+
+    /// @brief (m,m) Sparse matrix of inverse inductances between unknowns (Gamma)
+    Sparse_Matrix<double> inv_inductance_mat;
+
+    /// @brief (m, 1) Matrix of net currents into each unknown, from current
+    /// sources and voltage sources across G
+    Matrix<double> net_currents;
+
+    /// @brief (m, 1) Currents driven by voltage sources across Gamma (i_Gamma)
+    Matrix<double> inv_inductance_currents;
+
+    /// @brief Mapping of node voltages onto the m unknowns
+    Node_Reduction_t<double> reduction;
+
+    /// @brief Time of the last point, s
+    double stop_time;
+
+    /// @brief Step between points, s, the largest step allowed when adaptive
+    double time_step;
+
+    /// @brief Use the trapezoidal rule (true) or backward Euler (false)
+    bool trapezoidal;
+
+    /// @brief Is the step size chosen from the local truncation error
+    bool adaptive;
+
+    /// @brief Relative local truncation error allowed per step when adaptive
+    double rel_tol = 1e-3;
+
+    /// @brief Absolute local truncation error allowed per step when adaptive, V
+    double abs_tol = 1e-6;
+};
+
+/// @brief Numerical quality of a direct solve
+struct Solve_Diagnostics_t
+{
+    /// @brief Estimated 1-norm condition number of the system matrix, about
+    /// log10 of it decimal digits of the voltages are lost to rounding
+    double condition_estimate = 0;
+
+    /// @brief Largest factor entry over largest matrix entry
+    double pivot_growth = 0;
+};
+
+/// @brief Settings of a mixed precision solve with iterative refinement
+struct Refinement_Options_t
+{
+    /// @brief Stop once the normwise backward error ||b - Ax|| / (||A|| ||x|| + ||b||) falls below this
+    double tolerance = 1e-13;
+
+    /// @brief Refinement steps allowed before falling back to a double precision factor
+    size_t max_iterations = 20;
+
+    /// @brief Worker threads of the dense factorization, 0 uses the hardware thread count
+    size_t thread_count = 0;
+};
+
+/// @brief Convergence report of a mixed precision solve
+struct Refinement_Stats_t
+{
+    /// @brief Refinement steps run on the single precision factor
+    size_t iterations = 0;
+
+    /// @brief Normwise backward error of the returned solution
+    double backward_error = 0;
+
+    /// @brief Was the tolerance reached using the single precision factor alone
+    bool converged = false;
+
+    /// @brief Was the system refactored in double precision, because the single precision
+    /// factor failed or refinement stalled
+    bool double_fallback = false;
+};
+
+/// @brief Settings of a domain decomposition solve
+struct Domain_Options_t
+{
+    /// @brief Subdomain of every node in node_names order, -1 places a node on the interface.
+    /// Left empty the unknowns are partitioned automatically
+    std::vector<int> node_domains;
+
+    /// @brief Subdomains made by the automatic partition, 0 makes domains_per_thread per worker
+    size_t domain_count = 0;
+
+    /// @brief Worker threads for the subdomains and the interface, 0 uses the hardware thread count
+    size_t thread_count = 0;
+};
+
+/// @brief Shape of the partition used by a domain decomposition solve
+struct Domain_Stats_t
+{
+    /// @brief Number of subdomains factored
+    size_t domain_count = 0;
+
+    /// @brief Number of interface unknowns, the side of the dense Schur complement
+    size_t interface_size = 0;
+};
+
+/// @brief Subdomains per worker made by the automatic partition, spare subdomains let idle workers steal
+const size_t domains_per_thread = 2;
+
+/// @brief Work done by a transient analysis
+struct Transient_Stats_t
+{
+    /// @brief Accepted time steps
+    size_t steps = 0;
+
+    /// @brief Steps rejected by the truncation error check and retried smaller
+    size_t rejected_steps = 0;
+
+    /// @brief Numeric factorizations of the system matrix
+    size_t factorizations = 0;
+};
 
 ///--------------------------------------------------------
 /// @brief Uses conductance matrix and net currents to calculate
@@ -70,30 +276,258 @@ struct Nodal_Analysis_AC_t
 /// @return list of pairs of net names and calculated voltages
 std::vector<std::pair<std::string, double>> DCNodalAnalysis(const Nodal_Analysis_DC_t& node_info);
 
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate the voltage at
+/// all nodes, reporting the conditioning of the factored system
+///
+/// @param node_info conductance and current matricies and net names
+/// @param diagnostics filled with the condition estimate and pivot growth
+///
+/// @return list of pairs of net names and calculated voltages
+std::vector<std::pair<std::string, double>> DCNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    Solve_Diagnostics_t& diagnostics);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate the voltage at
+/// all nodes with a multithreaded dense LU factorization
+///
+/// @note For heavily coupled networks where sparse fill-in leaves the factors
+/// close to dense anyway
+///
+/// @param node_info conductance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return list of pairs of net names and calculated voltages
+std::vector<std::pair<std::string, double>> DCDenseNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate the voltage at
+/// all nodes, solving each electrically independent island on its own
+///
+/// @note Unknowns that share no conductance path (other than through ground or a
+/// grounded source) form separate islands, each is extracted, factored and solved
+/// in parallel instead of factoring one large system
+///
+/// @param node_info conductance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return list of pairs of net names and calculated voltages
+std::vector<std::pair<std::string, double>> DCIslandNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate the voltage at
+/// all nodes with a nested dissection ordered supernodal LU factorization
+///
+/// @note For large mesh like grids, independent subtrees of the separator tree are
+/// factored in parallel rather than eliminating one column at a time. A system that needs
+/// pivots from outside a supernode is refactored with the sparse LU
+///
+/// @param node_info conductance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return list of pairs of net names and calculated voltages
+std::vector<std::pair<std::string, double>> DCDissectionNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate the voltage at all
+/// nodes by domain decomposition
+///
+/// @note For circuits made of loosely coupled blocks. Every subdomain is factored on its
+/// own in parallel, the interface unknowns between them are solved from their dense
+/// Schur complement, then each subdomain back-substitutes
+///
+/// @param node_info conductance and current matricies and net names
+/// @param options given or automatic partition and thread count
+/// @param stats filled with the number of subdomains and interface unknowns
+///
+/// @return list of pairs of net names and calculated voltages
+///
+/// @throws std::invalid_argument if the partition does not have one entry per node
+std::vector<std::pair<std::string, double>> DCDomainNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const Domain_Options_t& options, Domain_Stats_t& stats);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate voltages for
+/// all nodes iteratively by preconditioned conjugate gradients
+///
+/// @note Resistor only networks with a path to ground are symmetric positive definite
+///
+/// @param node_info contains names of nodes, conductance matrix and net currents
+/// @param options preconditioner, tolerance and iteration limit
+/// @param stats filled with the iteration count, residual and convergence of the solve
+///
+/// @return list of node names matched with their voltage
+std::vector<std::pair<std::string, double>> DCIterativeNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const PCG_Options_t& options, PCG_Stats_t& stats);
+
+///--------------------------------------------------------
+/// @brief Uses conductance matrix and net currents to calculate voltages for
+/// all nodes by smoothed aggregation multigrid V-cycles
+///
+/// @param node_info contains names of nodes, conductance matrix and net currents
+/// @param options tolerance, iteration limit and hierarchy settings
+/// @param stats filled with the iteration count, residual and convergence of the solve
+///
+/// @return list of node names matched with their voltage
+std::vector<std::pair<std::string, double>> DCMultigridNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const PCG_Options_t& options, PCG_Stats_t& stats);
+
+///--------------------------------------------------------
+/// @brief Solves one DC network for many current source patterns, the
+/// conductance matrix is factored once and all patterns are solved together
+///
+/// @param node_info conductance matrix and net names, current sources in
+/// net_currents are ignored, voltage sources still apply
+/// @param excitations (n, N) matrix, each column is a full set of node currents
+///
+/// @return (n, N) matrix of node voltages, row order matches node_info.node_names
+Matrix<double> DCMultiSourceNodalAnalysis(const Nodal_Analysis_DC_t& node_info, const Matrix<double>& excitations);
+
 ///--------------------------------------------------------
 /// @brief Uses the admittance matrix and net currents to calculate voltages for all nodes
 ///
 /// @param node_info admittance and current matricies and net names
 ///
-/// @return List of pairs of node names and voltage phasors
-std::vector<std::pair<std::string, Complex_P_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info);
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info);
+
+///--------------------------------------------------------
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes, reporting the conditioning of the factored system
+///
+/// @param node_info admittance and current matricies and net names
+/// @param diagnostics filled with the condition estimate and pivot growth
+///
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    Solve_Diagnostics_t& diagnostics);
+
+///--------------------------------------------------------
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes with a multithreaded dense LU factorization
+///
+/// @note For heavily coupled networks where sparse fill-in leaves the factors
+/// close to dense anyway
+///
+/// @param node_info admittance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACDenseNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes, solving each electrically independent island on its own
+///
+/// @note Unknowns that share no admittance path (other than through ground or a
+/// grounded source) form separate islands, each is extracted, factored and solved
+/// in parallel instead of factoring one large system
+///
+/// @param node_info admittance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACIslandNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes with a nested dissection ordered supernodal LU factorization
+///
+/// @note For large mesh like grids, independent subtrees of the separator tree are
+/// factored in parallel rather than eliminating one column at a time. A system that needs
+/// pivots from outside a supernode is refactored with the sparse LU
+///
+/// @param node_info admittance and current matricies and net names
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACDissectionNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes by domain decomposition
+///
+/// @note For circuits made of loosely coupled blocks. Every subdomain is factored on its
+/// own in parallel, the interface unknowns between them are solved from their dense
+/// Schur complement, then each subdomain back-substitutes
+///
+/// @param node_info admittance and current matricies and net names
+/// @param options given or automatic partition and thread count
+/// @param stats filled with the number of subdomains and interface unknowns
+///
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+///
+/// @throws std::invalid_argument if the partition does not have one entry per node
+std::vector<std::pair<std::string, Complex_C_t>> ACDomainNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const Domain_Options_t& options, Domain_Stats_t& stats);
 
 ///--------------------------------------------------------
-/// @brief Splits string into vector using single char delimiter
+/// @brief Uses the admittance matrix and net currents to calculate voltages for all
+/// nodes from a single precision dense LU factor, refined to double precision accuracy
 ///
-/// @param str string to split
-/// @param delim delimiter character
+/// @note The factor takes half the memory and bandwidth of a double precision one.
+/// Each refinement step computes the residual in double precision and solves for the
+/// correction with the single precision factor, well conditioned systems converge in
+/// a few steps. Systems that are too ill conditioned for single precision are
+/// refactored in double precision instead
+///
+/// @param node_info admittance and current matricies and net names
+/// @param options backward error tolerance, step limit and thread count
+/// @param stats filled with the steps, backward error and whether double precision was needed
 ///
-/// @return vector of split strings
-std::vector<std::string> split(const std::string& str, const char& delim);
+/// @return List of pairs of node names and voltage phasors in cartesian form,
+/// use cartToPolar() to convert for display
+std::vector<std::pair<std::string, Complex_C_t>> ACMixedNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const Refinement_Options_t& options, Refinement_Stats_t& stats);
 
 ///--------------------------------------------------------
-/// @brief Parses a text file into a vector, blanking any comment lines
+/// @brief Solves an AC network at every point of a frequency sweep
 ///
-/// @param filename name of file to parse
+/// @note The fill reducing ordering and pivot sequence are computed once and reused
+/// for every frequency, points are solved in parallel but reported in frequency order
 ///
-/// @return parsed file contents
-std::vector<std::string> parseTextContent(const std::string& filename);
+/// @param sweep frequency independent matricies, net currents and sweep range
+/// @param onPoint called for each frequency in order with the cartesian node voltage phasors
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+void ACSweepNodalAnalysis(const Nodal_Analysis_AC_Sweep_t& sweep,
+    const std::function<void(const double&, const std::vector<std::pair<std::string, Complex_C_t>>&)>& onPoint,
+    const size_t& threadCount = 0);
+
+///--------------------------------------------------------
+/// @brief Steps a network through time from rest
+///
+/// @note The system matrix G + a*C + b*Gamma only depends on the step size, so a
+/// fixed step is factored once and every step is a forward/back substitution,
+/// adaptive steps refactor (reusing the ordering and pivots) only when the step changes
+///
+/// @param tran matricies, currents and time range
+/// @param onPoint called for t = 0 and each accepted step in order with the node voltages
+///
+/// @return steps taken, rejected and factorizations done
+///
+/// @throws std::invalid_argument if an adaptive step falls below 1e-9 of the largest step
+Transient_Stats_t TransientNodalAnalysis(const Nodal_Analysis_Transient_t& tran,
+    const std::function<void(const double&, const std::vector<std::pair<std::string, double>>&)>& onPoint);
+
+///--------------------------------------------------------
+/// @brief Lists the frequencies visited by a sweep
+///
+/// @param sweep sweep to list the frequencies of
+///
+/// @return frequencies in Hz, in sweep order
+std::vector<double> sweepFrequencies(const Nodal_Analysis_AC_Sweep_t& sweep);
 
 ///--------------------------------------------------------
 /// @brief Reads a DC analysis file and compiles components into a conductance/net current matrix
@@ -104,7 +538,15 @@ std::vector<std::string> parseTextContent(const std::string& filename);
 Nodal_Analysis_DC_t readDCAnalysisFile(const std::string& filename);
 
 ///--------------------------------------------------------
-/// @brief Reads a DC analysis file and compiles components into a conductance/net current matrix
+/// @brief Compiles parsed DC components into a conductance/net current matrix
+///
+/// @param netlist parsed netlist with no header lines
+///
+/// @return Compiled DC nodal analysis data
+Nodal_Analysis_DC_t compileDCAnalysis(const Netlist_t& netlist);
+
+///--------------------------------------------------------
+/// @brief Reads an AC analysis file and compiles components into an admittance/net current matrix
 ///
 /// @param filename local path of file to read
 ///
@@ -112,16 +554,150 @@ Nodal_Analysis_DC_t readDCAnalysisFile(const std::string& filename);
 Nodal_Analysis_AC_t readACAnalysisFile(const std::string& filename);
 
 ///--------------------------------------------------------
-/// @brief Decodes a phasor from a string in the form [mag],[phase]
+/// @brief Compiles parsed AC components into an admittance/net current matrix
+///
+/// @param netlist parsed netlist with the frequency as its only header line
+///
+/// @return Compiled AC nodal analysis data
+Nodal_Analysis_AC_t compileACAnalysis(const Netlist_t& netlist);
+
+///--------------------------------------------------------
+/// @brief Reads a file of net current patterns for a multi source DC analysis
+///
+/// @note First non-empty line lists the nodes driven, each following line holds
+/// one pattern with a current for each of those nodes, undriven nodes are 0
+///
+/// @param filename local path of file to read
+/// @param node_names names of every node in the network, sets the row order
+///
+/// @return (n, N) matrix with one column per pattern
+Matrix<double> readExcitationFile(const std::string& filename, const std::vector<std::string>& node_names);
+
+///--------------------------------------------------------
+/// @brief Reads a file assigning nodes to subdomains for a domain decomposition solve
+///
+/// @note Each non-empty line holds a node name and its subdomain id, -1 places the
+/// node on the interface. Nodes that are not listed are placed on the interface
+///
+/// @param filename local path of file to read
+/// @param node_names names of every node in the network, sets the order of the result
+///
+/// @return subdomain of every node, see Domain_Options_t::node_domains
+std::vector<int> readPartitionFile(const std::string& filename, const std::vector<std::string>& node_names);
+
+///--------------------------------------------------------
+/// @brief Reads an AC sweep file, the line after the node names holds the sweep
+/// range in the form [start freq] [stop freq] [points] [lin/log]
+///
+/// @param filename local path of file to read
+///
+/// @return Frequency independent AC nodal analysis data
+Nodal_Analysis_AC_Sweep_t readACSweepFile(const std::string& filename);
+
+///--------------------------------------------------------
+/// @brief Compiles parsed AC components into separate G, C and Gamma matricies
+///
+/// @param netlist parsed netlist with the sweep range as its only header line
+///
+/// @return Frequency independent AC nodal analysis data
+Nodal_Analysis_AC_Sweep_t compileACSweep(const Netlist_t& netlist);
+
+///--------------------------------------------------------
+/// @brief Reads a transient analysis file, the line after the node names holds
+/// the time range in the form [stop time] [step] [be/trap] ([fixed/adaptive])
+///
+/// @param filename local path of file to read
+///
+/// @return Transient nodal analysis data
+Nodal_Analysis_Transient_t readTransientAnalysisFile(const std::string& filename);
+
+///--------------------------------------------------------
+/// @brief Compiles parsed components into separate G, C and Gamma matricies for time stepping
+///
+/// @param netlist parsed netlist with the time range as its only header line
+///
+/// @return Transient nodal analysis data
+Nodal_Analysis_Transient_t compileTransientAnalysis(const Netlist_t& netlist);
+
+///--------------------------------------------------------
+/// @brief Eliminates voltage sources, grouping the nodes they join into supernodes
+///
+/// @note A source reads as V(node1) - V(node2) = value, sources joined to ground fix
+/// their nodes, sources in a loop must agree or the netlist is rejected
+///
+/// @tparam T type of the node voltages (pure real, complex)
+///
+/// @param netlist parsed netlist
+/// @param sourceValue converts a V component into its voltage
+///
+/// @return mapping of every node onto the remaining unknowns
+///
+/// @throws std::invalid_argument if voltage sources in a loop do not sum to zero
+template <typename T>
+Node_Reduction_t<T> reduceVoltageSources(const Netlist_t& netlist, const std::function<T(const Component_t&)>& sourceValue);
+
+///--------------------------------------------------------
+/// @brief Rejects a netlist with nodes that have no path to ground, before any
+/// matrix is built or factored
+///
+/// @param netlist parsed netlist
+/// @param conducting symbols of the components that form a path
+/// @param pathName description of the path for the error (e.g. "DC path")
+///
+/// @throws std::invalid_argument naming every node without a path
+void checkGroundPaths(const Netlist_t& netlist, std::string_view conducting, const std::string& pathName);
+
+///--------------------------------------------------------
+/// @brief Rebuilds the voltage of every node from a solution of the reduced system
+///
+/// @tparam T type of the node voltages (pure real, complex)
+///
+/// @param node_names names of every node
+/// @param reduction mapping of nodes onto unknowns
+/// @param solution (m, k) solution of the reduced system
+/// @param col column of the solution to expand
+///
+/// @return list of node names matched with their voltage
+template <typename T>
+std::vector<std::pair<std::string, T>> expandNodeVoltages(const std::vector<std::string>& node_names,
+    const Node_Reduction_t<T>& reduction, const Matrix<T>& solution, const size_t& col = 0);
+
+///--------------------------------------------------------
+/// @brief Adds an admittance between two nodes of a reduced system, voltage
+/// source offsets across it become a known current on its unknowns
+///
+/// @tparam Y type of admittance (pure real, complex)
+/// @tparam T type of the node voltages and currents (pure real, complex)
+/// @tparam C Matrix<T> or Current_Stamps_t<T>
+///
+/// @param mat reduced matrix to add admittance to
+/// @param known_currents (m, 1) matrix or stamp list the offset driven currents are added to
+/// @param admittance admittance to add
+/// @param node1 node 1 of the connected component, -1 indicates ground
+/// @param node2 node 2 of the connected component, -1 indicates ground
+/// @param reduction mapping of nodes onto unknowns
+template <typename Y, typename T, typename C>
+void addReducedAdmittance(Sparse_Matrix<Y>& mat, C& known_currents, const Y& admittance,
+    const int& node1, const int& node2, const Node_Reduction_t<T>& reduction);
+
+///--------------------------------------------------------
+/// @brief Builds a zero filled matrix holding the union of several patterns, so
+/// a weighted sum of the parts can be refilled in place and refactored
 ///
-/// @param phasorStr string containing phasor in form
+/// @tparam T value type of the combined matrix
 ///
-/// @return complex phasor
-Complex_P_t decodePhasor(const std::string& phasorStr);
+/// @param parts compressed matricies of the same size
+/// @param offsets set to, for each part, the offset in the combined values of each of its entries
+///
+/// @return combined pattern with every value zero
+template <typename T>
+Sparse_Matrix<T> unionPattern(const std::vector<const Sparse_Matrix<double>*>& parts, std::vector<std::vector<size_t>>& offsets);
 
 ///--------------------------------------------------------
 /// @brief Adds a given admittance to the admittance matrix given in mat
 ///
+/// @note Stamps up to four triplets, mat must be compressed before use
+///
 /// @tparam T type of admittance (pure real, complex)
 ///
 /// @param mat matrix to add admittance to
@@ -129,13 +705,28 @@ Complex_P_t decodePhasor(const std::string& phasorStr);
 /// @param node1 node 1 of the connected component, -1 indicates ground
 /// @param node2 node 2 of the connected component
 template <typename T>
-void addAdmittance(const Matrix<T>& mat, const T& admittance, const int& node1, const int& node2);
+void addAdmittance(Sparse_Matrix<T>& mat, const T& admittance, const int& node1, const int& node2);
 
 ///--------------------------------------------------------
-/// @brief Converts a component value string into a double value
-/// e.g: 20k -> 20,000, 10m -> 0.001
+/// @brief Adds a current source to the net currents given in net_currents
 ///
-/// @param comp string to convert to value
+/// @tparam T type of current (pure real, complex)
 ///
-/// @return resoved value of the component string
-double convertCompToValue(const std::string& comp);
\ No newline at end of file
+/// @param net_currents (n, 1) matrix of net currents to add to
+/// @param current current flowing into node 1 and out of node 2
+/// @param node1 node 1 of the connected component, -1 indicates ground
+/// @param node2 node 2 of the connected component, -1 indicates ground
+template <typename T>
+void addCurrent(Matrix<T>& net_currents, const T& current, const int& node1, const int& node2);
+
+///--------------------------------------------------------
+/// @brief Records a current source as stamps, to be added to the net currents later
+///
+/// @tparam T type of current (pure real, complex)
+///
+/// @param stamps list the (row, current) pairs are appended to
+/// @param current current flowing into node 1 and out of node 2
+/// @param node1 node 1 of the connected component, -1 indicates ground
+/// @param node2 node 2 of the connected component, -1 indicates ground
+template <typename T>
+void addCurrent(Current_Stamps_t<T>& stamps, const T& current, const int& node1, const int& node2);
\ No newline at end of file
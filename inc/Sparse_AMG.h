@@ -0,0 +1,166 @@
+/// ------------------------------------------
+/// @file Sparse_AMG.h
+///
+/// @brief Header for the smoothed aggregation algebraic multigrid hierarchy
+/// used on symmetric positive definite sparse systems
+///
+/// @note Each V-cycle costs O(nnz), so for grid like conductance matricies the
+/// number of cycles, and so the solve time, grows close to linearly with size
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+
+#include "Matrix.h"
+#include "Sparse_Matrix.h"
+#include "Sparse_LU.h"
+#include "Thread_Pool.h"
+
+/// @brief Settings of the multigrid hierarchy
+struct AMG_Options_t
+{
+    /// @brief Off diagonal a_ij is a strong connection if |a_ij| > threshold * sqrt(a_ii * a_jj),
+    /// 0 treats every connection as strong which gives the largest aggregates on grids
+    double strength_threshold = 0;
+
+    /// @brief Coarse operator entries with |a_ij| <= threshold * sqrt(a_ii * a_jj) are
+    /// lumped onto the diagonal, 0 keeps every entry. Limits fill in on irregular
+    /// graphs at the cost of a weaker coarse correction
+    double drop_threshold = 0;
+
+    /// @brief Levels at or below this size are solved directly with sparse LU
+    size_t coarse_size = 500;
+
+    /// @brief Most levels in the hierarchy, including the finest
+    size_t max_levels = 20;
+
+    /// @brief Damped Jacobi sweeps before and after each coarse correction
+    size_t smoothing_sweeps = 2;
+
+    /// @brief Worker threads used by the smoothers and transfers, 0 uses the hardware thread count
+    size_t thread_count = 0;
+};
+
+/// @brief Smoothed aggregation AMG, built once from a matrix then applied as a
+/// solver (repeated V-cycles) or as a preconditioner (one V-cycle)
+///
+/// @note The matrix is taken to be symmetric, so a column of the CSC storage
+/// is read as the matching row and every product is a parallel gather
+class Sparse_AMG
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, builds the hierarchy of coarse matricies
+        ///
+        /// @param mat (n,n) symmetric positive definite matrix
+        /// @param options coarsening, smoothing and threading settings
+        ///
+        /// @throws std::invalid_argument if the matrix is not square or a diagonal entry is not positive
+        Sparse_AMG(const Sparse_Matrix<double>& mat, const AMG_Options_t& options = AMG_Options_t());
+
+        ///--------------------------------------------------------
+        /// @brief Runs one V-cycle on A*x = b, improving x in place
+        ///
+        /// @param rhs right hand side b, n long
+        /// @param x current guess, n long, updated in place
+        void vCycle(const std::vector<double>& rhs, std::vector<double>& x);
+
+        ///--------------------------------------------------------
+        /// @brief Applies the preconditioner, z = M^-1 * r as one V-cycle from a zero guess
+        ///
+        /// @param vec r on input, z on output
+        void precondition(std::vector<double>& vec);
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of levels in the hierarchy, including the finest
+        ///
+        /// @return number of levels
+        size_t getLevelCount() const;
+
+        ///--------------------------------------------------------
+        /// @brief Get the stored entries of every level over those of the finest level
+        ///
+        /// @return operator complexity of the hierarchy
+        double getOperatorComplexity() const;
+
+    private:
+        /// @brief Operator of each level, finest first
+        std::vector<Sparse_Matrix<double>> m_mats;
+
+        /// @brief Prolongation from level l + 1 to level l, stored transposed (restriction)
+        /// so that prolongation is also a gather over columns
+        std::vector<Sparse_Matrix<double>> m_restrict;
+
+        /// @brief Prolongation from level l + 1 to level l
+        std::vector<Sparse_Matrix<double>> m_prolong;
+
+        /// @brief Jacobi damping factor times the inverse diagonal of each level
+        std::vector<std::vector<double>> m_smooth_scale;
+
+        /// @brief Right hand side work vector of each level
+        std::vector<std::vector<double>> m_rhs;
+
+        /// @brief Solution work vector of each level
+        std::vector<std::vector<double>> m_x;
+
+        /// @brief Residual work vector of each level
+        std::vector<std::vector<double>> m_residual;
+
+        /// @brief Direct factorization of the coarsest level
+        Sparse_LU<double> m_coarse_lu;
+
+        /// @brief Sweeps before and after each coarse correction
+        size_t m_sweeps;
+
+        /// @brief Workers for the per row loops of large levels
+        std::unique_ptr<Thread_Pool> m_pool;
+
+        ///--------------------------------------------------------
+        /// @brief Groups strongly connected nodes into aggregates
+        ///
+        /// @param mat level matrix
+        /// @param threshold strength of connection threshold
+        /// @param aggregateCount set to the number of aggregates
+        ///
+        /// @return aggregate of each node
+        std::vector<uint32_t> _aggregate(const Sparse_Matrix<double>& mat, const double& threshold, size_t& aggregateCount) const;
+
+        ///--------------------------------------------------------
+        /// @brief Lumps weak off diagonal entries onto the diagonal, keeping row sums
+        ///
+        /// @param mat symmetric level matrix
+        /// @param threshold entries with |a_ij| <= threshold * sqrt(a_ii * a_jj) are dropped
+        ///
+        /// @return sparsified matrix
+        Sparse_Matrix<double> _drop_weak(const Sparse_Matrix<double>& mat, const double& threshold) const;
+
+        ///--------------------------------------------------------
+        /// @brief Runs fn(first, last) over row blocks of [0, n), on the pool if n is large
+        ///
+        /// @param n number of rows
+        /// @param fn function taking a half open row range
+        void _for_rows(const size_t& n, const std::function<void(size_t, size_t)>& fn);
+
+        ///--------------------------------------------------------
+        /// @brief Computes out = mat' * x, each output entry gathers one column
+        ///
+        /// @param mat matrix whose transpose is applied
+        /// @param x vector with mat.getRowCount() entries
+        /// @param out vector with mat.getColCount() entries
+        void _gather(const Sparse_Matrix<double>& mat, const std::vector<double>& x, std::vector<double>& out);
+
+        ///--------------------------------------------------------
+        /// @brief Runs one V-cycle starting at a level, using the level work vectors
+        ///
+        /// @param level index of the level, m_rhs[level] and m_x[level] hold b and x
+        void _cycle(const size_t& level);
+
+        ///--------------------------------------------------------
+        /// @brief Damped Jacobi sweeps on a level, x += w * D^-1 * (b - A*x)
+        ///
+        /// @param level index of the level
+        void _smooth(const size_t& level);
+};
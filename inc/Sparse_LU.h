@@ -0,0 +1,639 @@
+/// ------------------------------------------
+/// @file Sparse_LU.h
+///
+/// @brief Header/Source file for sparse LU factorization object
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Sparse_Matrix.h"
+#include "Sparse_Ordering.h"
+
+/// @brief Sparse LU factorization, P*A*Q = L*U
+///
+/// @note Columns are ordered by approximate minimum degree, rows are chosen with
+/// threshold partial pivoting (Gilbert-Peierls left looking factorization),
+/// the diagonal is kept as the pivot when it is large enough to limit fill
+template <typename T>
+class Sparse_LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for an empty factorization, analyze() and factor() must be called before solving
+        ///
+        /// @param pivotTol diagonal is used as pivot if |diag| >= pivotTol * |largest in column|
+        Sparse_LU(const double& pivotTol = 0.001)
+        {
+            m_pivot_tol = pivotTol;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, analyses and factors the given matrix
+        ///
+        /// @param mat square compressed matrix to factor
+        /// @param pivotTol diagonal is used as pivot if |diag| >= pivotTol * |largest in column|
+        ///
+        /// @throws std::invalid_argument if the matrix is not square or is singular
+        Sparse_LU(const Sparse_Matrix<T>& mat, const double& pivotTol = 0.001)
+        {
+            m_pivot_tol = pivotTol;
+            analyze(mat);
+            factor(mat);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Computes the fill reducing column ordering from the matrix pattern
+        ///
+        /// @param mat square compressed matrix to order
+        void analyze(const Sparse_Matrix<T>& mat)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be LU factored");
+            }
+
+            m_n = mat.getRowCount();
+            m_col_perm = minimumDegreeOrdering(m_n, mat.getColPointers(), mat.getRowIndices());
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Numerically factors the matrix using the ordering from analyze()
+        ///
+        /// @param mat square compressed matrix with the same size as the analysed matrix
+        ///
+        /// @throws std::invalid_argument if the matrix is singular
+        void factor(const Sparse_Matrix<T>& mat)
+        {
+            if (m_col_perm.size() != mat.getColCount() or mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Sparse LU must be analysed with a matrix of the same size before factoring");
+            }
+
+            const std::vector<uint32_t>& aColPtr = mat.getColPointers();
+            const std::vector<uint32_t>& aRowIdx = mat.getRowIndices();
+            const std::vector<T>& aValues = mat.getValues();
+
+            m_l_col_ptr.assign(m_n + 1, 0);
+            m_u_col_ptr.assign(m_n + 1, 0);
+            m_l_row_idx.clear();
+            m_l_values.clear();
+            m_u_row_idx.clear();
+            m_u_values.clear();
+            m_l_row_idx.reserve(4 * mat.getNonZeroCount());
+            m_l_values.reserve(4 * mat.getNonZeroCount());
+            m_u_row_idx.reserve(4 * mat.getNonZeroCount());
+            m_u_values.reserve(4 * mat.getNonZeroCount());
+            m_row_perm_inv.assign(m_n, unassigned);
+
+            std::vector<T> x(m_n, (T) 0);
+            std::vector<uint32_t> reach(m_n);
+            std::vector<uint32_t> stack(m_n);
+            std::vector<size_t> resume(m_n);
+            std::vector<char> marked(m_n, 0);
+
+            for (size_t k = 0; k < m_n; k++)
+            {
+                m_l_col_ptr[k] = m_l_row_idx.size();
+                m_u_col_ptr[k] = m_u_row_idx.size();
+                uint32_t col = m_col_perm[k];
+
+                // Solve x = L \ A(:,col) only over the rows reachable in the graph of L
+                size_t top = _reach(aColPtr, aRowIdx, col, reach, stack, resume, marked);
+                for (size_t p = aColPtr[col]; p < aColPtr[col + 1]; p++)
+                {
+                    x[aRowIdx[p]] = aValues[p];
+                }
+
+                for (size_t px = top; px < m_n; px++)
+                {
+                    uint32_t j = reach[px];
+                    uint32_t jCol = m_row_perm_inv[j];
+                    if (jCol == unassigned)
+                    {
+                        continue;
+                    }
+
+                    // L has a unit diagonal stored first in each column
+                    T xj = x[j];
+                    for (size_t p = m_l_col_ptr[jCol] + 1; p < m_l_col_ptr[jCol + 1]; p++)
+                    {
+                        x[m_l_row_idx[p]] = x[m_l_row_idx[p]] - m_l_values[p] * xj;
+                    }
+                }
+
+                // Already pivoted rows form U, the largest of the rest is the pivot candidate
+                uint32_t pivotRow = unassigned;
+                double pivotMag = -1;
+                for (size_t px = top; px < m_n; px++)
+                {
+                    uint32_t i = reach[px];
+                    if (m_row_perm_inv[i] == unassigned)
+                    {
+                        double mag = absoluteValue(x[i]);
+                        if (mag > pivotMag)
+                        {
+                            pivotMag = mag;
+                            pivotRow = i;
+                        }
+                    }
+                    else
+                    {
+                        m_u_row_idx.push_back(m_row_perm_inv[i]);
+                        m_u_values.push_back(x[i]);
+                    }
+                }
+
+                if (pivotRow == unassigned or pivotMag <= 0)
+                {
+                    throw std::invalid_argument("Matrix is singular, no LU factor exists");
+                }
+
+                // Prefer the diagonal to keep the symmetric fill reducing ordering intact
+                if (m_row_perm_inv[col] == unassigned and marked[col] and absoluteValue(x[col]) >= m_pivot_tol * pivotMag)
+                {
+                    pivotRow = col;
+                }
+
+                T pivot = x[pivotRow];
+                m_u_row_idx.push_back(k);
+                m_u_values.push_back(pivot);
+                m_row_perm_inv[pivotRow] = k;
+
+                m_l_row_idx.push_back(pivotRow);
+                m_l_values.push_back((T) 1);
+                for (size_t px = top; px < m_n; px++)
+                {
+                    uint32_t i = reach[px];
+                    if (m_row_perm_inv[i] == unassigned)
+                    {
+                        m_l_row_idx.push_back(i);
+                        m_l_values.push_back(x[i] / pivot);
+                    }
+
+                    x[i] = (T) 0;
+                    marked[i] = 0;
+                }
+            }
+
+            m_l_col_ptr[m_n] = m_l_row_idx.size();
+            m_u_col_ptr[m_n] = m_u_row_idx.size();
+
+            // L was built with original row numbers, move them into pivot order
+            for (uint32_t& row : m_l_row_idx)
+            {
+                row = m_row_perm_inv[row];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Numerically factors a matrix with the same pattern as the last
+        /// factored matrix, reusing its ordering, pivot sequence and L/U patterns
+        ///
+        /// @note Falls back to a full factor() if a reused pivot becomes too small
+        ///
+        /// @param mat square compressed matrix with the same pattern as the last factored matrix
+        ///
+        /// @throws std::invalid_argument if the matrix is singular
+        void refactor(const Sparse_Matrix<T>& mat)
+        {
+            if (m_row_perm_inv.size() != mat.getColCount() or mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Sparse LU must be factored with a matrix of the same pattern before refactoring");
+            }
+
+            const std::vector<uint32_t>& aColPtr = mat.getColPointers();
+            const std::vector<uint32_t>& aRowIdx = mat.getRowIndices();
+            const std::vector<T>& aValues = mat.getValues();
+
+            // x is indexed in pivot order, the same as the stored L/U row indices
+            std::vector<T> x(m_n, (T) 0);
+            for (size_t k = 0; k < m_n; k++)
+            {
+                uint32_t col = m_col_perm[k];
+                for (size_t p = aColPtr[col]; p < aColPtr[col + 1]; p++)
+                {
+                    x[m_row_perm_inv[aRowIdx[p]]] = aValues[p];
+                }
+
+                // U entries are stored in topological order so can be solved in sequence
+                for (size_t p = m_u_col_ptr[k]; p < m_u_col_ptr[k + 1] - 1; p++)
+                {
+                    uint32_t j = m_u_row_idx[p];
+                    T xj = x[j];
+                    m_u_values[p] = xj;
+                    x[j] = (T) 0;
+
+                    for (size_t q = m_l_col_ptr[j] + 1; q < m_l_col_ptr[j + 1]; q++)
+                    {
+                        x[m_l_row_idx[q]] = x[m_l_row_idx[q]] - m_l_values[q] * xj;
+                    }
+                }
+
+                T pivot = x[k];
+                x[k] = (T) 0;
+                double pivotMag = absoluteValue(pivot);
+
+                double largest = 0;
+                for (size_t p = m_l_col_ptr[k] + 1; p < m_l_col_ptr[k + 1]; p++)
+                {
+                    largest = std::max(largest, absoluteValue(x[m_l_row_idx[p]]));
+                }
+
+                if (pivotMag <= 0 or pivotMag < m_pivot_tol * largest)
+                {
+                    // Pivot sequence is no longer stable for these values
+                    factor(mat);
+                    return;
+                }
+
+                m_u_values[m_u_col_ptr[k + 1] - 1] = pivot;
+                for (size_t p = m_l_col_ptr[k] + 1; p < m_l_col_ptr[k + 1]; p++)
+                {
+                    m_l_values[p] = x[m_l_row_idx[p]] / pivot;
+                    x[m_l_row_idx[p]] = (T) 0;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A*X = B using the computed factor
+        ///
+        /// @note Right hand sides are solved in blocks of columns so each
+        /// factor entry is loaded once per block rather than once per column
+        ///
+        /// @param rhs (n,k) matrix B
+        ///
+        /// @return (n,k) matrix X
+        Matrix<T> solve(const Matrix<T>& rhs) const
+        {
+            if (rhs.getRowCount() != m_n or m_row_perm_inv.size() != m_n)
+            {
+                throw std::invalid_argument("Sparse LU solve requires a factored matrix with the same row count as the rhs");
+            }
+
+            size_t rhsCols = rhs.getColCount();
+            Matrix<T> x(m_n, rhsCols);
+            const T* rhsData = rhs.get_data();
+            T* xData = x.get_data();
+            std::vector<T> work(m_n * std::min(rhsCols, solve_block));
+
+            for (size_t c0 = 0; c0 < rhsCols; c0 += solve_block)
+            {
+                size_t block = std::min(solve_block, rhsCols - c0);
+                for (size_t i = 0; i < m_n; i++)
+                {
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        work[m_row_perm_inv[i] * block + c] = rhsData[i * rhsCols + c0 + c];
+                    }
+                }
+
+                _solve_in_place(work.data(), block);
+
+                for (size_t k = 0; k < m_n; k++)
+                {
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        xData[m_col_perm[k] * rhsCols + c0 + c] = work[k * block + c];
+                    }
+                }
+            }
+
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A^H*x = b (A' for real types) using the computed factor
+        ///
+        /// @param rhs (n,1) matrix b
+        ///
+        /// @return (n,1) matrix x
+        Matrix<T> solveAdjoint(const Matrix<T>& rhs) const
+        {
+            if (rhs.getRowCount() != m_n or rhs.getColCount() != 1 or m_row_perm_inv.size() != m_n)
+            {
+                throw std::invalid_argument("Sparse LU adjoint solve requires a factored matrix and a single column rhs of the same row count");
+            }
+
+            // A^H = Q * U^H * L^H * P, so solve U^H*z = Q'*b then L^H*y = z, y = P*x
+            std::vector<T> y(m_n);
+            for (size_t k = 0; k < m_n; k++)
+            {
+                y[k] = rhs.get_data()[m_col_perm[k]];
+            }
+
+            // Columns of U are rows of U^H, each is a dot product with the solved values
+            for (size_t j = 0; j < m_n; j++)
+            {
+                T sum = y[j];
+                for (size_t p = m_u_col_ptr[j]; p < m_u_col_ptr[j + 1] - 1; p++)
+                {
+                    sum = sum - conjugateValue(m_u_values[p]) * y[m_u_row_idx[p]];
+                }
+                y[j] = sum / conjugateValue(m_u_values[m_u_col_ptr[j + 1] - 1]);
+            }
+
+            for (size_t j = m_n; j-- > 0;)
+            {
+                T sum = y[j];
+                for (size_t p = m_l_col_ptr[j] + 1; p < m_l_col_ptr[j + 1]; p++)
+                {
+                    sum = sum - conjugateValue(m_l_values[p]) * y[m_l_row_idx[p]];
+                }
+                y[j] = sum;
+            }
+
+            Matrix<T> x(m_n, 1);
+            for (size_t i = 0; i < m_n; i++)
+            {
+                x.get_data()[i] = y[m_row_perm_inv[i]];
+            }
+
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Estimates the 1-norm condition number ||A||_1 * ||A^-1||_1 of the factored matrix
+        ///
+        /// @note Hager's estimator as refined by Higham (LAPACK xLACON), ||A^-1||_1 is found
+        /// from a handful of solves with A and A^H rather than the inverse. The estimate
+        /// is a lower bound that is almost always within a factor of 3 of the true value
+        ///
+        /// @param mat the matrix that was factored
+        ///
+        /// @return estimated condition number, 1 / machine epsilon means no digits of
+        /// the solution can be trusted
+        double estimateConditionNumber(const Sparse_Matrix<T>& mat) const
+        {
+            if (mat.getRowCount() != m_n or m_row_perm_inv.size() != m_n)
+            {
+                throw std::invalid_argument("Condition estimate requires the factored matrix");
+            }
+
+            auto norm1 = [](const Matrix<T>& vec)
+            {
+                double sum = 0;
+                for (size_t i = 0; i < vec.getRowCount(); i++)
+                {
+                    sum += absoluteValue(vec[i]);
+                }
+                return sum;
+            };
+
+            // Start from the average of all columns of A^-1
+            Matrix<T> x(m_n, 1);
+            for (size_t i = 0; i < m_n; i++)
+            {
+                x.get_data()[i] = (T) (1.0 / m_n);
+            }
+
+            double inverseNorm = 0;
+            size_t lastColumn = m_n;
+            for (size_t iter = 0; iter < condition_iterations; iter++)
+            {
+                Matrix<T> y = solve(x);
+                double yNorm = norm1(y);
+                if (iter > 0 and yNorm <= inverseNorm)
+                {
+                    break;
+                }
+                inverseNorm = yNorm;
+
+                // Gradient of ||A^-1 x||_1 picks the column of A^-1 most likely to be the largest
+                for (size_t i = 0; i < m_n; i++)
+                {
+                    double mag = absoluteValue(y[i]);
+                    y.get_data()[i] = (mag == 0) ? (T) 1 : y[i] / mag;
+                }
+                Matrix<T> z = solveAdjoint(y);
+
+                size_t column = 0;
+                for (size_t i = 1; i < m_n; i++)
+                {
+                    if (absoluteValue(z[i]) > absoluteValue(z[column]))
+                    {
+                        column = i;
+                    }
+                }
+
+                if (column == lastColumn)
+                {
+                    break;
+                }
+                lastColumn = column;
+
+                x = Matrix<T>(m_n, 1);
+                x.get_data()[column] = (T) 1;
+            }
+
+            // Alternating vector guards against the gradient steps missing a large column
+            for (size_t i = 0; i < m_n; i++)
+            {
+                double sign = (i % 2 == 0) ? 1 : -1;
+                x.get_data()[i] = (T) (sign * (1 + (m_n > 1 ? (double) i / (m_n - 1) : 0)));
+            }
+            inverseNorm = std::max(inverseNorm, 2 * norm1(solve(x)) / (3 * m_n));
+
+            // ||A||_1 is the largest column sum
+            double matNorm = 0;
+            const std::vector<uint32_t>& colPtr = mat.getColPointers();
+            const std::vector<T>& values = mat.getValues();
+            for (size_t j = 0; j < m_n; j++)
+            {
+                double sum = 0;
+                for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+                {
+                    sum += absoluteValue(values[p]);
+                }
+                matNorm = std::max(matNorm, sum);
+            }
+
+            return matNorm * inverseNorm;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Finds the element growth of the factorization, max|U| / max|A|
+        ///
+        /// @note Small for the diagonally dominant matricies of passive networks, a large
+        /// value means rounding errors were amplified during elimination
+        ///
+        /// @param mat the matrix that was factored
+        ///
+        /// @return pivot growth factor
+        double getPivotGrowth(const Sparse_Matrix<T>& mat) const
+        {
+            double largestU = 0;
+            for (const T& val : m_u_values)
+            {
+                largestU = std::max(largestU, absoluteValue(val));
+            }
+
+            double largestA = 0;
+            for (const T& val : mat.getValues())
+            {
+                largestA = std::max(largestA, absoluteValue(val));
+            }
+
+            return (largestA == 0) ? 0 : largestU / largestA;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of stored entries in L and U combined
+        ///
+        /// @return number of stored factor entries
+        size_t getFactorNonZeroCount() const
+        {
+            return m_l_values.size() + m_u_values.size();
+        };
+
+    private:
+        /// @brief Marks a row that has not been chosen as a pivot yet
+        static constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+
+        /// @brief Number of right hand side columns solved together
+        static constexpr size_t solve_block = 16;
+
+        /// @brief Most gradient steps taken by the condition estimate
+        static constexpr size_t condition_iterations = 5;
+
+        /// @brief Side length of the factored matrix
+        size_t m_n = 0;
+
+        /// @brief diagonal is used as pivot if |diag| >= m_pivot_tol * |largest in column|
+        double m_pivot_tol;
+
+        /// @brief Fill reducing column order, entry k is the column eliminated at step k
+        std::vector<uint32_t> m_col_perm;
+
+        /// @brief Pivot step each original row was chosen at
+        std::vector<uint32_t> m_row_perm_inv;
+
+        /// @brief Unit lower triangular factor, CSC, diagonal stored first in each column
+        std::vector<size_t> m_l_col_ptr;
+        std::vector<uint32_t> m_l_row_idx;
+        std::vector<T> m_l_values;
+
+        /// @brief Upper triangular factor, CSC, diagonal stored last in each column
+        std::vector<size_t> m_u_col_ptr;
+        std::vector<uint32_t> m_u_row_idx;
+        std::vector<T> m_u_values;
+
+        ///--------------------------------------------------------
+        /// @brief Finds the rows of x = L \ A(:,col) that can be non zero with a depth
+        /// first search through the graph of the columns of L computed so far
+        ///
+        /// @param aColPtr column pointers of A
+        /// @param aRowIdx row indices of A
+        /// @param col column of A being solved for
+        /// @param reach output, reachable rows are stored in topological order in [top, n)
+        /// @param stack work space for the depth first search
+        /// @param resume work space for the depth first search
+        /// @param marked flags for visited rows, left set for rows in [top, n)
+        ///
+        /// @returns top, index of the first reachable row
+        size_t _reach(const std::vector<uint32_t>& aColPtr, const std::vector<uint32_t>& aRowIdx, const uint32_t& col,
+            std::vector<uint32_t>& reach, std::vector<uint32_t>& stack, std::vector<size_t>& resume, std::vector<char>& marked) const
+        {
+            size_t top = m_n;
+            for (size_t p = aColPtr[col]; p < aColPtr[col + 1]; p++)
+            {
+                if (marked[aRowIdx[p]])
+                {
+                    continue;
+                }
+
+                size_t head = 0;
+                stack[0] = aRowIdx[p];
+                while (true)
+                {
+                    uint32_t j = stack[head];
+                    uint32_t jCol = m_row_perm_inv[j];
+                    if (!marked[j])
+                    {
+                        marked[j] = 1;
+                        resume[head] = (jCol == unassigned) ? 0 : m_l_col_ptr[jCol] + 1;
+                    }
+
+                    bool done = true;
+                    size_t end = (jCol == unassigned) ? 0 : m_l_col_ptr[jCol + 1];
+                    for (size_t q = resume[head]; q < end; q++)
+                    {
+                        uint32_t i = m_l_row_idx[q];
+                        if (marked[i])
+                        {
+                            continue;
+                        }
+
+                        // Come back to the next child once this one is finished
+                        resume[head] = q + 1;
+                        stack[++head] = i;
+                        done = false;
+                        break;
+                    }
+
+                    if (done)
+                    {
+                        reach[--top] = j;
+                        if (head == 0)
+                        {
+                            break;
+                        }
+                        head--;
+                    }
+                }
+            }
+
+            return top;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves L*U*Y = B in place for a block of right hand sides
+        /// where B is already in pivot order
+        ///
+        /// @param work (n, block) row major rhs, overwritten with the column permuted solution
+        /// @param block number of right hand sides held in work
+        void _solve_in_place(T* work, const size_t& block) const
+        {
+            for (size_t j = 0; j < m_n; j++)
+            {
+                const T* yj = work + j * block;
+                for (size_t p = m_l_col_ptr[j] + 1; p < m_l_col_ptr[j + 1]; p++)
+                {
+                    T* yi = work + m_l_row_idx[p] * block;
+                    T l = m_l_values[p];
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        yi[c] = yi[c] - l * yj[c];
+                    }
+                }
+            }
+
+            for (size_t j = m_n; j-- > 0;)
+            {
+                T* yj = work + j * block;
+                T diag = m_u_values[m_u_col_ptr[j + 1] - 1];
+                for (size_t c = 0; c < block; c++)
+                {
+                    yj[c] = yj[c] / diag;
+                }
+
+                for (size_t p = m_u_col_ptr[j]; p < m_u_col_ptr[j + 1] - 1; p++)
+                {
+                    T* yi = work + m_u_row_idx[p] * block;
+                    T u = m_u_values[p];
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        yi[c] = yi[c] - u * yj[c];
+                    }
+                }
+            }
+        };
+};
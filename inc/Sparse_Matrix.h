@@ -0,0 +1,612 @@
+/// ------------------------------------------
+/// @file Sparse_Matrix.h
+///
+/// @brief Header/Source file for compressed sparse matrix object
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "Matrix.h"
+#include "Thread_Pool.h"
+
+/// @brief Templated sparse matrix, assembled from (row, col, value) triplets and
+/// stored in compressed sparse column (CSC) form with 32 bit indices
+template <typename T>
+class Sparse_Matrix
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for an empty sparse matrix
+        ///
+        /// @param rows number of rows in the matrix
+        /// @param cols number of columns in the matrix
+        ///
+        /// @throws std::invalid_argument if rows/cols < 1 or do not fit a 32 bit index
+        Sparse_Matrix(const size_t& rows, const size_t& cols)
+        {
+            if (rows < 1 or cols < 1)
+            {
+                throw std::invalid_argument("Cols/Rows of a matrix must be above 0");
+            }
+
+            if (rows > std::numeric_limits<uint32_t>::max() or cols > std::numeric_limits<uint32_t>::max())
+            {
+                throw std::invalid_argument("Cols/Rows of a sparse matrix must fit in a 32 bit index");
+            }
+
+            m_rows = rows;
+            m_cols = cols;
+            m_col_ptr.assign(m_cols + 1, 0);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Adds a value onto the entry at (row, col)
+        ///
+        /// @note Values are only held as triplets until compress() is called,
+        /// duplicate coordinates are summed on compression
+        ///
+        /// @param row to add value at
+        /// @param col to add value at
+        /// @param val to add to the coordinate
+        void add(const size_t& row, const size_t& col, const T& val)
+        {
+            if (row >= m_rows or col >= m_cols)
+            {
+                throw std::invalid_argument("Bad coordinate, (" + std::to_string(row) + "," + std::to_string(col) +
+                    ") is not within the bounds of (" + std::to_string(m_rows - 1) + "," + std::to_string(m_cols - 1) + ")");
+            }
+
+            m_triplets.push_back({(uint32_t) row, (uint32_t) col, val});
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Reserves space for a number of triplets before assembly
+        ///
+        /// @param count number of triplets expected
+        void reserve(const size_t& count)
+        {
+            m_triplets.reserve(count);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Merges all pending triplets into the compressed storage
+        ///
+        /// @note Duplicate coordinates are summed, existing compressed values are kept
+        void compress()
+        {
+            if (m_triplets.empty())
+            {
+                return;
+            }
+
+            _append_compressed();
+
+            std::sort(m_triplets.begin(), m_triplets.end(),
+                [](const Triplet_t& a, const Triplet_t& b)
+                {
+                    return a.col < b.col or (a.col == b.col and a.row < b.row);
+                });
+
+            m_row_idx.clear();
+            m_values.clear();
+            m_col_ptr.assign(m_cols + 1, 0);
+
+            for (size_t i = 0; i < m_triplets.size(); i++)
+            {
+                const Triplet_t& trip = m_triplets[i];
+                if (!m_row_idx.empty() and i > 0 and
+                    m_triplets[i - 1].col == trip.col and m_triplets[i - 1].row == trip.row)
+                {
+                    m_values.back() = m_values.back() + trip.val;
+                    continue;
+                }
+
+                m_row_idx.push_back(trip.row);
+                m_values.push_back(trip.val);
+                m_col_ptr[trip.col + 1]++;
+            }
+
+            if (m_values.size() > std::numeric_limits<uint32_t>::max())
+            {
+                throw std::invalid_argument("Sparse matrix non zero count must fit in a 32 bit index");
+            }
+
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                m_col_ptr[j + 1] += m_col_ptr[j];
+            }
+
+            m_triplets.clear();
+            m_triplets.shrink_to_fit();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Merges the pending triplets of this matrix and of every part into the
+        /// compressed storage, sorting and summing column ranges in parallel
+        ///
+        /// @note Parts are matricies of the same size assembled by separate threads, their
+        /// triplets are consumed. Duplicates are summed in order (this matrix, then each
+        /// part in turn) so the result does not depend on the thread count
+        ///
+        /// @param parts matricies holding the triplets of each thread
+        /// @param pool workers to sort and sum on
+        ///
+        /// @throws std::invalid_argument if a part has a different size
+        void compress(std::vector<Sparse_Matrix>& parts, Thread_Pool& pool)
+        {
+            std::vector<std::vector<Triplet_t>*> sources{&m_triplets};
+            for (Sparse_Matrix& part : parts)
+            {
+                if (part.m_rows != m_rows or part.m_cols != m_cols)
+                {
+                    throw std::invalid_argument("Sparse matricies must be the same size to be merged");
+                }
+                sources.push_back(&part.m_triplets);
+            }
+            _append_compressed();
+
+            // Triplets are scattered into column range buckets, ordered by source within a bucket
+            size_t bucketCount = std::min(m_cols, 4 * pool.getThreadCount());
+            auto bucketOf = [&](const uint32_t& col)
+            {
+                return (size_t) (((uint64_t) col * bucketCount) / m_cols);
+            };
+
+            std::vector<std::vector<size_t>> offsets(sources.size(), std::vector<size_t>(bucketCount, 0));
+            pool.parallelFor(0, sources.size(), [&](size_t s)
+            {
+                for (const Triplet_t& trip : *sources[s])
+                {
+                    offsets[s][bucketOf(trip.col)]++;
+                }
+            });
+
+            std::vector<size_t> bucketStart(bucketCount + 1, 0);
+            size_t total = 0;
+            for (size_t b = 0; b < bucketCount; b++)
+            {
+                bucketStart[b] = total;
+                for (size_t s = 0; s < sources.size(); s++)
+                {
+                    size_t count = offsets[s][b];
+                    offsets[s][b] = total;
+                    total += count;
+                }
+            }
+            bucketStart[bucketCount] = total;
+
+            std::vector<Triplet_t> sorted(total);
+            pool.parallelFor(0, sources.size(), [&](size_t s)
+            {
+                std::vector<size_t>& next = offsets[s];
+                for (const Triplet_t& trip : *sources[s])
+                {
+                    sorted[next[bucketOf(trip.col)]++] = trip;
+                }
+
+                std::vector<Triplet_t>().swap(*sources[s]);
+            });
+
+            // Each bucket owns whole columns, so it is sorted and summed in place independently
+            m_col_ptr.assign(m_cols + 1, 0);
+            std::vector<size_t> bucketCounts(bucketCount, 0);
+            pool.parallelFor(0, bucketCount, [&](size_t b)
+            {
+                auto first = sorted.begin() + bucketStart[b];
+                auto last = sorted.begin() + bucketStart[b + 1];
+                std::stable_sort(first, last,
+                    [](const Triplet_t& lhs, const Triplet_t& rhs)
+                    {
+                        return lhs.col < rhs.col or (lhs.col == rhs.col and lhs.row < rhs.row);
+                    });
+
+                auto out = first;
+                for (auto it = first; it != last; ++it)
+                {
+                    if (out != first and (out - 1)->col == it->col and (out - 1)->row == it->row)
+                    {
+                        (out - 1)->val = (out - 1)->val + it->val;
+                        continue;
+                    }
+
+                    *out++ = *it;
+                    m_col_ptr[it->col + 1]++;
+                }
+                bucketCounts[b] = out - first;
+            });
+
+            size_t nonZeros = 0;
+            std::vector<size_t> outStart(bucketCount);
+            for (size_t b = 0; b < bucketCount; b++)
+            {
+                outStart[b] = nonZeros;
+                nonZeros += bucketCounts[b];
+            }
+
+            if (nonZeros > std::numeric_limits<uint32_t>::max())
+            {
+                throw std::invalid_argument("Sparse matrix non zero count must fit in a 32 bit index");
+            }
+
+            m_row_idx.resize(nonZeros);
+            m_values.resize(nonZeros);
+            pool.parallelFor(0, bucketCount, [&](size_t b)
+            {
+                for (size_t i = 0; i < bucketCounts[b]; i++)
+                {
+                    const Triplet_t& trip = sorted[bucketStart[b] + i];
+                    m_row_idx[outStart[b] + i] = trip.row;
+                    m_values[outStart[b] + i] = trip.val;
+                }
+            });
+
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                m_col_ptr[j + 1] += m_col_ptr[j];
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Gets the value at the row col position
+        ///
+        /// @param row to get value from
+        /// @param col to get value from
+        ///
+        /// @returns value at given location, zero if no entry is stored
+        ///
+        /// @throws std::invalid_argument if the matrix has uncompressed triplets
+        T get(const size_t& row, const size_t& col) const
+        {
+            _check_compressed();
+            if (row >= m_rows or col >= m_cols)
+            {
+                throw std::invalid_argument("Bad coordinate, (" + std::to_string(row) + "," + std::to_string(col) +
+                    ") is not within the bounds of (" + std::to_string(m_rows - 1) + "," + std::to_string(m_cols - 1) + ")");
+            }
+
+            auto first = m_row_idx.begin() + m_col_ptr[col];
+            auto last = m_row_idx.begin() + m_col_ptr[col + 1];
+            auto it = std::lower_bound(first, last, (uint32_t) row);
+            if (it == last or *it != row)
+            {
+                return (T) 0;
+            }
+
+            return m_values[std::distance(m_row_idx.begin(), it)];
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of rows in the matrix
+        ///
+        /// @return number of rows in the matrix
+        size_t getRowCount() const
+        {
+            return m_rows;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of columns in the matrix
+        ///
+        /// @return number of columns in the matrix
+        size_t getColCount() const
+        {
+            return m_cols;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of stored entries in the compressed matrix
+        ///
+        /// @return number of stored entries
+        size_t getNonZeroCount() const
+        {
+            return m_values.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Column start offsets into the row index/value arrays, (cols + 1) long
+        ///
+        /// @return reference to column pointer array
+        const std::vector<uint32_t>& getColPointers() const
+        {
+            _check_compressed();
+            return m_col_ptr;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Row index of every stored entry, sorted within each column
+        ///
+        /// @return reference to row index array
+        const std::vector<uint32_t>& getRowIndices() const
+        {
+            _check_compressed();
+            return m_row_idx;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Value of every stored entry, same order as getRowIndices()
+        ///
+        /// @return reference to value array
+        const std::vector<T>& getValues() const
+        {
+            _check_compressed();
+            return m_values;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Mutable value of every stored entry, used to refill a matrix
+        /// that keeps the same pattern
+        ///
+        /// @return reference to value array
+        std::vector<T>& getValues()
+        {
+            _check_compressed();
+            return m_values;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Finds where an entry is held in the value array
+        ///
+        /// @param row of the entry
+        /// @param col of the entry
+        ///
+        /// @return offset into getValues()
+        ///
+        /// @throws std::invalid_argument if no entry is stored at (row, col)
+        size_t findEntry(const size_t& row, const size_t& col) const
+        {
+            _check_compressed();
+            if (col < m_cols)
+            {
+                auto first = m_row_idx.begin() + m_col_ptr[col];
+                auto last = m_row_idx.begin() + m_col_ptr[col + 1];
+                auto it = std::lower_bound(first, last, (uint32_t) row);
+                if (it != last and *it == row)
+                {
+                    return std::distance(m_row_idx.begin(), it);
+                }
+            }
+
+            throw std::invalid_argument("No entry is stored at (" + std::to_string(row) + "," + std::to_string(col) + ")");
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Converts the matrix to dense storage
+        ///
+        /// @return dense copy of the matrix
+        Matrix<T> toDense() const
+        {
+            _check_compressed();
+            Matrix<T> outMat(m_rows, m_cols);
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                for (size_t p = m_col_ptr[j]; p < m_col_ptr[j + 1]; p++)
+                {
+                    outMat.set(m_row_idx[p], j, m_values[p]);
+                }
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, implements sparse * dense matrix product
+        ///
+        /// @param mat reference to rval dense matrix
+        ///
+        /// @return dense result of the product
+        Matrix<T> operator%(Matrix<T> const& mat) const
+        {
+            _check_compressed();
+            if (m_cols != mat.getRowCount())
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            size_t outCols = mat.getColCount();
+            Matrix<T> outMat(m_rows, outCols);
+            T* outData = outMat.get_data();
+            const T* inData = mat.get_data();
+
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                for (size_t p = m_col_ptr[j]; p < m_col_ptr[j + 1]; p++)
+                {
+                    for (size_t c = 0; c < outCols; c++)
+                    {
+                        outData[m_row_idx[p] * outCols + c] += m_values[p] * inData[j * outCols + c];
+                    }
+                }
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Operator overload of %, implements sparse * sparse matrix product
+        ///
+        /// @note Each output column is gathered in a dense accumulator (Gustavson)
+        ///
+        /// @param mat reference to rval sparse matrix
+        ///
+        /// @return sparse result of the product
+        Sparse_Matrix<T> operator%(Sparse_Matrix<T> const& mat) const
+        {
+            _check_compressed();
+            mat._check_compressed();
+            if (m_cols != mat.m_rows)
+            {
+                throw std::invalid_argument("Cross product requires matricies of the dimensions: (m,p) % (p,n)");
+            }
+
+            Sparse_Matrix<T> outMat(m_rows, mat.m_cols);
+            std::vector<T> accumulator(m_rows, (T) 0);
+            std::vector<uint32_t> mark(m_rows, std::numeric_limits<uint32_t>::max());
+            std::vector<uint32_t> pattern;
+
+            for (size_t j = 0; j < mat.m_cols; j++)
+            {
+                pattern.clear();
+                for (size_t q = mat.m_col_ptr[j]; q < mat.m_col_ptr[j + 1]; q++)
+                {
+                    uint32_t k = mat.m_row_idx[q];
+                    for (size_t p = m_col_ptr[k]; p < m_col_ptr[k + 1]; p++)
+                    {
+                        uint32_t i = m_row_idx[p];
+                        if (mark[i] != j)
+                        {
+                            mark[i] = j;
+                            accumulator[i] = (T) 0;
+                            pattern.push_back(i);
+                        }
+                        accumulator[i] = accumulator[i] + m_values[p] * mat.m_values[q];
+                    }
+                }
+
+                std::sort(pattern.begin(), pattern.end());
+                for (uint32_t i : pattern)
+                {
+                    outMat.m_row_idx.push_back(i);
+                    outMat.m_values.push_back(accumulator[i]);
+                }
+
+                if (outMat.m_values.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    throw std::invalid_argument("Sparse matrix non zero count must fit in a 32 bit index");
+                }
+                outMat.m_col_ptr[j + 1] = outMat.m_values.size();
+            }
+
+            return outMat;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Transposes the matrix
+        ///
+        /// @return transposed matrix, rows remain sorted within each column
+        Sparse_Matrix<T> transpose() const
+        {
+            _check_compressed();
+            Sparse_Matrix<T> outMat(m_cols, m_rows);
+            outMat.m_row_idx.resize(m_values.size());
+            outMat.m_values.resize(m_values.size());
+
+            for (uint32_t row : m_row_idx)
+            {
+                outMat.m_col_ptr[row + 1]++;
+            }
+            for (size_t i = 0; i < m_rows; i++)
+            {
+                outMat.m_col_ptr[i + 1] += outMat.m_col_ptr[i];
+            }
+
+            // Visiting columns in order keeps each output column sorted
+            std::vector<uint32_t> next(outMat.m_col_ptr.begin(), outMat.m_col_ptr.end() - 1);
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                for (size_t p = m_col_ptr[j]; p < m_col_ptr[j + 1]; p++)
+                {
+                    uint32_t q = next[m_row_idx[p]]++;
+                    outMat.m_row_idx[q] = j;
+                    outMat.m_values[q] = m_values[p];
+                }
+            }
+
+            return outMat;
+        };
+
+    private:
+        /// @brief Uncompressed entry used during assembly
+        struct Triplet_t
+        {
+            uint32_t row;
+            uint32_t col;
+            T val;
+        };
+
+        /// @brief the number of rows in the matrix
+        size_t m_rows;
+
+        /// @brief the number of columns in the matrix
+        size_t m_cols;
+
+        /// @brief Start of each column in m_row_idx/m_values, (cols + 1) long
+        std::vector<uint32_t> m_col_ptr;
+
+        /// @brief Row of each stored entry
+        std::vector<uint32_t> m_row_idx;
+
+        /// @brief Value of each stored entry
+        std::vector<T> m_values;
+
+        /// @brief Triplets waiting to be merged by compress()
+        std::vector<Triplet_t> m_triplets;
+
+        ///--------------------------------------------------------
+        /// @brief Appends the compressed entries to the pending triplets so compressing
+        /// again keeps them
+        void _append_compressed()
+        {
+            for (size_t j = 0; j < m_cols; j++)
+            {
+                for (size_t p = m_col_ptr[j]; p < m_col_ptr[j + 1]; p++)
+                {
+                    m_triplets.push_back({m_row_idx[p], (uint32_t) j, m_values[p]});
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Ensures there are no pending triplets before compressed data is read
+        ///
+        /// @throws std::invalid_argument if compress() has not been called since the last add()
+        void _check_compressed() const
+        {
+            if (!m_triplets.empty())
+            {
+                throw std::invalid_argument("Sparse matrix must be compressed before it is read");
+            }
+        };
+};
+
+///--------------------------------------------------------
+/// @brief Overload of <<, used to convert sparse matrix into an output stream
+///
+/// @note Only stored entries are output, one "(row,col): value" per line
+///
+/// @param os output stream
+/// @param mat sparse matrix to push to output stream
+///
+/// @return output stream
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const Sparse_Matrix<T>& mat)
+{
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<T>& values = mat.getValues();
+
+    bool first = true;
+    for (size_t j = 0; j < mat.getColCount(); j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            if (!first)
+            {
+                os << std::endl;
+            }
+            first = false;
+
+            os << "(" << rowIdx[p] << "," << j << "): " << values[p];
+        }
+    }
+
+    return os;
+}
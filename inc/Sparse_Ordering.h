@@ -0,0 +1,88 @@
+/// ------------------------------------------
+/// @file Sparse_Ordering.h
+///
+/// @brief Header for fill reducing orderings and structural analysis of sparse matrices
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+///--------------------------------------------------------
+/// @brief Builds the adjacency lists of the symmetric pattern A + A^T,
+/// diagonal entries are dropped
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+///
+/// @return sorted neighbour list for every row/column
+std::vector<std::vector<uint32_t>> symmetricAdjacency(const size_t& n,
+    const std::vector<uint32_t>& colPtr, const std::vector<uint32_t>& rowIdx);
+
+///--------------------------------------------------------
+/// @brief Computes an approximate minimum degree ordering of the pattern A + A^T
+///
+/// @note Uses a quotient graph with element absorption, the degree of each
+/// variable is bounded by the sizes of its adjacent elements as in AMD
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+///
+/// @return permutation, entry k is the original index eliminated at step k
+std::vector<uint32_t> minimumDegreeOrdering(const size_t& n,
+    const std::vector<uint32_t>& colPtr, const std::vector<uint32_t>& rowIdx);
+
+///--------------------------------------------------------
+/// @brief Splits the pattern A + A^T into connected components (islands), rows
+/// and columns of different islands never share an entry
+///
+/// @note Union-find with path halving and union by size over the stored entries,
+/// near linear in the number of entries
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+/// @param component set to the island of every row/column, islands are numbered
+/// in order of their lowest index
+///
+/// @return number of islands
+size_t connectedComponents(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<uint32_t>& component);
+
+/// @brief Largest subgraph nested dissection leaves unsplit, its front is dense anyway
+const size_t dissection_leaf_size = 32;
+
+/// @brief One separator, or leaf subdomain, of a nested dissection
+struct Dissection_Node_t
+{
+    /// @brief Position in the ordering of the first of the node's own unknowns
+    uint32_t begin;
+
+    /// @brief One past the position of the node's last unknown
+    uint32_t end;
+
+    /// @brief Separator that split this node's subdomain off, -1 for a root
+    int parent;
+};
+
+///--------------------------------------------------------
+/// @brief Computes a nested dissection ordering of the pattern A + A^T
+///
+/// @note Each subgraph is split by the middle level of a breadth first search from a
+/// pseudo-peripheral vertex, the level is trimmed to the vertices that touch the far
+/// side. Both halves are ordered before the separator, so no entry (or fill) joins
+/// two subtrees and they can be eliminated independently. Subgraphs of at most
+/// dissection_leaf_size vertices are not split further
+///
+/// @param n side length of the square matrix
+/// @param colPtr CSC column pointers of A
+/// @param rowIdx CSC row indices of A
+/// @param tree set to the separator tree in postorder, every node comes after its
+/// descendants and owns the positions [begin, end) of the ordering
+///
+/// @return permutation, entry k is the original index eliminated at step k
+std::vector<uint32_t> nestedDissectionOrdering(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<Dissection_Node_t>& tree);
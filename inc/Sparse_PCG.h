@@ -0,0 +1,155 @@
+/// ------------------------------------------
+/// @file Sparse_PCG.h
+///
+/// @brief Header for the iterative solvers of symmetric positive definite
+/// sparse systems, preconditioned conjugate gradients and multigrid
+///
+/// @note A grounded resistor network gives a symmetric positive definite
+/// conductance matrix, PCG solves it in O(nnz) memory where a direct
+/// factorization may need far more for the fill in
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Matrix.h"
+#include "Sparse_Matrix.h"
+#include "Sparse_AMG.h"
+
+/// @brief Preconditioners available to the PCG solver
+enum class Preconditioner_t
+{
+    /// @brief Inverse of the matrix diagonal
+    jacobi,
+
+    /// @brief Incomplete Cholesky factor with the sparsity of the matrix, IC(0)
+    ic0,
+
+    /// @brief One smoothed aggregation multigrid V-cycle
+    amg
+};
+
+/// @brief Settings of a PCG or multigrid solve
+struct PCG_Options_t
+{
+    /// @brief Preconditioner applied each iteration
+    Preconditioner_t preconditioner = Preconditioner_t::ic0;
+
+    /// @brief Stop once ||b - Ax|| / ||b|| falls below this
+    double tolerance = 1e-10;
+
+    /// @brief Stop after this many iterations even if not converged
+    size_t max_iterations = 1000;
+
+    /// @brief Hierarchy settings used by the amg preconditioner and multigridSolve()
+    AMG_Options_t amg;
+};
+
+/// @brief Convergence report of a PCG or multigrid solve
+struct PCG_Stats_t
+{
+    /// @brief Number of iterations run
+    size_t iterations = 0;
+
+    /// @brief Relative residual ||b - Ax|| / ||b|| of the solution
+    double residual = 0;
+
+    /// @brief Was the tolerance reached within the iteration limit
+    bool converged = true;
+};
+
+/// @brief Lower triangular factor in compressed sparse row form, the
+/// diagonal is the last entry of each row
+struct Incomplete_Cholesky_t
+{
+    /// @brief Start of each row in col_idx/values, (n + 1) long
+    std::vector<uint32_t> row_ptr;
+
+    /// @brief Column of each stored entry, sorted within each row
+    std::vector<uint32_t> col_idx;
+
+    /// @brief Value of each stored entry
+    std::vector<double> values;
+};
+
+///--------------------------------------------------------
+/// @brief Gets the command line name of a preconditioner
+///
+/// @param preconditioner preconditioner to name
+///
+/// @return name of the preconditioner
+std::string preconditionerName(const Preconditioner_t& preconditioner);
+
+///--------------------------------------------------------
+/// @brief Solves A*x = b by preconditioned conjugate gradients
+///
+/// @note Only the entries on and above the diagonal of A are read, A is
+/// taken to be symmetric
+///
+/// @param mat (n,n) symmetric positive definite sparse matrix
+/// @param rhs (n,1) right hand side
+/// @param options preconditioner, tolerance and iteration limit
+/// @param stats filled with the iteration count, residual and convergence
+///
+/// @return (n,1) solution, the last iterate if not converged
+///
+/// @throws std::invalid_argument if the dimensions do not match, a diagonal
+/// entry is not positive or the incomplete factorization breaks down
+Matrix<double> conjugateGradient(const Sparse_Matrix<double>& mat, const Matrix<double>& rhs, const PCG_Options_t& options,
+    PCG_Stats_t& stats);
+
+///--------------------------------------------------------
+/// @brief Solves A*x = b by repeated multigrid V-cycles
+///
+/// @note The preconditioner option is not used, each iteration is one V-cycle
+///
+/// @param mat (n,n) symmetric positive definite sparse matrix
+/// @param rhs (n,1) right hand side
+/// @param options tolerance, iteration limit and hierarchy settings
+/// @param stats filled with the iteration count, residual and convergence
+///
+/// @return (n,1) solution, the last iterate if not converged
+///
+/// @throws std::invalid_argument if the dimensions do not match or a diagonal entry is not positive
+Matrix<double> multigridSolve(const Sparse_Matrix<double>& mat, const Matrix<double>& rhs, const PCG_Options_t& options,
+    PCG_Stats_t& stats);
+
+///--------------------------------------------------------
+/// @brief Computes the IC(0) factor L, L*L' ~= A on the pattern of A
+///
+/// @note Row i of the lower triangle is column i of the upper triangle,
+/// so the CSC storage of A is read directly as CSR storage of L
+///
+/// @param mat symmetric positive definite matrix
+///
+/// @return incomplete factor
+///
+/// @throws std::invalid_argument if a pivot is not positive
+Incomplete_Cholesky_t incompleteCholesky(const Sparse_Matrix<double>& mat);
+
+///--------------------------------------------------------
+/// @brief Solves L*L'*z = r in place
+///
+/// @param factor incomplete factor L
+/// @param vec r on input, z on output
+void applyIncompleteCholesky(const Incomplete_Cholesky_t& factor, std::vector<double>& vec);
+
+///--------------------------------------------------------
+/// @brief Computes out = A*x
+///
+/// @param mat sparse matrix A
+/// @param x vector to multiply
+/// @param out result vector, resized to the row count of A
+void sparseMultiply(const Sparse_Matrix<double>& mat, const std::vector<double>& x, std::vector<double>& out);
+
+///--------------------------------------------------------
+/// @brief Dot product of two vectors of the same size
+///
+/// @param a first vector
+/// @param b second vector
+///
+/// @return sum of a[i] * b[i]
+double dotProduct(const std::vector<double>& a, const std::vector<double>& b);
@@ -0,0 +1,851 @@
+/// ------------------------------------------
+/// @file Supernodal_LU.h
+///
+/// @brief Header/Source file for a task parallel supernodal sparse LU factorization object
+///
+/// @note Must implement all functions upon definition due to template format
+/// ------------------------------------------
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include <memory>
+#include <queue>
+#include <cstdint>
+#include <algorithm>
+
+#include "Matrix.h"
+#include "Sparse_Matrix.h"
+#include "Sparse_Ordering.h"
+#include "Dense_Kernels.h"
+#include "Thread_Pool.h"
+
+/// @brief Supernodal sparse LU factorization on a nested dissection ordering, P*A*Q = L*U
+///
+/// @note Multifrontal: every node of the separator tree is a supernode, factored as a dense
+/// front holding its own unknowns and the later unknowns they couple to. What is left of
+/// the front once its own unknowns are eliminated is added into the parent's front.
+/// Sibling subtrees share no unknowns, so whole subtrees are factored as independent tasks
+/// with work stealing, then the few large separators at the top split their dense updates
+/// across the pool. Rows are only pivoted within a supernode, so a supernode whose own rows
+/// give no stable pivot (e.g. a node where an inductor and a capacitor resonate has a zero
+/// diagonal, its only other entry is in a later front) cannot be factored here and the
+/// matrix has to be factored with Sparse_LU instead
+///
+/// @tparam T double, Complex_C_t or any type the dense kernels accept
+template <typename T>
+class Supernodal_LU
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor for an empty factorization, analyze() and factor() must be called before solving
+        ///
+        /// @param threadCount number of worker threads, 0 uses the hardware thread count,
+        /// 1 factors on the calling thread
+        /// @param pivotTol diagonal is used as pivot if |diag| >= pivotTol * |largest in the supernode's column|
+        Supernodal_LU(const size_t& threadCount = 0, const double& pivotTol = 0.001)
+        {
+            m_pivot_tol = pivotTol;
+            if (threadCount != 1)
+            {
+                m_pool = std::make_unique<Thread_Pool>(threadCount);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Constructor, analyses and factors the given matrix
+        ///
+        /// @param mat square compressed matrix to factor
+        /// @param threadCount number of worker threads, 0 uses the hardware thread count,
+        /// 1 factors on the calling thread
+        /// @param pivotTol diagonal is used as pivot if |diag| >= pivotTol * |largest in the supernode's column|
+        ///
+        /// @throws std::invalid_argument if the matrix is not square, is singular or needs pivots
+        /// from outside a supernode
+        Supernodal_LU(const Sparse_Matrix<T>& mat, const size_t& threadCount = 0, const double& pivotTol = 0.001) :
+            Supernodal_LU(threadCount, pivotTol)
+        {
+            analyze(mat);
+            factor(mat);
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Orders the matrix by nested dissection, finds the rows of every front
+        /// and splits the separator tree into tasks
+        ///
+        /// @param mat square compressed matrix to analyse
+        ///
+        /// @throws std::invalid_argument if the matrix is not square
+        void analyze(const Sparse_Matrix<T>& mat)
+        {
+            if (mat.getRowCount() != mat.getColCount())
+            {
+                throw std::invalid_argument("Matrix must be square to be LU factored");
+            }
+
+            const std::vector<uint32_t>& colPtr = mat.getColPointers();
+            const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+            m_n = mat.getRowCount();
+            m_nnz = mat.getNonZeroCount();
+            m_perm = nestedDissectionOrdering(m_n, colPtr, rowIdx, m_tree);
+            m_factored = false;
+
+            std::vector<uint32_t> position(m_n);
+            for (size_t k = 0; k < m_n; k++)
+            {
+                position[m_perm[k]] = k;
+            }
+
+            const size_t nodes = m_tree.size();
+            std::vector<uint32_t> nodeOf(m_n);
+            m_child_ptr.assign(nodes + 1, 0);
+            for (size_t s = 0; s < nodes; s++)
+            {
+                std::fill(nodeOf.begin() + m_tree[s].begin, nodeOf.begin() + m_tree[s].end, s);
+                if (m_tree[s].parent != -1)
+                {
+                    m_child_ptr[m_tree[s].parent + 1]++;
+                }
+            }
+            for (size_t s = 0; s < nodes; s++)
+            {
+                m_child_ptr[s + 1] += m_child_ptr[s];
+            }
+            m_children.resize(m_child_ptr[nodes]);
+            std::vector<size_t> nextChild(m_child_ptr.begin(), m_child_ptr.end() - 1);
+            for (size_t s = 0; s < nodes; s++)
+            {
+                if (m_tree[s].parent != -1)
+                {
+                    m_children[nextChild[m_tree[s].parent]++] = s;
+                }
+            }
+
+            // Front rows are the supernode's own positions then the later positions they
+            // couple to, directly or through the front of a child
+            std::vector<std::vector<uint32_t>> adj = symmetricAdjacency(m_n, colPtr, rowIdx);
+            std::vector<size_t> mark(m_n, nodes);
+            m_row_ptr.assign(nodes + 1, 0);
+            m_value_ptr.assign(nodes + 1, 0);
+            m_relative_ptr.assign(nodes + 1, 0);
+            m_rows.clear();
+            m_relative.clear();
+            for (size_t s = 0; s < nodes; s++)
+            {
+                const uint32_t begin = m_tree[s].begin;
+                const uint32_t end = m_tree[s].end;
+                std::vector<uint32_t> later;
+                for (uint32_t k = begin; k < end; k++)
+                {
+                    for (uint32_t v : adj[m_perm[k]])
+                    {
+                        uint32_t pos = position[v];
+                        if (pos >= end and mark[pos] != s)
+                        {
+                            mark[pos] = s;
+                            later.push_back(pos);
+                        }
+                    }
+                }
+
+                for (size_t q = m_child_ptr[s]; q < m_child_ptr[s + 1]; q++)
+                {
+                    uint32_t c = m_children[q];
+                    size_t childPivots = m_tree[c].end - m_tree[c].begin;
+                    for (size_t r = m_row_ptr[c] + childPivots; r < m_row_ptr[c + 1]; r++)
+                    {
+                        uint32_t pos = m_rows[r];
+                        if (pos >= end and mark[pos] != s)
+                        {
+                            mark[pos] = s;
+                            later.push_back(pos);
+                        }
+                    }
+                }
+                std::sort(later.begin(), later.end());
+
+                for (uint32_t k = begin; k < end; k++)
+                {
+                    m_rows.push_back(k);
+                }
+                m_rows.insert(m_rows.end(), later.begin(), later.end());
+                m_row_ptr[s + 1] = m_rows.size();
+
+                const size_t pivots = end - begin;
+                const size_t size = m_row_ptr[s + 1] - m_row_ptr[s];
+                m_value_ptr[s + 1] = m_value_ptr[s] + pivots * size + (size - pivots) * pivots;
+                m_relative_ptr[s + 1] = m_relative_ptr[s] + (size - pivots);
+                m_relative.resize(m_relative_ptr[s + 1]);
+
+                // Where each row left in a child's front lands in this front
+                for (size_t q = m_child_ptr[s]; q < m_child_ptr[s + 1]; q++)
+                {
+                    uint32_t c = m_children[q];
+                    size_t childPivots = m_tree[c].end - m_tree[c].begin;
+                    for (size_t r = m_row_ptr[c] + childPivots; r < m_row_ptr[c + 1]; r++)
+                    {
+                        m_relative[m_relative_ptr[c] + r - m_row_ptr[c] - childPivots] = _local_row(s, m_rows[r]);
+                    }
+                }
+            }
+
+            // Each entry of A is assembled into the front of whichever of its row and column comes first
+            std::vector<uint32_t> entryNode(m_nnz);
+            std::vector<size_t> entryOffset(m_nnz);
+            m_entry_ptr.assign(nodes + 1, 0);
+            for (size_t j = 0; j < m_n; j++)
+            {
+                for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+                {
+                    uint32_t row = position[rowIdx[p]];
+                    uint32_t col = position[j];
+                    uint32_t s = nodeOf[std::min(row, col)];
+                    size_t size = m_row_ptr[s + 1] - m_row_ptr[s];
+                    entryNode[p] = s;
+                    entryOffset[p] = _local_row(s, row) * size + _local_row(s, col);
+                    m_entry_ptr[s + 1]++;
+                }
+            }
+            for (size_t s = 0; s < nodes; s++)
+            {
+                m_entry_ptr[s + 1] += m_entry_ptr[s];
+            }
+            m_entries.resize(m_nnz);
+            m_entry_offset.resize(m_nnz);
+            std::vector<size_t> nextEntry(m_entry_ptr.begin(), m_entry_ptr.end() - 1);
+            for (size_t p = 0; p < m_nnz; p++)
+            {
+                size_t slot = nextEntry[entryNode[p]]++;
+                m_entries[slot] = p;
+                m_entry_offset[slot] = entryOffset[p];
+            }
+
+            _schedule();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Numerically factors the matrix using the analysis from analyze()
+        ///
+        /// @param mat square compressed matrix with the same pattern as the analysed matrix
+        ///
+        /// @throws std::invalid_argument if the pattern differs, the matrix is singular or a
+        /// supernode has no row that is a stable pivot
+        void factor(const Sparse_Matrix<T>& mat)
+        {
+            if (mat.getRowCount() != m_n or mat.getColCount() != m_n or mat.getNonZeroCount() != m_nnz or
+                m_row_ptr.size() != m_tree.size() + 1)
+            {
+                throw std::invalid_argument("Supernodal LU must be analysed with a matrix of the same pattern before factoring");
+            }
+
+            const std::vector<T>& aValues = mat.getValues();
+            const size_t nodes = m_tree.size();
+            m_factored = false;
+            m_values.assign(m_value_ptr[nodes], (T) 0);
+            m_pivots.assign(m_n, 0);
+
+            // Remainder of each front, waiting to be added into its parent
+            std::vector<std::vector<T>> updates(nodes);
+
+            if (!m_pool)
+            {
+                for (size_t s = 0; s < nodes; s++)
+                {
+                    _factor_front(s, aValues, updates, nullptr);
+                }
+                m_factored = true;
+                return;
+            }
+
+            // A task factors its whole subtree in postorder, subtrees vary widely in size
+            m_pool->parallelForStealing(0, m_task_roots.size(), [&](size_t t)
+            {
+                uint32_t root = m_task_roots[t];
+                for (size_t s = m_first[root]; s <= root; s++)
+                {
+                    _factor_front(s, aValues, updates, nullptr);
+                }
+            });
+
+            // Separators above the tasks, a lone front splits its dense update across the pool instead
+            for (size_t w = 0; w + 1 < m_wave_ptr.size(); w++)
+            {
+                size_t first = m_wave_ptr[w];
+                size_t count = m_wave_ptr[w + 1] - first;
+                if (count == 1)
+                {
+                    _factor_front(m_waves[first], aValues, updates, m_pool.get());
+                    continue;
+                }
+
+                m_pool->parallelForStealing(0, count, [&](size_t k)
+                {
+                    _factor_front(m_waves[first + k], aValues, updates, nullptr);
+                });
+            }
+
+            m_factored = true;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves A*X = B using the computed factor
+        ///
+        /// @param rhs (n,k) matrix B
+        ///
+        /// @return (n,k) matrix X
+        ///
+        /// @throws std::invalid_argument if not factored or the rhs has the wrong row count
+        Matrix<T> solve(const Matrix<T>& rhs) const
+        {
+            if (!m_factored or rhs.getRowCount() != m_n)
+            {
+                throw std::invalid_argument("Supernodal LU solve requires a factored matrix with the same row count as the rhs");
+            }
+
+            size_t rhsCols = rhs.getColCount();
+            Matrix<T> x(m_n, rhsCols);
+            const T* rhsData = rhs.get_data();
+            T* xData = x.get_data();
+            std::vector<T> work(m_n * std::min(rhsCols, solve_block));
+
+            for (size_t c0 = 0; c0 < rhsCols; c0 += solve_block)
+            {
+                size_t block = std::min(solve_block, rhsCols - c0);
+                for (size_t k = 0; k < m_n; k++)
+                {
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        work[k * block + c] = rhsData[m_perm[k] * rhsCols + c0 + c];
+                    }
+                }
+
+                _solve_in_place(work.data(), block);
+
+                for (size_t k = 0; k < m_n; k++)
+                {
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        xData[m_perm[k] * rhsCols + c0 + c] = work[k * block + c];
+                    }
+                }
+            }
+
+            return x;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of stored entries in L and U combined, including
+        /// the explicit zeros of the dense fronts
+        ///
+        /// @return number of stored factor entries
+        size_t getFactorNonZeroCount() const
+        {
+            return m_values.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of supernodes, the nodes of the separator tree
+        ///
+        /// @return number of supernodes
+        size_t getSupernodeCount() const
+        {
+            return m_tree.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of independent subtrees factored as tasks
+        ///
+        /// @return number of subtree tasks, 0 when factoring on the calling thread
+        size_t getSubtreeTaskCount() const
+        {
+            return m_task_roots.size();
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of threads the factorization runs on
+        ///
+        /// @return number of worker threads, 1 when factoring on the calling thread
+        size_t getThreadCount() const
+        {
+            return m_pool ? m_pool->getThreadCount() : 1;
+        };
+
+    private:
+        /// @brief Columns eliminated together in a front before its trailing update
+        static constexpr size_t front_block = 64;
+
+        /// @brief Rows and columns of the trailing update tiles
+        static constexpr size_t front_tile = 256;
+
+        /// @brief Subtree tasks made per worker, spare tasks let idle workers steal
+        static constexpr size_t tasks_per_thread = 4;
+
+        /// @brief Number of right hand side columns solved together
+        static constexpr size_t solve_block = 16;
+
+        /// @brief Side length of the factored matrix
+        size_t m_n = 0;
+
+        /// @brief Number of stored entries of the analysed matrix
+        size_t m_nnz = 0;
+
+        /// @brief diagonal is used as pivot if |diag| >= m_pivot_tol * |largest in the supernode's column|
+        double m_pivot_tol;
+
+        /// @brief Has factor() completed
+        bool m_factored = false;
+
+        /// @brief Nested dissection order, entry k is the unknown eliminated at step k
+        std::vector<uint32_t> m_perm;
+
+        /// @brief Separator tree in postorder, one supernode per node
+        std::vector<Dissection_Node_t> m_tree;
+
+        /// @brief Children of every supernode, CSR
+        std::vector<size_t> m_child_ptr;
+        std::vector<uint32_t> m_children;
+
+        /// @brief Positions of the rows of every front, the supernode's own first then in increasing order
+        std::vector<size_t> m_row_ptr;
+        std::vector<uint32_t> m_rows;
+
+        /// @brief Front row each leftover row of a supernode is added into in its parent
+        std::vector<size_t> m_relative_ptr;
+        std::vector<uint32_t> m_relative;
+
+        /// @brief Entries of A assembled into each front, and their offset in the front
+        std::vector<size_t> m_entry_ptr;
+        std::vector<size_t> m_entries;
+        std::vector<size_t> m_entry_offset;
+
+        /// @brief Factor of every supernode: its (pivots, size) rows of U with the unit L11 packed
+        /// below the diagonal, then the (size - pivots, pivots) rows of L21, all row major
+        std::vector<size_t> m_value_ptr;
+        std::vector<T> m_values;
+
+        /// @brief Front row swapped with row i of the same front at step i, by position
+        std::vector<uint32_t> m_pivots;
+
+        /// @brief First supernode of the subtree below every supernode
+        std::vector<uint32_t> m_first;
+
+        /// @brief Roots of the subtrees factored as tasks, largest first
+        std::vector<uint32_t> m_task_roots;
+
+        /// @brief Supernodes above the tasks grouped into waves, each only depends on earlier waves
+        std::vector<size_t> m_wave_ptr;
+        std::vector<uint32_t> m_waves;
+
+        /// @brief Workers for the subtree tasks, null when factoring on the calling thread
+        std::unique_ptr<Thread_Pool> m_pool;
+
+        ///--------------------------------------------------------
+        /// @brief Finds the row of a front holding a position
+        ///
+        /// @param s supernode
+        /// @param pos position in the ordering, must be a row of the front
+        ///
+        /// @return row of the front
+        uint32_t _local_row(const size_t& s, const uint32_t& pos) const
+        {
+            const uint32_t* first = m_rows.data() + m_row_ptr[s];
+            const uint32_t* last = m_rows.data() + m_row_ptr[s + 1];
+            return std::lower_bound(first, last, pos) - first;
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Splits the separator tree into subtree tasks and waves of the supernodes above them
+        ///
+        /// @note The most expensive subtree is split into its children until there are
+        /// tasks_per_thread tasks per worker, the split off roots are left for the waves
+        void _schedule()
+        {
+            const size_t nodes = m_tree.size();
+            std::vector<double> cost(nodes, 0);
+            m_first.resize(nodes);
+            for (size_t s = 0; s < nodes; s++)
+            {
+                m_first[s] = s;
+            }
+
+            for (size_t s = 0; s < nodes; s++)
+            {
+                double pivots = m_tree[s].end - m_tree[s].begin;
+                double size = m_row_ptr[s + 1] - m_row_ptr[s];
+                cost[s] += pivots * size * size;
+                if (m_tree[s].parent != -1)
+                {
+                    cost[m_tree[s].parent] += cost[s];
+                    m_first[m_tree[s].parent] = std::min(m_first[m_tree[s].parent], m_first[s]);
+                }
+            }
+
+            m_task_roots.clear();
+            m_wave_ptr.assign(1, 0);
+            m_waves.clear();
+            if (!m_pool)
+            {
+                return;
+            }
+
+            std::vector<char> above(nodes, 0);
+            std::priority_queue<std::pair<double, uint32_t>> open;
+            for (size_t s = 0; s < nodes; s++)
+            {
+                if (m_tree[s].parent == -1)
+                {
+                    open.push({cost[s], s});
+                }
+            }
+
+            size_t target = tasks_per_thread * m_pool->getThreadCount();
+            while (!open.empty() and open.size() + m_task_roots.size() < target)
+            {
+                uint32_t s = open.top().second;
+                open.pop();
+                if (m_child_ptr[s] == m_child_ptr[s + 1])
+                {
+                    m_task_roots.push_back(s);
+                    continue;
+                }
+
+                above[s] = 1;
+                for (size_t q = m_child_ptr[s]; q < m_child_ptr[s + 1]; q++)
+                {
+                    open.push({cost[m_children[q]], m_children[q]});
+                }
+            }
+            for (; !open.empty(); open.pop())
+            {
+                m_task_roots.push_back(open.top().second);
+            }
+            std::stable_sort(m_task_roots.begin(), m_task_roots.end(), [&](const uint32_t& a, const uint32_t& b)
+            {
+                return cost[a] > cost[b];
+            });
+
+            // A supernode above the tasks waits for the waves of its children above the tasks
+            std::vector<size_t> wave(nodes, 0);
+            size_t waveCount = 0;
+            for (size_t s = 0; s < nodes; s++)
+            {
+                if (!above[s])
+                {
+                    continue;
+                }
+
+                for (size_t q = m_child_ptr[s]; q < m_child_ptr[s + 1]; q++)
+                {
+                    if (above[m_children[q]])
+                    {
+                        wave[s] = std::max(wave[s], wave[m_children[q]] + 1);
+                    }
+                }
+                waveCount = std::max(waveCount, wave[s] + 1);
+            }
+
+            m_wave_ptr.assign(waveCount + 1, 0);
+            for (size_t s = 0; s < nodes; s++)
+            {
+                if (above[s])
+                {
+                    m_wave_ptr[wave[s] + 1]++;
+                }
+            }
+            for (size_t w = 0; w < waveCount; w++)
+            {
+                m_wave_ptr[w + 1] += m_wave_ptr[w];
+            }
+            m_waves.resize(m_wave_ptr[waveCount]);
+            std::vector<size_t> nextSlot(m_wave_ptr.begin(), m_wave_ptr.end() - 1);
+            for (size_t s = 0; s < nodes; s++)
+            {
+                if (above[s])
+                {
+                    m_waves[nextSlot[wave[s]]++] = s;
+                }
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Assembles and partially factors the front of one supernode, its
+        /// children must already be factored
+        ///
+        /// @param s supernode
+        /// @param aValues values of A
+        /// @param updates leftover part of every factored front, the children's are
+        /// consumed and this supernode's is stored
+        /// @param pool splits the trailing updates across workers, null runs them on the calling thread
+        ///
+        /// @throws std::invalid_argument if a column has no non-zero pivot within the supernode
+        void _factor_front(const size_t& s, const std::vector<T>& aValues, std::vector<std::vector<T>>& updates,
+            Thread_Pool* pool)
+        {
+            const size_t m = m_row_ptr[s + 1] - m_row_ptr[s];
+            const size_t pivots = m_tree[s].end - m_tree[s].begin;
+            const size_t rest = m - pivots;
+            std::vector<T> front(m * m, (T) 0);
+
+            for (size_t q = m_entry_ptr[s]; q < m_entry_ptr[s + 1]; q++)
+            {
+                front[m_entry_offset[q]] = front[m_entry_offset[q]] + aValues[m_entries[q]];
+            }
+
+            for (size_t q = m_child_ptr[s]; q < m_child_ptr[s + 1]; q++)
+            {
+                uint32_t c = m_children[q];
+                const uint32_t* relative = m_relative.data() + m_relative_ptr[c];
+                const size_t childRest = m_relative_ptr[c + 1] - m_relative_ptr[c];
+                const std::vector<T>& update = updates[c];
+                for (size_t i = 0; i < childRest; i++)
+                {
+                    T* row = front.data() + relative[i] * m;
+                    for (size_t j = 0; j < childRest; j++)
+                    {
+                        row[relative[j]] = row[relative[j]] + update[i * childRest + j];
+                    }
+                }
+                std::vector<T>().swap(updates[c]);
+            }
+
+            T* f = front.data();
+            uint32_t* swaps = m_pivots.data() + m_tree[s].begin;
+            std::vector<T> lower;
+            std::vector<T> upper;
+            for (size_t k0 = 0; k0 < pivots; k0 += front_block)
+            {
+                const size_t k1 = std::min(k0 + front_block, pivots);
+                const size_t width = k1 - k0;
+
+                for (size_t c = k0; c < k1; c++)
+                {
+                    // Only the supernode's own rows can be pivots, the rest belong to later fronts
+                    size_t pivotRow = c;
+                    double pivotMag = 0;
+                    for (size_t i = c; i < pivots; i++)
+                    {
+                        double mag = absoluteValue(f[i * m + c]);
+                        if (mag > pivotMag)
+                        {
+                            pivotMag = mag;
+                            pivotRow = i;
+                        }
+                    }
+
+                    // A pivot much smaller than the later rows of its column would blow up the update
+                    double restMag = 0;
+                    for (size_t i = pivots; i < m; i++)
+                    {
+                        restMag = std::max(restMag, absoluteValue(f[i * m + c]));
+                    }
+
+                    if (pivotMag == 0 or pivotMag < m_pivot_tol * restMag)
+                    {
+                        throw std::invalid_argument("No stable pivot within a supernode, the matrix needs pivoting across supernodes");
+                    }
+
+                    if (absoluteValue(f[c * m + c]) >= m_pivot_tol * pivotMag)
+                    {
+                        pivotRow = c;
+                    }
+
+                    swaps[c] = pivotRow;
+                    if (pivotRow != c)
+                    {
+                        std::swap_ranges(f + c * m, f + c * m + m, f + pivotRow * m);
+                    }
+
+                    T pivot = f[c * m + c];
+                    for (size_t i = c + 1; i < m; i++)
+                    {
+                        if (f[i * m + c] == 0)
+                        {
+                            continue;
+                        }
+
+                        T l = f[i * m + c] / pivot;
+                        f[i * m + c] = l;
+                        for (size_t j = c + 1; j < k1; j++)
+                        {
+                            f[i * m + j] = f[i * m + j] - l * f[c * m + j];
+                        }
+                    }
+                }
+
+                if (k1 == m)
+                {
+                    break;
+                }
+
+                // Rows of U right of the block
+                const size_t trail = m - k1;
+                for (size_t r = k0 + 1; r < k1; r++)
+                {
+                    T* row = f + r * m + k1;
+                    for (size_t p = k0; p < r; p++)
+                    {
+                        T l = f[r * m + p];
+                        if (l == 0)
+                        {
+                            continue;
+                        }
+
+                        const T* above = f + p * m + k1;
+                        for (size_t j = 0; j < trail; j++)
+                        {
+                            row[j] = row[j] - l * above[j];
+                        }
+                    }
+                }
+
+                lower.resize(trail * width);
+                upper.resize(width * trail);
+                for (size_t i = 0; i < trail; i++)
+                {
+                    for (size_t p = 0; p < width; p++)
+                    {
+                        lower[i * width + p] = (T) 0 - f[(k1 + i) * m + k0 + p];
+                    }
+                }
+                for (size_t p = 0; p < width; p++)
+                {
+                    std::copy_n(f + (k0 + p) * m + k1, trail, upper.data() + p * trail);
+                }
+
+                // Tiles are fixed so the result does not depend on how many workers ran them
+                size_t tileCount = (trail + front_tile - 1) / front_tile;
+                auto updateTile = [&](size_t t)
+                {
+                    size_t r0 = (t / tileCount) * front_tile;
+                    size_t c0 = (t % tileCount) * front_tile;
+                    size_t rows = std::min(front_tile, trail - r0);
+                    size_t cols = std::min(front_tile, trail - c0);
+
+                    std::vector<T> tile(rows * cols);
+                    for (size_t i = 0; i < rows; i++)
+                    {
+                        std::copy_n(f + (k1 + r0 + i) * m + k1 + c0, cols, tile.data() + i * cols);
+                    }
+
+                    std::vector<T> upperTile(width * cols);
+                    for (size_t p = 0; p < width; p++)
+                    {
+                        std::copy_n(upper.data() + p * trail + c0, cols, upperTile.data() + p * cols);
+                    }
+                    denseMultiply(rows, width, cols, lower.data() + r0 * width, upperTile.data(), tile.data());
+
+                    for (size_t i = 0; i < rows; i++)
+                    {
+                        std::copy_n(tile.data() + i * cols, cols, f + (k1 + r0 + i) * m + k1 + c0);
+                    }
+                };
+
+                if (pool and tileCount > 1)
+                {
+                    pool->parallelFor(0, tileCount * tileCount, updateTile);
+                }
+                else
+                {
+                    for (size_t t = 0; t < tileCount * tileCount; t++)
+                    {
+                        updateTile(t);
+                    }
+                }
+            }
+
+            T* factor = m_values.data() + m_value_ptr[s];
+            std::copy_n(f, pivots * m, factor);
+            for (size_t i = 0; i < rest; i++)
+            {
+                std::copy_n(f + (pivots + i) * m, pivots, factor + pivots * m + i * pivots);
+            }
+
+            updates[s].resize(rest * rest);
+            for (size_t i = 0; i < rest; i++)
+            {
+                std::copy_n(f + (pivots + i) * m + pivots, rest, updates[s].data() + i * rest);
+            }
+        };
+
+        ///--------------------------------------------------------
+        /// @brief Solves L*U*Y = B in place for a block of right hand sides
+        /// where B is already in elimination order
+        ///
+        /// @param work (n, block) row major rhs, overwritten with the solution in elimination order
+        /// @param block number of right hand sides held in work
+        void _solve_in_place(T* work, const size_t& block) const
+        {
+            const size_t nodes = m_tree.size();
+            for (size_t s = 0; s < nodes; s++)
+            {
+                const size_t m = m_row_ptr[s + 1] - m_row_ptr[s];
+                const size_t begin = m_tree[s].begin;
+                const size_t pivots = m_tree[s].end - begin;
+                const uint32_t* rows = m_rows.data() + m_row_ptr[s];
+                const T* factor = m_values.data() + m_value_ptr[s];
+
+                // L was stored with every swap of the supernode already applied to its rows
+                for (size_t k = 0; k < pivots; k++)
+                {
+                    if (m_pivots[begin + k] != k)
+                    {
+                        std::swap_ranges(work + (begin + k) * block, work + (begin + k + 1) * block,
+                            work + (begin + m_pivots[begin + k]) * block);
+                    }
+                }
+
+                for (size_t k = 0; k < pivots; k++)
+                {
+                    const T* yk = work + (begin + k) * block;
+                    for (size_t i = k + 1; i < m; i++)
+                    {
+                        T l = (i < pivots) ? factor[i * m + k] : factor[pivots * m + (i - pivots) * pivots + k];
+                        if (l == 0)
+                        {
+                            continue;
+                        }
+
+                        T* yi = work + rows[i] * block;
+                        for (size_t c = 0; c < block; c++)
+                        {
+                            yi[c] = yi[c] - l * yk[c];
+                        }
+                    }
+                }
+            }
+
+            for (size_t s = nodes; s-- > 0;)
+            {
+                const size_t m = m_row_ptr[s + 1] - m_row_ptr[s];
+                const size_t begin = m_tree[s].begin;
+                const size_t pivots = m_tree[s].end - begin;
+                const uint32_t* rows = m_rows.data() + m_row_ptr[s];
+                const T* factor = m_values.data() + m_value_ptr[s];
+
+                for (size_t k = pivots; k-- > 0;)
+                {
+                    T* yk = work + (begin + k) * block;
+                    for (size_t j = k + 1; j < m; j++)
+                    {
+                        T u = factor[k * m + j];
+                        if (u == 0)
+                        {
+                            continue;
+                        }
+
+                        const T* yj = work + rows[j] * block;
+                        for (size_t c = 0; c < block; c++)
+                        {
+                            yk[c] = yk[c] - u * yj[c];
+                        }
+                    }
+
+                    T diag = factor[k * m + k];
+                    for (size_t c = 0; c < block; c++)
+                    {
+                        yk[c] = yk[c] / diag;
+                    }
+                }
+            }
+        };
+};
@@ -0,0 +1,95 @@
+/// ------------------------------------------
+/// @file Thread_Pool.h
+///
+/// @brief Header for a fixed size pool of worker threads
+/// ------------------------------------------
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+
+/// @brief Pool of worker threads that run submitted tasks in submission order
+class Thread_Pool
+{
+    public:
+        ///--------------------------------------------------------
+        /// @brief Constructor, starts the worker threads
+        ///
+        /// @param threadCount number of workers, 0 uses the hardware thread count
+        Thread_Pool(const size_t& threadCount = 0);
+
+        ///--------------------------------------------------------
+        /// @brief Destructor, finishes all queued tasks then joins the workers
+        ~Thread_Pool();
+
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        ///--------------------------------------------------------
+        /// @brief Queues a task to be run on a worker
+        ///
+        /// @param task function to run
+        ///
+        /// @return future that is ready once the task has run, holds any thrown exception
+        std::future<void> submit(std::function<void()> task);
+
+        ///--------------------------------------------------------
+        /// @brief Runs body(i) for every i in [begin, end) split across the workers,
+        /// returns once all calls are complete
+        ///
+        /// @note Must not be called from inside a task on the same pool
+        ///
+        /// @param begin first index
+        /// @param end one past the last index
+        /// @param body function to call for each index
+        ///
+        /// @throws the first exception thrown by any call of body
+        void parallelFor(const size_t& begin, const size_t& end, const std::function<void(size_t)>& body);
+
+        ///--------------------------------------------------------
+        /// @brief Runs body(i) for every i in [begin, end) with work stealing, returns
+        /// once all calls are complete
+        ///
+        /// @note For calls of very uneven cost. Each worker starts with a contiguous
+        /// range, and once it runs out takes the back half of another worker's range.
+        /// Must not be called from inside a task on the same pool
+        ///
+        /// @param begin first index
+        /// @param end one past the last index
+        /// @param body function to call for each index
+        ///
+        /// @throws the first exception thrown by any call of body, the rest of that
+        /// worker's range may then be skipped
+        void parallelForStealing(const size_t& begin, const size_t& end, const std::function<void(size_t)>& body);
+
+        ///--------------------------------------------------------
+        /// @brief Get the number of worker threads
+        ///
+        /// @return number of worker threads
+        size_t getThreadCount() const;
+
+    private:
+        /// @brief Worker threads
+        std::vector<std::thread> m_workers;
+
+        /// @brief Tasks waiting for a worker
+        std::queue<std::packaged_task<void()>> m_tasks;
+
+        /// @brief Guards m_tasks and m_stopping
+        std::mutex m_mutex;
+
+        /// @brief Signalled when a task is queued or the pool is stopping
+        std::condition_variable m_task_ready;
+
+        /// @brief Set when the pool is being destroyed
+        bool m_stopping = false;
+
+        ///--------------------------------------------------------
+        /// @brief Loop run by every worker, takes tasks until the pool stops
+        void _worker_loop();
+};
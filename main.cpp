@@ -5,49 +5,333 @@
 /// ------------------------------------------
 
 #include <iostream>
+#include <map>
+#include <filesystem>
 
 #include "inc/Complex.h"
 #include "inc/Matrix.h"
 #include "inc/Nodal_Analysis.h"
+#include "inc/DC_Session.h"
+#include "inc/Batch_Analysis.h"
+#include "inc/Netlist_Reduction.h"
 
 using std::cout;
 using std::endl;
 
+///--------------------------------------------------------
+/// @brief Reports the conditioning of a direct solve on stderr, with a warning
+/// once rounding may have cost most of the digits of the voltages
+///
+/// @param diagnostics condition estimate and pivot growth of the solve
+void printDiagnostics(const Solve_Diagnostics_t& diagnostics)
+{
+    std::cerr << "Condition estimate: " << diagnostics.condition_estimate <<
+        ", pivot growth: " << diagnostics.pivot_growth << endl;
+    if (diagnostics.condition_estimate > 1e12)
+    {
+        std::cerr << "Warning: system is nearly singular, voltages may be inaccurate" << endl;
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Reports how far a netlist was collapsed before solving on stderr
+///
+/// @param reduction collapsed netlist and its counts
+void printReduction(const Netlist_Reduction_t& reduction)
+{
+    std::cerr << "Graph reduction: " << reduction.netlist.node_names.size() << " of " << reduction.node_names.size() <<
+        " nodes kept (" << reduction.parallel_merges << " parallel merges, " << reduction.series_merges <<
+        " series nodes, " << reduction.pruned_nodes << " dangling nodes)" << endl;
+}
+
+///--------------------------------------------------------
+/// @brief Builds the settings of a domain decomposition solve from the command line options
+///
+/// @param options parsed key=value options
+/// @param node_names names of every node in the network, order of a read partition
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return partition read from the partition file, or automatic, and thread count
+Domain_Options_t domainOptions(std::map<std::string, std::string>& options, const std::vector<std::string>& node_names,
+    const size_t& threadCount)
+{
+    Domain_Options_t domainOptions;
+    if (options.count("partition"))
+    {
+        domainOptions.node_domains = readPartitionFile(options["partition"], node_names);
+    }
+    if (options.count("domains"))
+    {
+        domainOptions.domain_count = std::stoul(options["domains"]);
+    }
+    domainOptions.thread_count = threadCount;
+
+    return domainOptions;
+}
+
+///--------------------------------------------------------
+/// @brief Reports the partition of a domain decomposition solve
+///
+/// @param stats number of subdomains and interface unknowns
+void printDomains(const Domain_Stats_t& stats)
+{
+    cout << "Solver: schur, subdomains: " << stats.domain_count << ", interface unknowns: " << stats.interface_size << endl;
+}
+
 int main(int argc, char *argv[])
 {
-    if (argc != 3)
+    if (argc < 3)
     {
-        cout << "Arguments: [type A/D] [filepath]" << endl;
+        cout << "Arguments: [type A/D/S/M/T/U/B] [filepath] ([excitation filepath] for type M, [edit filepath] for type U, " <<
+            "manifest or directory for type B) " <<
+            "(solver=lu|dense-lu|islands|nested|schur|pcg-jacobi|pcg-ic0|pcg-amg|amg tol=1e-10 maxit=1000 threads=0 for type D, " <<
+            "solver=lu|dense-lu|islands|nested|schur|mixed-lu tol=1e-13 maxit=20 threads=0 for type A, reduce=off|on for types D and A, " <<
+            "partition=[partition filepath] domains=0 for solver=schur, " <<
+            "type=D|A threads=0 for type B)" << endl;
         return EXIT_FAILURE;
     }
 
     std::string inpFile(argv[2]);
 
+    // Arguments after the file path are either further file paths or key=value options
+    std::vector<std::string> extraFiles;
+    std::map<std::string, std::string> options = {{"solver", "lu"}};
+    for (int i = 3; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        size_t equals = arg.find('=');
+        if (equals == std::string::npos)
+        {
+            extraFiles.push_back(arg);
+            continue;
+        }
+
+        std::string key = arg.substr(0, equals);
+        if (key != "solver" and key != "tol" and key != "maxit" and key != "threads" and key != "type" and key != "reduce" and
+            key != "partition" and key != "domains")
+        {
+            cout << "Unknown option: " + key << endl;
+            return EXIT_FAILURE;
+        }
+        options[key] = arg.substr(equals + 1);
+    }
+
+    std::string solver = options["solver"];
+    if (solver != "lu" and solver != "dense-lu" and solver != "islands" and solver != "nested" and solver != "schur" and
+        solver != "mixed-lu" and solver != "pcg-jacobi" and solver != "pcg-ic0" and solver != "pcg-amg" and solver != "amg")
+    {
+        cout << "Unknown solver: " + solver << endl;
+        return EXIT_FAILURE;
+    }
+
     std::string anaylsis_type(argv[1]);
+    size_t threadCount = options.count("threads") ? std::stoul(options["threads"]) : 0;
+
+    bool reduceGraph = options.count("reduce") and options["reduce"] == "on";
+    if (options.count("reduce") and options["reduce"] != "on" and options["reduce"] != "off")
+    {
+        cout << "Unknown reduce setting: " + options["reduce"] << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (reduceGraph and anaylsis_type != "D" and anaylsis_type != "A")
+    {
+        cout << "Graph reduction is only available for types D and A" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((solver == "dense-lu" or solver == "islands" or solver == "nested" or solver == "schur") and anaylsis_type != "D" and anaylsis_type != "A")
+    {
+        cout << "Solver: " + solver + " is only available for types D and A" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if ((options.count("partition") or options.count("domains")) and solver != "schur")
+    {
+        cout << "Partition options are only used by solver: schur" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (options.count("partition") and reduceGraph)
+    {
+        cout << "A partition file names the nodes of the full netlist, it cannot be used with reduce=on" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (solver == "mixed-lu" and anaylsis_type != "A")
+    {
+        cout << "Solver: " + solver + " is only available for type A" << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (solver != "lu" and solver != "dense-lu" and solver != "islands" and solver != "nested" and solver != "schur" and
+        solver != "mixed-lu" and anaylsis_type != "D")
+    {
+        cout << "Solver: " + solver + " is only available for type D" << endl;
+        return EXIT_FAILURE;
+    }
 
     if (anaylsis_type == "A")
     {
-        Nodal_Analysis_AC_t analysis = readACAnalysisFile(inpFile);
+        // Parallel, series and dangling elements are collapsed before stamping
+        Netlist_Reduction_t graph;
+        if (reduceGraph)
+        {
+            graph = reduceNetlist(readNetlistFile(inpFile, 1), "RLC");
+            printReduction(graph);
+        }
+        Nodal_Analysis_AC_t analysis = reduceGraph ? compileACAnalysis(graph.netlist) : readACAnalysisFile(inpFile);
 
         cout << "Addmitance mat: " << endl << analysis.admittance_mat << endl;
         cout << "Net currents: " << endl << analysis.net_currents << endl;
 
-        auto results = ACNodalAnalysis(analysis);
+        std::vector<std::pair<std::string, Complex_C_t>> results;
+        if (solver == "dense-lu")
+        {
+            results = ACDenseNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "islands")
+        {
+            results = ACIslandNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "nested")
+        {
+            results = ACDissectionNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "schur")
+        {
+            Domain_Stats_t stats;
+            results = ACDomainNodalAnalysis(analysis, domainOptions(options, analysis.node_names, threadCount), stats);
+            printDomains(stats);
+        }
+        else if (solver == "mixed-lu")
+        {
+            Refinement_Options_t refineOptions;
+            if (options.count("tol"))
+            {
+                refineOptions.tolerance = std::stod(options["tol"]);
+            }
+            if (options.count("maxit"))
+            {
+                refineOptions.max_iterations = std::stoul(options["maxit"]);
+            }
+            refineOptions.thread_count = threadCount;
+
+            Refinement_Stats_t stats;
+            results = ACMixedNodalAnalysis(analysis, refineOptions, stats);
+
+            cout << "Solver: mixed-lu, refinement steps: " << stats.iterations <<
+                ", backward error: " << stats.backward_error << endl;
+            if (stats.double_fallback)
+            {
+                cout << "Warning: single precision factor did not converge, solved in double precision" << endl;
+            }
+        }
+        else
+        {
+            Solve_Diagnostics_t diagnostics;
+            results = ACNodalAnalysis(analysis, diagnostics);
+            printDiagnostics(diagnostics);
+        }
+
+        if (reduceGraph)
+        {
+            results = restoreNodeVoltages(graph, results);
+        }
 
         cout << "Voltages:" << endl;
         for (auto res : results)
         {
-            cout << res.first << ": " << res.second << endl;
+            cout << res.first << ": " << cartToPolar(res.second) << endl;
         }
     }
     else if (anaylsis_type == "D")
     {
-        Nodal_Analysis_DC_t analysis = readDCAnalysisFile(inpFile);
+        Netlist_Reduction_t graph;
+        if (reduceGraph)
+        {
+            graph = reduceNetlist(readNetlistFile(inpFile, 0), "R");
+            printReduction(graph);
+        }
+        Nodal_Analysis_DC_t analysis = reduceGraph ? compileDCAnalysis(graph.netlist) : readDCAnalysisFile(inpFile);
 
         cout << "Addmitance mat: " << endl << analysis.conductance_mat << endl;
         cout << "Net currents: " << endl << analysis.net_currents << endl;
 
-        auto results = DCNodalAnalysis(analysis);
+        std::vector<std::pair<std::string, double>> results;
+        if (solver == "lu")
+        {
+            Solve_Diagnostics_t diagnostics;
+            results = DCNodalAnalysis(analysis, diagnostics);
+            printDiagnostics(diagnostics);
+        }
+        else if (solver == "dense-lu")
+        {
+            results = DCDenseNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "islands")
+        {
+            results = DCIslandNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "nested")
+        {
+            results = DCDissectionNodalAnalysis(analysis, threadCount);
+        }
+        else if (solver == "schur")
+        {
+            Domain_Stats_t stats;
+            results = DCDomainNodalAnalysis(analysis, domainOptions(options, analysis.node_names, threadCount), stats);
+            printDomains(stats);
+        }
+        else
+        {
+            PCG_Options_t pcgOptions;
+            if (solver == "pcg-jacobi")
+            {
+                pcgOptions.preconditioner = Preconditioner_t::jacobi;
+            }
+            else if (solver == "pcg-amg")
+            {
+                pcgOptions.preconditioner = Preconditioner_t::amg;
+            }
+            else
+            {
+                pcgOptions.preconditioner = Preconditioner_t::ic0;
+            }
+
+            if (options.count("tol"))
+            {
+                pcgOptions.tolerance = std::stod(options["tol"]);
+            }
+            if (options.count("maxit"))
+            {
+                pcgOptions.max_iterations = std::stoul(options["maxit"]);
+            }
+            pcgOptions.amg.thread_count = threadCount;
+
+            PCG_Stats_t stats;
+            if (solver == "amg")
+            {
+                results = DCMultigridNodalAnalysis(analysis, pcgOptions, stats);
+                cout << "Solver: amg";
+            }
+            else
+            {
+                results = DCIterativeNodalAnalysis(analysis, pcgOptions, stats);
+                cout << "Solver: pcg (" << preconditionerName(pcgOptions.preconditioner) << ")";
+            }
+
+            cout << ", iterations: " << stats.iterations << ", residual: " << stats.residual << endl;
+            if (!stats.converged)
+            {
+                cout << "Warning: did not converge to a residual of " << pcgOptions.tolerance << endl;
+            }
+        }
+
+        if (reduceGraph)
+        {
+            results = restoreNodeVoltages(graph, results);
+        }
 
         cout << "Voltages:" << endl;
         for (auto res : results)
@@ -55,6 +339,149 @@ int main(int argc, char *argv[])
             cout << res.first << ": " << res.second << endl;
         }
     }
+    else if (anaylsis_type == "S")
+    {
+        Nodal_Analysis_AC_Sweep_t sweep = readACSweepFile(inpFile);
+
+        // One line per frequency, streamed as each point is solved
+        cout << "Frequency";
+        for (auto name : sweep.node_names)
+        {
+            cout << ", " << name;
+        }
+        cout << endl;
+
+        ACSweepNodalAnalysis(sweep,
+            [](const double& freq, const std::vector<std::pair<std::string, Complex_C_t>>& results)
+            {
+                cout << freq;
+                for (auto res : results)
+                {
+                    cout << ", " << cartToPolar(res.second);
+                }
+                cout << endl;
+            });
+    }
+    else if (anaylsis_type == "M")
+    {
+        if (extraFiles.empty())
+        {
+            cout << "Multi source analysis needs an excitation file" << endl;
+            return EXIT_FAILURE;
+        }
+
+        Nodal_Analysis_DC_t analysis = readDCAnalysisFile(inpFile);
+        Matrix<double> excitations = readExcitationFile(extraFiles.at(0), analysis.node_names);
+
+        Matrix<double> results = DCMultiSourceNodalAnalysis(analysis, excitations);
+
+        // One line per excitation pattern
+        cout << "Excitation";
+        for (auto name : analysis.node_names)
+        {
+            cout << ", " << name;
+        }
+        cout << endl;
+
+        for (size_t col = 0; col < results.getColCount(); col++)
+        {
+            cout << col;
+            for (size_t row = 0; row < results.getRowCount(); row++)
+            {
+                cout << ", " << results.get(row, col);
+            }
+            cout << endl;
+        }
+    }
+    else if (anaylsis_type == "T")
+    {
+        Nodal_Analysis_Transient_t tran = readTransientAnalysisFile(inpFile);
+
+        // One line per accepted time step, streamed as each step is solved
+        cout << "Time";
+        for (auto name : tran.node_names)
+        {
+            cout << ", " << name;
+        }
+        cout << endl;
+
+        Transient_Stats_t stats = TransientNodalAnalysis(tran,
+            [](const double& time, const std::vector<std::pair<std::string, double>>& results)
+            {
+                cout << time;
+                for (auto res : results)
+                {
+                    cout << ", " << res.second;
+                }
+                cout << endl;
+            });
+
+        std::cerr << "Steps: " << stats.steps << ", rejected: " << stats.rejected_steps <<
+            ", factorizations: " << stats.factorizations << endl;
+    }
+    else if (anaylsis_type == "U")
+    {
+        if (extraFiles.empty())
+        {
+            cout << "Update analysis needs an edit file" << endl;
+            return EXIT_FAILURE;
+        }
+
+        DC_Session session(readNetlistFile(inpFile, 0));
+        std::vector<std::pair<size_t, double>> edits = readEditFile(extraFiles.at(0), session.getNetlist());
+
+        // One line for the original netlist then one per edit, each solved with every edit before it
+        auto printRow = [](const std::string& label, const std::vector<std::pair<std::string, double>>& results)
+        {
+            cout << label;
+            for (auto res : results)
+            {
+                cout << ", " << res.second;
+            }
+            cout << endl;
+        };
+
+        std::vector<std::pair<std::string, double>> results = session.solve();
+        cout << "Edit";
+        for (auto res : results)
+        {
+            cout << ", " << res.first;
+        }
+        cout << endl;
+        printRow("none", results);
+
+        for (auto edit : edits)
+        {
+            session.setComponentValue(edit.first, edit.second);
+            printRow("line " + std::to_string(session.getNetlist().components.at(edit.first).line), session.solve());
+        }
+
+        std::cerr << "Edits: " << edits.size() << ", pending rank: " << session.getUpdateRank() <<
+            ", factorizations: " << session.getFactorizationCount() << endl;
+    }
+    else if (anaylsis_type == "B")
+    {
+        // A directory runs every file as one type, a manifest names the type of each file
+        std::vector<Batch_Entry_t> entries;
+        if (std::filesystem::is_directory(inpFile))
+        {
+            std::string type = options.count("type") ? options["type"] : "D";
+            if (type.size() != 1)
+            {
+                cout << "Unknown batch type: " + type << endl;
+                return EXIT_FAILURE;
+            }
+            entries = listBatchDirectory(inpFile, type[0]);
+        }
+        else
+        {
+            entries = readBatchManifest(inpFile);
+        }
+
+        Batch_Stats_t stats = batchNodalAnalysis(entries, cout, threadCount);
+
+        std::cerr << "Solved: " << stats.solved << ", failed: " << stats.failed << endl;
+    }
     else
     {
         cout << "Unknown analysis type: " + anaylsis_type << endl;
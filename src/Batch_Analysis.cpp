@@ -0,0 +1,164 @@
+/// ------------------------------------------
+/// @file Batch_Analysis.cpp
+///
+/// @brief Source for solving many netlists in one process
+/// ------------------------------------------
+
+#include "../inc/Batch_Analysis.h"
+
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+
+/// @brief Entries solved between writes, per worker thread, so memory stays flat for long batches
+static const size_t batch_window_per_worker = 64;
+
+///--------------------------------------------------------
+/// @brief Checks an analysis type is one the batch runner can solve
+///
+/// @param type analysis type
+///
+/// @return is the type 'A' or 'D'?
+static bool isBatchType(const char& type)
+{
+    return type == 'A' or type == 'D';
+}
+
+///--------------------------------------------------------
+/// @brief Solves one netlist of a batch, writing its voltages
+///
+/// @param entry netlist to solve
+/// @param out stream receiving one "node: voltage" line per node
+///
+/// @throws std::invalid_argument if the file cannot be read or solved
+static void solveBatchEntry(const Batch_Entry_t& entry, std::ostream& out)
+{
+    if (entry.type == 'A')
+    {
+        for (auto res : ACNodalAnalysis(readACAnalysisFile(entry.path)))
+        {
+            out << res.first << ": " << cartToPolar(res.second) << '\n';
+        }
+    }
+    else
+    {
+        for (auto res : DCNodalAnalysis(readDCAnalysisFile(entry.path)))
+        {
+            out << res.first << ": " << res.second << '\n';
+        }
+    }
+}
+
+///--------------------------------------------------------
+std::vector<Batch_Entry_t> readBatchManifest(const std::string& filename)
+{
+    std::filesystem::path base = std::filesystem::path(filename).parent_path();
+
+    Mapped_File file(filename);
+    std::vector<Batch_Entry_t> entries;
+    std::string_view tokens[2];
+
+    forEachLine(file.getContent(), [&](std::string_view line, size_t lineNumber)
+    {
+        if (tokenize(line, tokens, 2) != 2 or tokens[0].size() != 1 or !isBatchType(tokens[0][0]))
+        {
+            throw std::invalid_argument("Batch entry should be in the form [A/D] [path] (line " +
+                std::to_string(lineNumber) + ")");
+        }
+
+        std::filesystem::path path(tokens[1]);
+        if (path.is_relative())
+        {
+            path = base / path;
+        }
+        entries.push_back(Batch_Entry_t{tokens[0][0], path.string()});
+    });
+
+    return entries;
+}
+
+///--------------------------------------------------------
+std::vector<Batch_Entry_t> listBatchDirectory(const std::string& directory, const char& type)
+{
+    if (!isBatchType(type))
+    {
+        throw std::invalid_argument("Batch type must be A or D");
+    }
+
+    std::vector<Batch_Entry_t> entries;
+    try
+    {
+        for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(directory))
+        {
+            if (file.is_regular_file())
+            {
+                entries.push_back(Batch_Entry_t{type, file.path().string()});
+            }
+        }
+    }
+    catch (const std::filesystem::filesystem_error&)
+    {
+        throw std::invalid_argument("Could not read directory: " + directory);
+    }
+
+    // Directory iteration order is unspecified
+    std::sort(entries.begin(), entries.end(),
+        [](const Batch_Entry_t& a, const Batch_Entry_t& b) { return a.path < b.path; });
+
+    return entries;
+}
+
+///--------------------------------------------------------
+Batch_Stats_t batchNodalAnalysis(const std::vector<Batch_Entry_t>& entries, std::ostream& out,
+    const size_t& threadCount)
+{
+    Thread_Pool pool(threadCount);
+    size_t window = pool.getThreadCount() * batch_window_per_worker;
+    std::vector<std::string> sections(window);
+    std::vector<char> failed(window, 0);
+
+    Batch_Stats_t stats;
+    for (size_t first = 0; first < entries.size(); first += window)
+    {
+        size_t count = std::min(window, entries.size() - first);
+
+        // Netlists differ widely in size, idle workers steal from busy ones
+        pool.parallelForStealing(0, count, [&](size_t idx)
+        {
+            const Batch_Entry_t& entry = entries[first + idx];
+            std::ostringstream section;
+            section << "[" << entry.type << "] " << entry.path << '\n';
+            failed[idx] = 0;
+
+            // Each file is isolated, any failure only replaces its own voltages
+            std::ostringstream voltages;
+            try
+            {
+                solveBatchEntry(entry, voltages);
+                section << voltages.str();
+            }
+            catch (const std::exception& err)
+            {
+                section << "Error: " << err.what() << '\n';
+                failed[idx] = 1;
+            }
+
+            sections[idx] = section.str();
+        });
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            out << sections[idx];
+            if (failed[idx])
+            {
+                stats.failed++;
+            }
+            else
+            {
+                stats.solved++;
+            }
+        }
+    }
+
+    return stats;
+}
@@ -104,7 +104,7 @@ void operator*=(Complex_C_t& lcom, const double& rreal)
 ///--------------------------------------------------------
 Complex_C_t operator/(const Complex_C_t& lcom, const Complex_C_t& rcom)
 {
-    double div = pow(rcom.m_real, 2) + pow(rcom.m_imagine, 2);
+    double div = rcom.m_real * rcom.m_real + rcom.m_imagine * rcom.m_imagine;
     return Complex_C_t{
         (lcom.m_real * rcom.m_real + lcom.m_imagine * rcom.m_imagine) / div,
         (lcom.m_imagine * rcom.m_real - lcom.m_real * rcom.m_imagine) / div
@@ -120,7 +120,7 @@ Complex_C_t operator/(const Complex_C_t& lcom, const double& rreal)
 ///--------------------------------------------------------
 Complex_C_t operator/(const double& lreal, const Complex_C_t& rcom)
 {
-    double div = pow(rcom.m_real, 2) + pow(rcom.m_imagine, 2);
+    double div = rcom.m_real * rcom.m_real + rcom.m_imagine * rcom.m_imagine;
     return Complex_C_t{
         (lreal * rcom.m_real) / div,
         (-lreal * rcom.m_imagine) / div
@@ -210,33 +210,20 @@ Complex_C_t Complex_C_t::conjugate() const
 ///--------------------------------------------------------
 double Complex_C_t::absolute() const
 {
-    return sqrt(pow(m_real, 2) + pow(m_imagine, 2));
+    return hypot(m_real, m_imagine);
 }
 
 ///--------------------------------------------------------
 double Complex_C_t::argument() const
 {
-    // Implemenation of atan that allows for +/- inf inputs
-    // and scales output to [-pi, pi] range, relative to eastward 0 deg
+    // atan2 handles +/- inf inputs and all four quadrants,
+    // output is in [-pi, pi] range, relative to eastward 0 deg
     if (m_real == 0 and m_imagine == 0)
     {
         return 0;
     }
 
-    double preRotation = 0;
-    if (m_real < 0)
-    {
-        if (m_imagine > 0)
-        {
-            preRotation = M_PI_2;
-        }
-        else
-        {
-            preRotation = -M_PI_2;
-        }
-    }
-
-    return atan(m_imagine / m_real) + preRotation;
+    return atan2(m_imagine, m_real);
 }
 
 ///--------------------------------------------------------
@@ -0,0 +1,92 @@
+/// ------------------------------------------
+/// @file Complex_F.cpp
+///
+/// @brief Source file for the single precision Complex_F_t number structure
+/// ------------------------------------------
+
+#include "../inc/Complex_F.h"
+
+///--------------------------------------------------------
+Complex_F_t operator+(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    return Complex_F_t{lcom.m_real + rcom.m_real, lcom.m_imagine + rcom.m_imagine};
+}
+
+///--------------------------------------------------------
+Complex_F_t operator-(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    return Complex_F_t{lcom.m_real - rcom.m_real, lcom.m_imagine - rcom.m_imagine};
+}
+
+///--------------------------------------------------------
+Complex_F_t operator*(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    return Complex_F_t{
+        lcom.m_real * rcom.m_real - lcom.m_imagine * rcom.m_imagine,
+        lcom.m_real * rcom.m_imagine + lcom.m_imagine * rcom.m_real
+    };
+}
+
+///--------------------------------------------------------
+Complex_F_t operator/(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    float div = rcom.m_real * rcom.m_real + rcom.m_imagine * rcom.m_imagine;
+    return Complex_F_t{
+        (lcom.m_real * rcom.m_real + lcom.m_imagine * rcom.m_imagine) / div,
+        (lcom.m_imagine * rcom.m_real - lcom.m_real * rcom.m_imagine) / div
+    };
+}
+
+///--------------------------------------------------------
+Complex_F_t operator/(const Complex_F_t& lcom, const double& rreal)
+{
+    return Complex_F_t{(float) (lcom.m_real / rreal), (float) (lcom.m_imagine / rreal)};
+}
+
+///--------------------------------------------------------
+bool operator==(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    return (lcom.m_real == rcom.m_real) and (lcom.m_imagine == rcom.m_imagine);
+}
+
+///--------------------------------------------------------
+bool operator==(const Complex_F_t& lcom, const double& rreal)
+{
+    return (lcom.m_real == rreal) and (lcom.m_imagine == 0);
+}
+
+///--------------------------------------------------------
+bool operator!=(const Complex_F_t& lcom, const Complex_F_t& rcom)
+{
+    return !(lcom == rcom);
+}
+
+///--------------------------------------------------------
+bool operator!=(const Complex_F_t& lcom, const double& rreal)
+{
+    return !(lcom == rreal);
+}
+
+///--------------------------------------------------------
+Complex_F_t Complex_F_t::conjugate() const
+{
+    return Complex_F_t{m_real, -m_imagine};
+}
+
+///--------------------------------------------------------
+double Complex_F_t::absolute() const
+{
+    return std::hypot((double) m_real, (double) m_imagine);
+}
+
+///--------------------------------------------------------
+Complex_F_t cartToSingle(const Complex_C_t& cart)
+{
+    return Complex_F_t{(float) cart.m_real, (float) cart.m_imagine};
+}
+
+///--------------------------------------------------------
+Complex_C_t singleToCart(const Complex_F_t& single)
+{
+    return Complex_C_t{single.m_real, single.m_imagine};
+}
@@ -215,10 +215,14 @@ void Complex_P_t::setArg(const double& arg)
     m_arg = fmod(arg, M_PI * 2);
 
     // if m_arg above pi, need to shift [0, 2pi] or [-2pi, 0] range to [-pi, pi]
-    // being above pi means when translating the negative of the modulus is used
-    if (fabs(m_arg) > M_PI)
+    // by rotating a full turn in the opposite direction
+    if (m_arg > M_PI)
     {
-        m_arg = -fmod(m_arg, M_PI);
+        m_arg -= M_PI * 2;
+    }
+    else if (m_arg < -M_PI)
+    {
+        m_arg += M_PI * 2;
     }
 };
 
@@ -232,4 +236,10 @@ double Complex_P_t::real() const
 double Complex_P_t::imaginary() const
 {
     return m_mag * sin(m_arg);
+}
+
+///--------------------------------------------------------
+double Complex_P_t::absolute() const
+{
+    return fabs(m_mag);
 }
\ No newline at end of file
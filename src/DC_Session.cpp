@@ -0,0 +1,266 @@
+/// ------------------------------------------
+/// @file DC_Session.cpp
+///
+/// @brief Source for a DC solve session that keeps its factorization across component edits
+/// ------------------------------------------
+
+#include "../inc/DC_Session.h"
+
+#include <unordered_map>
+
+///--------------------------------------------------------
+DC_Session::DC_Session(const Netlist_t& netlist, const size_t& maxRank) :
+    m_netlist(netlist),
+    m_analysis(compileDCAnalysis(netlist)),
+    m_max_rank(maxRank)
+{
+    m_lu.analyze(m_analysis.conductance_mat);
+    m_lu.factor(m_analysis.conductance_mat);
+    m_factorizations = 1;
+
+    m_factored.assign(m_netlist.components.size(), 0);
+    for (size_t i = 0; i < m_netlist.components.size(); i++)
+    {
+        if (m_netlist.components[i].symbol == 'R')
+        {
+            m_factored[i] = 1 / m_netlist.components[i].value;
+        }
+    }
+}
+
+///--------------------------------------------------------
+void DC_Session::setComponentValue(const size_t& index, const double& value)
+{
+    if (index >= m_netlist.components.size())
+    {
+        throw std::invalid_argument("Component index " + std::to_string(index) + " is out of range");
+    }
+
+    Component_t& comp = m_netlist.components[index];
+    const Node_Reduction_t<double>& reduction = m_analysis.reduction;
+    int row1 = (comp.node1 == -1) ? -1 : reduction.node_rows.at(comp.node1);
+    int row2 = (comp.node2 == -1) ? -1 : reduction.node_rows.at(comp.node2);
+
+    if (comp.symbol == 'I')
+    {
+        addCurrent<double>(m_analysis.net_currents, value - comp.value, row1, row2);
+        comp.value = value;
+        return;
+    }
+
+    if (comp.symbol == 'V')
+    {
+        // Offsets of every node in the supernode move, so the known currents are restamped.
+        // The matrix does not depend on source values, the factorization and updates stay valid.
+        // A copy is compiled so a rejected value leaves the session unchanged
+        Netlist_t edited = m_netlist;
+        edited.components[index].value = value;
+        Nodal_Analysis_DC_t recompiled = compileDCAnalysis(edited);
+        comp.value = value;
+        m_analysis.net_currents = std::move(recompiled.net_currents);
+        m_analysis.constraint_currents = std::move(recompiled.constraint_currents);
+        m_analysis.reduction = std::move(recompiled.reduction);
+        return;
+    }
+
+    if (value <= 0)
+    {
+        throw std::invalid_argument("Resistance must be greater than 0 (line " + std::to_string(comp.line) + ")");
+    }
+
+    double change = 1 / value - 1 / comp.value;
+    comp.value = value;
+
+    // Both ends on the same unknown (or both fixed), no current depends on the unknowns
+    if (row1 == row2)
+    {
+        return;
+    }
+
+    // Keep the known current through the resistor from fixed offsets in step
+    double offset1 = (comp.node1 == -1) ? 0 : reduction.node_offsets[comp.node1];
+    double offset2 = (comp.node2 == -1) ? 0 : reduction.node_offsets[comp.node2];
+    double known = change * (offset1 - offset2);
+    if (known != 0)
+    {
+        addCurrent<double>(m_analysis.constraint_currents, known, row2, row1);
+        addCurrent<double>(m_analysis.net_currents, known, row2, row1);
+    }
+
+    // The stamped entries already exist, so the current matrix is updated in place
+    std::vector<double>& values = m_analysis.conductance_mat.getValues();
+    if (row1 != -1)
+    {
+        values[m_analysis.conductance_mat.findEntry(row1, row1)] += change;
+    }
+    if (row2 != -1)
+    {
+        values[m_analysis.conductance_mat.findEntry(row2, row2)] += change;
+    }
+    if (row1 != -1 and row2 != -1)
+    {
+        values[m_analysis.conductance_mat.findEntry(row1, row2)] -= change;
+        values[m_analysis.conductance_mat.findEntry(row2, row1)] -= change;
+    }
+
+    double delta = 1 / value - m_factored[index];
+    auto it = std::find_if(m_updates.begin(), m_updates.end(),
+        [&](const Rank_Update_t& update) { return update.component == index; });
+
+    // An edited resistor keeps its column of Z, only its weight changes
+    if (it != m_updates.end())
+    {
+        if (delta == 0)
+        {
+            m_updates.erase(it);
+        }
+        else
+        {
+            it->delta = delta;
+        }
+        return;
+    }
+
+    if (delta == 0)
+    {
+        return;
+    }
+
+    if (m_updates.size() == m_max_rank)
+    {
+        _refactor();
+        return;
+    }
+
+    Matrix<double> direction(m_analysis.conductance_mat.getRowCount(), 1);
+    addCurrent<double>(direction, 1, row1, row2);
+    Matrix<double> solved = m_lu.solve(direction);
+    m_updates.push_back(Rank_Update_t{index, row1, row2, delta,
+        std::vector<double>(solved.get_data(), solved.get_data() + solved.getRowCount())});
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DC_Session::solve() const
+{
+    Matrix<double> voltRes = m_lu.solve(m_analysis.net_currents);
+    size_t rank = m_updates.size();
+    if (rank == 0)
+    {
+        return expandNodeVoltages(m_analysis.node_names, m_analysis.reduction, voltRes);
+    }
+
+    // u' * v only reads the (at most) two rows an update touches
+    auto project = [](const Rank_Update_t& update, const double* vec)
+    {
+        double sum = 0;
+        if (update.row1 != -1)
+        {
+            sum += vec[update.row1];
+        }
+        if (update.row2 != -1)
+        {
+            sum -= vec[update.row2];
+        }
+        return sum;
+    };
+
+    // Small dense capacitance system (D^-1 + U'*Z) * y = U'*x
+    Matrix<double> capacitance(rank, rank);
+    Matrix<double> projected(rank, 1);
+    double* voltData = voltRes.get_data();
+    for (size_t i = 0; i < rank; i++)
+    {
+        for (size_t j = 0; j < rank; j++)
+        {
+            capacitance.set(i, j, project(m_updates[i], m_updates[j].solved.data()));
+        }
+        capacitance.set(i, i, capacitance.get(i, i) + 1 / m_updates[i].delta);
+        projected.set(i, 0, project(m_updates[i], voltData));
+    }
+
+    // A singular capacitance matrix means the edits disconnected part of the network
+    Matrix<double> weights = capacitance.solve(projected);
+
+    size_t n = voltRes.getRowCount();
+    for (size_t j = 0; j < rank; j++)
+    {
+        double weight = weights.get(j, 0);
+        const std::vector<double>& solved = m_updates[j].solved;
+        for (size_t i = 0; i < n; i++)
+        {
+            voltData[i] -= weight * solved[i];
+        }
+    }
+
+    return expandNodeVoltages(m_analysis.node_names, m_analysis.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+const Netlist_t& DC_Session::getNetlist() const
+{
+    return m_netlist;
+}
+
+///--------------------------------------------------------
+size_t DC_Session::getUpdateRank() const
+{
+    return m_updates.size();
+}
+
+///--------------------------------------------------------
+size_t DC_Session::getFactorizationCount() const
+{
+    return m_factorizations;
+}
+
+///--------------------------------------------------------
+void DC_Session::_refactor()
+{
+    // Same pattern as the first factorization, so the ordering and pivots are reused
+    m_lu.refactor(m_analysis.conductance_mat);
+    m_factorizations++;
+    m_updates.clear();
+
+    for (size_t i = 0; i < m_netlist.components.size(); i++)
+    {
+        if (m_netlist.components[i].symbol == 'R')
+        {
+            m_factored[i] = 1 / m_netlist.components[i].value;
+        }
+    }
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<size_t, double>> readEditFile(const std::string& filename, const Netlist_t& netlist)
+{
+    std::unordered_map<size_t, size_t> lineComponents;
+    for (size_t i = 0; i < netlist.components.size(); i++)
+    {
+        lineComponents.emplace(netlist.components[i].line, i);
+    }
+
+    Mapped_File file(filename);
+    std::vector<std::pair<size_t, double>> edits;
+    std::string_view tokens[2];
+
+    forEachLine(file.getContent(), [&](std::string_view line, size_t lineNumber)
+    {
+        if (tokenize(line, tokens, 2) != 2)
+        {
+            throw std::invalid_argument("Edit should be in the form [netlist line] [value] (line " +
+                std::to_string(lineNumber) + ")");
+        }
+
+        double netlistLine = convertCompToValue(tokens[0]);
+        auto it = lineComponents.find((size_t) netlistLine);
+        if (netlistLine < 1 or it == lineComponents.end())
+        {
+            throw std::invalid_argument("No component on netlist line " + std::string(tokens[0]) +
+                " (line " + std::to_string(lineNumber) + ")");
+        }
+
+        edits.emplace_back(it->second, convertCompToValue(tokens[1]));
+    });
+
+    return edits;
+}
@@ -0,0 +1,973 @@
+/// ------------------------------------------
+/// @file Dense_Kernels.cpp
+///
+/// @brief Source for the dense multiply and transpose kernels behind Matrix
+///
+/// @note Each SIMD kernel is compiled for its instruction set with a target
+/// attribute, so the rest of the build stays portable and the CPU is only
+/// checked at runtime
+/// ------------------------------------------
+
+#include "../inc/Dense_Kernels.h"
+
+#include <atomic>
+
+// The SIMD kernels need x86-64 and GCC/Clang target attributes, elsewhere only the portable kernels are built
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define DENSE_KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define DENSE_KERNELS_X86 0
+#endif
+
+static_assert(sizeof(Complex_C_t) == 2 * sizeof(double), "Complex_C_t must be stored as interleaved real, imaginary pairs");
+static_assert(sizeof(Complex_F_t) == 2 * sizeof(float), "Complex_F_t must be stored as interleaved real, imaginary pairs");
+
+/// @brief Rows of b (cols of a) per cache block, keeps a block of b resident in L2
+static const size_t block_inner = 256;
+
+/// @brief Cols of b per cache block
+static const size_t block_cols = 256;
+
+/// @brief Cols of b per cache block for complex values, twice the size of a double
+static const size_t block_complex_cols = 128;
+
+/// @brief Active level, -1 until first detected
+static std::atomic<int> active_level(-1);
+
+///--------------------------------------------------------
+/// @brief Portable out += a * b for interleaved single precision complex
+///
+/// @note Works on the float pairs directly, the Complex_F_t operators are not inlined
+static void multiplySingleComplex(const size_t& rows, const size_t& inner, const size_t& cols,
+    const float* a, const float* b, float* out)
+{
+    for (size_t i = 0; i < rows; i++)
+    {
+        float* outRow = out + 2 * i * cols;
+        for (size_t k = 0; k < inner; k++)
+        {
+            float ar = a[2 * (i * inner + k)];
+            float ai = a[2 * (i * inner + k) + 1];
+            if (ar == 0 and ai == 0)
+            {
+                continue;
+            }
+
+            const float* bRow = b + 2 * k * cols;
+            for (size_t j = 0; j < cols; j++)
+            {
+                outRow[2 * j] += ar * bRow[2 * j] - ai * bRow[2 * j + 1];
+                outRow[2 * j + 1] += ar * bRow[2 * j + 1] + ai * bRow[2 * j];
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+std::string simdLevelName(const Simd_Level_t& level)
+{
+    switch (level)
+    {
+        case Simd_Level_t::avx2:
+            return "avx2";
+
+        case Simd_Level_t::avx512:
+            return "avx512";
+
+        default:
+            return "scalar";
+    }
+}
+
+///--------------------------------------------------------
+Simd_Level_t detectSimdLevel()
+{
+#if DENSE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("fma"))
+    {
+        return Simd_Level_t::avx512;
+    }
+
+    if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma"))
+    {
+        return Simd_Level_t::avx2;
+    }
+#endif
+
+    return Simd_Level_t::scalar;
+}
+
+///--------------------------------------------------------
+Simd_Level_t getSimdLevel()
+{
+    int level = active_level.load(std::memory_order_relaxed);
+    if (level < 0)
+    {
+        level = static_cast<int>(detectSimdLevel());
+        active_level.store(level, std::memory_order_relaxed);
+    }
+
+    return static_cast<Simd_Level_t>(level);
+}
+
+///--------------------------------------------------------
+void setSimdLevel(const Simd_Level_t& level)
+{
+    active_level.store(static_cast<int>(std::min(level, detectSimdLevel())), std::memory_order_relaxed);
+}
+
+#if DENSE_KERNELS_X86
+///--------------------------------------------------------
+/// @brief Sum of the four lanes of a vector
+__attribute__((target("avx2,fma")))
+static double horizontalSum(const __m256d& vec)
+{
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(vec), _mm256_extractf128_pd(vec, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+///--------------------------------------------------------
+/// @brief out += a * b for doubles, 4x8 register tiles over cache blocks of b
+__attribute__((target("avx2,fma")))
+static void multiplyDoubleAvx2(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out)
+{
+    for (size_t kk = 0; kk < inner; kk += block_inner)
+    {
+        size_t kEnd = std::min(kk + block_inner, inner);
+        for (size_t jj = 0; jj < cols; jj += block_cols)
+        {
+            size_t jEnd = std::min(jj + block_cols, cols);
+            size_t i = 0;
+            for (; i + 4 <= rows; i += 4)
+            {
+                const double* a0 = a + i * inner;
+                const double* a1 = a0 + inner;
+                const double* a2 = a1 + inner;
+                const double* a3 = a2 + inner;
+                double* o0 = out + i * cols;
+                double* o1 = o0 + cols;
+                double* o2 = o1 + cols;
+                double* o3 = o2 + cols;
+
+                size_t j = jj;
+                for (; j + 8 <= jEnd; j += 8)
+                {
+                    __m256d c00 = _mm256_loadu_pd(o0 + j), c01 = _mm256_loadu_pd(o0 + j + 4);
+                    __m256d c10 = _mm256_loadu_pd(o1 + j), c11 = _mm256_loadu_pd(o1 + j + 4);
+                    __m256d c20 = _mm256_loadu_pd(o2 + j), c21 = _mm256_loadu_pd(o2 + j + 4);
+                    __m256d c30 = _mm256_loadu_pd(o3 + j), c31 = _mm256_loadu_pd(o3 + j + 4);
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m256d b0 = _mm256_loadu_pd(b + k * cols + j);
+                        __m256d b1 = _mm256_loadu_pd(b + k * cols + j + 4);
+                        __m256d av = _mm256_broadcast_sd(a0 + k);
+                        c00 = _mm256_fmadd_pd(av, b0, c00);
+                        c01 = _mm256_fmadd_pd(av, b1, c01);
+                        av = _mm256_broadcast_sd(a1 + k);
+                        c10 = _mm256_fmadd_pd(av, b0, c10);
+                        c11 = _mm256_fmadd_pd(av, b1, c11);
+                        av = _mm256_broadcast_sd(a2 + k);
+                        c20 = _mm256_fmadd_pd(av, b0, c20);
+                        c21 = _mm256_fmadd_pd(av, b1, c21);
+                        av = _mm256_broadcast_sd(a3 + k);
+                        c30 = _mm256_fmadd_pd(av, b0, c30);
+                        c31 = _mm256_fmadd_pd(av, b1, c31);
+                    }
+                    _mm256_storeu_pd(o0 + j, c00);
+                    _mm256_storeu_pd(o0 + j + 4, c01);
+                    _mm256_storeu_pd(o1 + j, c10);
+                    _mm256_storeu_pd(o1 + j + 4, c11);
+                    _mm256_storeu_pd(o2 + j, c20);
+                    _mm256_storeu_pd(o2 + j + 4, c21);
+                    _mm256_storeu_pd(o3 + j, c30);
+                    _mm256_storeu_pd(o3 + j + 4, c31);
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    double s0 = o0[j], s1 = o1[j], s2 = o2[j], s3 = o3[j];
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        double bkj = b[k * cols + j];
+                        s0 += a0[k] * bkj;
+                        s1 += a1[k] * bkj;
+                        s2 += a2[k] * bkj;
+                        s3 += a3[k] * bkj;
+                    }
+                    o0[j] = s0;
+                    o1[j] = s1;
+                    o2[j] = s2;
+                    o3[j] = s3;
+                }
+            }
+
+            // Rows left over from the 4 row tiles
+            for (; i < rows; i++)
+            {
+                const double* aRow = a + i * inner;
+                double* oRow = out + i * cols;
+                size_t j = jj;
+                for (; j + 4 <= jEnd; j += 4)
+                {
+                    __m256d acc = _mm256_loadu_pd(oRow + j);
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        acc = _mm256_fmadd_pd(_mm256_broadcast_sd(aRow + k), _mm256_loadu_pd(b + k * cols + j), acc);
+                    }
+                    _mm256_storeu_pd(oRow + j, acc);
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    double sum = oRow[j];
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        sum += aRow[k] * b[k * cols + j];
+                    }
+                    oRow[j] = sum;
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * x for doubles, four row dot products share each load of x
+__attribute__((target("avx2,fma")))
+static void multiplyVectorDoubleAvx2(const size_t& rows, const size_t& inner, const double* a, const double* x, double* out)
+{
+    size_t i = 0;
+    for (; i + 4 <= rows; i += 4)
+    {
+        const double* a0 = a + i * inner;
+        const double* a1 = a0 + inner;
+        const double* a2 = a1 + inner;
+        const double* a3 = a2 + inner;
+        __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+
+        size_t k = 0;
+        for (; k + 4 <= inner; k += 4)
+        {
+            __m256d xv = _mm256_loadu_pd(x + k);
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + k), xv, acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + k), xv, acc1);
+            acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + k), xv, acc2);
+            acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + k), xv, acc3);
+        }
+
+        double s0 = horizontalSum(acc0), s1 = horizontalSum(acc1);
+        double s2 = horizontalSum(acc2), s3 = horizontalSum(acc3);
+        for (; k < inner; k++)
+        {
+            s0 += a0[k] * x[k];
+            s1 += a1[k] * x[k];
+            s2 += a2[k] * x[k];
+            s3 += a3[k] * x[k];
+        }
+        out[i] += s0;
+        out[i + 1] += s1;
+        out[i + 2] += s2;
+        out[i + 3] += s3;
+    }
+
+    for (; i < rows; i++)
+    {
+        const double* aRow = a + i * inner;
+        __m256d acc = _mm256_setzero_pd();
+        size_t k = 0;
+        for (; k + 4 <= inner; k += 4)
+        {
+            acc = _mm256_fmadd_pd(_mm256_loadu_pd(aRow + k), _mm256_loadu_pd(x + k), acc);
+        }
+
+        double sum = horizontalSum(acc);
+        for (; k < inner; k++)
+        {
+            sum += aRow[k] * x[k];
+        }
+        out[i] += sum;
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * b for doubles, 4x16 register tiles over cache blocks of b
+__attribute__((target("avx512f,fma")))
+static void multiplyDoubleAvx512(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out)
+{
+    for (size_t kk = 0; kk < inner; kk += block_inner)
+    {
+        size_t kEnd = std::min(kk + block_inner, inner);
+        for (size_t jj = 0; jj < cols; jj += block_cols)
+        {
+            size_t jEnd = std::min(jj + block_cols, cols);
+            size_t i = 0;
+            for (; i + 4 <= rows; i += 4)
+            {
+                const double* a0 = a + i * inner;
+                const double* a1 = a0 + inner;
+                const double* a2 = a1 + inner;
+                const double* a3 = a2 + inner;
+                double* o0 = out + i * cols;
+                double* o1 = o0 + cols;
+                double* o2 = o1 + cols;
+                double* o3 = o2 + cols;
+
+                size_t j = jj;
+                for (; j + 16 <= jEnd; j += 16)
+                {
+                    __m512d c00 = _mm512_loadu_pd(o0 + j), c01 = _mm512_loadu_pd(o0 + j + 8);
+                    __m512d c10 = _mm512_loadu_pd(o1 + j), c11 = _mm512_loadu_pd(o1 + j + 8);
+                    __m512d c20 = _mm512_loadu_pd(o2 + j), c21 = _mm512_loadu_pd(o2 + j + 8);
+                    __m512d c30 = _mm512_loadu_pd(o3 + j), c31 = _mm512_loadu_pd(o3 + j + 8);
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m512d b0 = _mm512_loadu_pd(b + k * cols + j);
+                        __m512d b1 = _mm512_loadu_pd(b + k * cols + j + 8);
+                        __m512d av = _mm512_set1_pd(a0[k]);
+                        c00 = _mm512_fmadd_pd(av, b0, c00);
+                        c01 = _mm512_fmadd_pd(av, b1, c01);
+                        av = _mm512_set1_pd(a1[k]);
+                        c10 = _mm512_fmadd_pd(av, b0, c10);
+                        c11 = _mm512_fmadd_pd(av, b1, c11);
+                        av = _mm512_set1_pd(a2[k]);
+                        c20 = _mm512_fmadd_pd(av, b0, c20);
+                        c21 = _mm512_fmadd_pd(av, b1, c21);
+                        av = _mm512_set1_pd(a3[k]);
+                        c30 = _mm512_fmadd_pd(av, b0, c30);
+                        c31 = _mm512_fmadd_pd(av, b1, c31);
+                    }
+                    _mm512_storeu_pd(o0 + j, c00);
+                    _mm512_storeu_pd(o0 + j + 8, c01);
+                    _mm512_storeu_pd(o1 + j, c10);
+                    _mm512_storeu_pd(o1 + j + 8, c11);
+                    _mm512_storeu_pd(o2 + j, c20);
+                    _mm512_storeu_pd(o2 + j + 8, c21);
+                    _mm512_storeu_pd(o3 + j, c30);
+                    _mm512_storeu_pd(o3 + j + 8, c31);
+                }
+
+                // Under 16 columns left, masked 8 wide tiles finish the row block
+                for (; j < jEnd; j += 8)
+                {
+                    __mmask8 mask = (jEnd - j >= 8) ? 0xFF : (__mmask8) ((1u << (jEnd - j)) - 1);
+                    __m512d c0 = _mm512_maskz_loadu_pd(mask, o0 + j), c1 = _mm512_maskz_loadu_pd(mask, o1 + j);
+                    __m512d c2 = _mm512_maskz_loadu_pd(mask, o2 + j), c3 = _mm512_maskz_loadu_pd(mask, o3 + j);
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m512d bv = _mm512_maskz_loadu_pd(mask, b + k * cols + j);
+                        c0 = _mm512_fmadd_pd(_mm512_set1_pd(a0[k]), bv, c0);
+                        c1 = _mm512_fmadd_pd(_mm512_set1_pd(a1[k]), bv, c1);
+                        c2 = _mm512_fmadd_pd(_mm512_set1_pd(a2[k]), bv, c2);
+                        c3 = _mm512_fmadd_pd(_mm512_set1_pd(a3[k]), bv, c3);
+                    }
+                    _mm512_mask_storeu_pd(o0 + j, mask, c0);
+                    _mm512_mask_storeu_pd(o1 + j, mask, c1);
+                    _mm512_mask_storeu_pd(o2 + j, mask, c2);
+                    _mm512_mask_storeu_pd(o3 + j, mask, c3);
+                }
+            }
+
+            // Rows left over from the 4 row tiles
+            for (; i < rows; i++)
+            {
+                const double* aRow = a + i * inner;
+                double* oRow = out + i * cols;
+                for (size_t j = jj; j < jEnd; j += 8)
+                {
+                    __mmask8 mask = (jEnd - j >= 8) ? 0xFF : (__mmask8) ((1u << (jEnd - j)) - 1);
+                    __m512d acc = _mm512_maskz_loadu_pd(mask, oRow + j);
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        acc = _mm512_fmadd_pd(_mm512_set1_pd(aRow[k]), _mm512_maskz_loadu_pd(mask, b + k * cols + j), acc);
+                    }
+                    _mm512_mask_storeu_pd(oRow + j, mask, acc);
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * x for doubles, four row dot products share each load of x
+__attribute__((target("avx512f,fma")))
+static void multiplyVectorDoubleAvx512(const size_t& rows, const size_t& inner, const double* a, const double* x, double* out)
+{
+    size_t i = 0;
+    for (; i + 4 <= rows; i += 4)
+    {
+        const double* a0 = a + i * inner;
+        const double* a1 = a0 + inner;
+        const double* a2 = a1 + inner;
+        const double* a3 = a2 + inner;
+        __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+        __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+
+        for (size_t k = 0; k < inner; k += 8)
+        {
+            __mmask8 mask = (inner - k >= 8) ? 0xFF : (__mmask8) ((1u << (inner - k)) - 1);
+            __m512d xv = _mm512_maskz_loadu_pd(mask, x + k);
+            acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a0 + k), xv, acc0);
+            acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a1 + k), xv, acc1);
+            acc2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a2 + k), xv, acc2);
+            acc3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a3 + k), xv, acc3);
+        }
+
+        out[i] += _mm512_reduce_add_pd(acc0);
+        out[i + 1] += _mm512_reduce_add_pd(acc1);
+        out[i + 2] += _mm512_reduce_add_pd(acc2);
+        out[i + 3] += _mm512_reduce_add_pd(acc3);
+    }
+
+    for (; i < rows; i++)
+    {
+        const double* aRow = a + i * inner;
+        __m512d acc = _mm512_setzero_pd();
+        for (size_t k = 0; k < inner; k += 8)
+        {
+            __mmask8 mask = (inner - k >= 8) ? 0xFF : (__mmask8) ((1u << (inner - k)) - 1);
+            acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, aRow + k), _mm512_maskz_loadu_pd(mask, x + k), acc);
+        }
+        out[i] += _mm512_reduce_add_pd(acc);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * b for interleaved complex, 2x4 register tiles over cache blocks of b
+///
+/// @note With a = ar + j*ai broadcast, a*b is ar*b -/+ ai*swap(b) on the real/imaginary
+/// lanes, so the two products are accumulated apart and combined once with addsub
+__attribute__((target("avx2,fma")))
+static void multiplyComplexAvx2(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out)
+{
+    for (size_t kk = 0; kk < inner; kk += block_inner)
+    {
+        size_t kEnd = std::min(kk + block_inner, inner);
+        for (size_t jj = 0; jj < cols; jj += block_complex_cols)
+        {
+            size_t jEnd = std::min(jj + block_complex_cols, cols);
+            size_t i = 0;
+            for (; i < rows; i += 2)
+            {
+                // Two row tiles, the last row of an odd count repeats into a tile that is never stored
+                bool pair = (i + 1 < rows);
+                const double* a0 = a + 2 * i * inner;
+                const double* a1 = pair ? a0 + 2 * inner : a0;
+                double* o0 = out + 2 * i * cols;
+                double* o1 = pair ? o0 + 2 * cols : o0;
+
+                size_t j = jj;
+                for (; j + 4 <= jEnd; j += 4)
+                {
+                    __m256d r00 = _mm256_setzero_pd(), r01 = _mm256_setzero_pd();
+                    __m256d r10 = _mm256_setzero_pd(), r11 = _mm256_setzero_pd();
+                    __m256d q00 = _mm256_setzero_pd(), q01 = _mm256_setzero_pd();
+                    __m256d q10 = _mm256_setzero_pd(), q11 = _mm256_setzero_pd();
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m256d b0 = _mm256_loadu_pd(b + 2 * (k * cols + j));
+                        __m256d b1 = _mm256_loadu_pd(b + 2 * (k * cols + j) + 4);
+                        __m256d s0 = _mm256_permute_pd(b0, 0b0101);
+                        __m256d s1 = _mm256_permute_pd(b1, 0b0101);
+
+                        __m256d ar = _mm256_broadcast_sd(a0 + 2 * k);
+                        __m256d ai = _mm256_broadcast_sd(a0 + 2 * k + 1);
+                        r00 = _mm256_fmadd_pd(ar, b0, r00);
+                        r01 = _mm256_fmadd_pd(ar, b1, r01);
+                        q00 = _mm256_fmadd_pd(ai, s0, q00);
+                        q01 = _mm256_fmadd_pd(ai, s1, q01);
+
+                        ar = _mm256_broadcast_sd(a1 + 2 * k);
+                        ai = _mm256_broadcast_sd(a1 + 2 * k + 1);
+                        r10 = _mm256_fmadd_pd(ar, b0, r10);
+                        r11 = _mm256_fmadd_pd(ar, b1, r11);
+                        q10 = _mm256_fmadd_pd(ai, s0, q10);
+                        q11 = _mm256_fmadd_pd(ai, s1, q11);
+                    }
+
+                    double* p = o0 + 2 * j;
+                    _mm256_storeu_pd(p, _mm256_add_pd(_mm256_loadu_pd(p), _mm256_addsub_pd(r00, q00)));
+                    _mm256_storeu_pd(p + 4, _mm256_add_pd(_mm256_loadu_pd(p + 4), _mm256_addsub_pd(r01, q01)));
+                    if (pair)
+                    {
+                        p = o1 + 2 * j;
+                        _mm256_storeu_pd(p, _mm256_add_pd(_mm256_loadu_pd(p), _mm256_addsub_pd(r10, q10)));
+                        _mm256_storeu_pd(p + 4, _mm256_add_pd(_mm256_loadu_pd(p + 4), _mm256_addsub_pd(r11, q11)));
+                    }
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    for (size_t r = 0; r < (pair ? 2 : 1); r++)
+                    {
+                        const double* aRow = (r == 0) ? a0 : a1;
+                        double* oRow = (r == 0) ? o0 : o1;
+                        double re = oRow[2 * j];
+                        double im = oRow[2 * j + 1];
+                        for (size_t k = kk; k < kEnd; k++)
+                        {
+                            double br = b[2 * (k * cols + j)];
+                            double bi = b[2 * (k * cols + j) + 1];
+                            re += aRow[2 * k] * br - aRow[2 * k + 1] * bi;
+                            im += aRow[2 * k] * bi + aRow[2 * k + 1] * br;
+                        }
+                        oRow[2 * j] = re;
+                        oRow[2 * j + 1] = im;
+                    }
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * x for interleaved complex, one row at a time
+///
+/// @note a.*x summed gives re = sum(even - odd lanes), a.*swap(x) gives im = sum(all lanes)
+__attribute__((target("avx2,fma")))
+static void multiplyVectorComplexAvx2(const size_t& rows, const size_t& inner, const double* a, const double* x, double* out)
+{
+    const __m256d signs = _mm256_setr_pd(1, -1, 1, -1);
+    for (size_t i = 0; i < rows; i++)
+    {
+        const double* aRow = a + 2 * i * inner;
+        __m256d real0 = _mm256_setzero_pd(), real1 = _mm256_setzero_pd();
+        __m256d imag0 = _mm256_setzero_pd(), imag1 = _mm256_setzero_pd();
+
+        size_t k = 0;
+        for (; k + 4 <= inner; k += 4)
+        {
+            __m256d x0 = _mm256_loadu_pd(x + 2 * k);
+            __m256d x1 = _mm256_loadu_pd(x + 2 * k + 4);
+            __m256d v0 = _mm256_loadu_pd(aRow + 2 * k);
+            __m256d v1 = _mm256_loadu_pd(aRow + 2 * k + 4);
+            real0 = _mm256_fmadd_pd(v0, x0, real0);
+            real1 = _mm256_fmadd_pd(v1, x1, real1);
+            imag0 = _mm256_fmadd_pd(v0, _mm256_permute_pd(x0, 0b0101), imag0);
+            imag1 = _mm256_fmadd_pd(v1, _mm256_permute_pd(x1, 0b0101), imag1);
+        }
+
+        double re = horizontalSum(_mm256_mul_pd(_mm256_add_pd(real0, real1), signs));
+        double im = horizontalSum(_mm256_add_pd(imag0, imag1));
+        for (; k < inner; k++)
+        {
+            re += aRow[2 * k] * x[2 * k] - aRow[2 * k + 1] * x[2 * k + 1];
+            im += aRow[2 * k] * x[2 * k + 1] + aRow[2 * k + 1] * x[2 * k];
+        }
+        out[2 * i] += re;
+        out[2 * i + 1] += im;
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * b for interleaved complex, 4x8 register tiles over cache blocks of b
+///
+/// @note AVX-512 has no addsub, fmaddsub(r, 1, q) gives the same r -/+ q
+__attribute__((target("avx512f,fma")))
+static void multiplyComplexAvx512(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out)
+{
+    const __m512d ones = _mm512_set1_pd(1);
+    for (size_t kk = 0; kk < inner; kk += block_inner)
+    {
+        size_t kEnd = std::min(kk + block_inner, inner);
+        for (size_t jj = 0; jj < cols; jj += block_complex_cols)
+        {
+            size_t jEnd = std::min(jj + block_complex_cols, cols);
+            for (size_t i = 0; i < rows; i += 4)
+            {
+                // Rows past the end repeat the last row into tiles that are never stored
+                size_t tileRows = std::min<size_t>(4, rows - i);
+                const double* aRows[4];
+                for (size_t r = 0; r < 4; r++)
+                {
+                    aRows[r] = a + 2 * (i + std::min(r, tileRows - 1)) * inner;
+                }
+
+                for (size_t j = jj; j < jEnd; j += 8)
+                {
+                    // 8 complex per tile row as two vectors, masked on the last tile
+                    size_t left = std::min<size_t>(8, jEnd - j);
+                    __mmask8 mask0 = (left >= 4) ? 0xFF : (__mmask8) ((1u << (2 * left)) - 1);
+                    __mmask8 mask1 = (left <= 4) ? 0 : (left >= 8) ? 0xFF : (__mmask8) ((1u << (2 * (left - 4))) - 1);
+
+                    __m512d real[4][2];
+                    __m512d imag[4][2];
+#pragma GCC unroll 4
+                    for (size_t r = 0; r < 4; r++)
+                    {
+                        real[r][0] = real[r][1] = imag[r][0] = imag[r][1] = _mm512_setzero_pd();
+                    }
+
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m512d b0 = _mm512_maskz_loadu_pd(mask0, b + 2 * (k * cols + j));
+                        __m512d b1 = _mm512_maskz_loadu_pd(mask1, b + 2 * (k * cols + j) + 8);
+                        __m512d s0 = _mm512_permute_pd(b0, 0x55);
+                        __m512d s1 = _mm512_permute_pd(b1, 0x55);
+#pragma GCC unroll 4
+                        for (size_t r = 0; r < 4; r++)
+                        {
+                            __m512d ar = _mm512_set1_pd(aRows[r][2 * k]);
+                            __m512d ai = _mm512_set1_pd(aRows[r][2 * k + 1]);
+                            real[r][0] = _mm512_fmadd_pd(ar, b0, real[r][0]);
+                            real[r][1] = _mm512_fmadd_pd(ar, b1, real[r][1]);
+                            imag[r][0] = _mm512_fmadd_pd(ai, s0, imag[r][0]);
+                            imag[r][1] = _mm512_fmadd_pd(ai, s1, imag[r][1]);
+                        }
+                    }
+
+                    for (size_t r = 0; r < tileRows; r++)
+                    {
+                        double* p = out + 2 * ((i + r) * cols + j);
+                        __m512d sum0 = _mm512_fmaddsub_pd(real[r][0], ones, imag[r][0]);
+                        __m512d sum1 = _mm512_fmaddsub_pd(real[r][1], ones, imag[r][1]);
+                        _mm512_mask_storeu_pd(p, mask0, _mm512_add_pd(_mm512_maskz_loadu_pd(mask0, p), sum0));
+                        _mm512_mask_storeu_pd(p + 8, mask1, _mm512_add_pd(_mm512_maskz_loadu_pd(mask1, p + 8), sum1));
+                    }
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * x for interleaved complex, one row at a time
+__attribute__((target("avx512f,fma")))
+static void multiplyVectorComplexAvx512(const size_t& rows, const size_t& inner, const double* a, const double* x, double* out)
+{
+    const __m512d signs = _mm512_setr_pd(1, -1, 1, -1, 1, -1, 1, -1);
+    for (size_t i = 0; i < rows; i++)
+    {
+        const double* aRow = a + 2 * i * inner;
+        __m512d real = _mm512_setzero_pd();
+        __m512d imag = _mm512_setzero_pd();
+        for (size_t k = 0; k < inner; k += 4)
+        {
+            size_t left = std::min<size_t>(4, inner - k);
+            __mmask8 mask = (left >= 4) ? 0xFF : (__mmask8) ((1u << (2 * left)) - 1);
+            __m512d xv = _mm512_maskz_loadu_pd(mask, x + 2 * k);
+            __m512d av = _mm512_maskz_loadu_pd(mask, aRow + 2 * k);
+            real = _mm512_fmadd_pd(av, xv, real);
+            imag = _mm512_fmadd_pd(av, _mm512_permute_pd(xv, 0x55), imag);
+        }
+
+        out[2 * i] += _mm512_reduce_add_pd(_mm512_mul_pd(real, signs));
+        out[2 * i + 1] += _mm512_reduce_add_pd(imag);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief dst = src' for doubles, 4x4 blocks transposed in registers within each cache tile
+__attribute__((target("avx2,fma")))
+static void transposeDoubleAvx2(const size_t& rows, const size_t& cols, const double* src, double* dst)
+{
+    for (size_t ii = 0; ii < rows; ii += transpose_block)
+    {
+        size_t iEnd = std::min(ii + transpose_block, rows);
+        for (size_t jj = 0; jj < cols; jj += transpose_block)
+        {
+            size_t jEnd = std::min(jj + transpose_block, cols);
+            size_t i = ii;
+            for (; i + 4 <= iEnd; i += 4)
+            {
+                size_t j = jj;
+                for (; j + 4 <= jEnd; j += 4)
+                {
+                    __m256d r0 = _mm256_loadu_pd(src + i * cols + j);
+                    __m256d r1 = _mm256_loadu_pd(src + (i + 1) * cols + j);
+                    __m256d r2 = _mm256_loadu_pd(src + (i + 2) * cols + j);
+                    __m256d r3 = _mm256_loadu_pd(src + (i + 3) * cols + j);
+
+                    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+                    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+                    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+                    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+                    _mm256_storeu_pd(dst + j * rows + i, _mm256_permute2f128_pd(t0, t2, 0x20));
+                    _mm256_storeu_pd(dst + (j + 1) * rows + i, _mm256_permute2f128_pd(t1, t3, 0x20));
+                    _mm256_storeu_pd(dst + (j + 2) * rows + i, _mm256_permute2f128_pd(t0, t2, 0x31));
+                    _mm256_storeu_pd(dst + (j + 3) * rows + i, _mm256_permute2f128_pd(t1, t3, 0x31));
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    for (size_t r = i; r < i + 4; r++)
+                    {
+                        dst[j * rows + r] = src[r * cols + j];
+                    }
+                }
+            }
+
+            for (; i < iEnd; i++)
+            {
+                for (size_t j = jj; j < jEnd; j++)
+                {
+                    dst[j * rows + i] = src[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief dst = src' for interleaved complex, 2x2 blocks swapped by 128 bit lane within each cache tile
+__attribute__((target("avx2,fma")))
+static void transposeComplexAvx2(const size_t& rows, const size_t& cols, const double* src, double* dst)
+{
+    for (size_t ii = 0; ii < rows; ii += transpose_block)
+    {
+        size_t iEnd = std::min(ii + transpose_block, rows);
+        for (size_t jj = 0; jj < cols; jj += transpose_block)
+        {
+            size_t jEnd = std::min(jj + transpose_block, cols);
+            size_t i = ii;
+            for (; i + 2 <= iEnd; i += 2)
+            {
+                size_t j = jj;
+                for (; j + 2 <= jEnd; j += 2)
+                {
+                    __m256d r0 = _mm256_loadu_pd(src + 2 * (i * cols + j));
+                    __m256d r1 = _mm256_loadu_pd(src + 2 * ((i + 1) * cols + j));
+                    _mm256_storeu_pd(dst + 2 * (j * rows + i), _mm256_permute2f128_pd(r0, r1, 0x20));
+                    _mm256_storeu_pd(dst + 2 * ((j + 1) * rows + i), _mm256_permute2f128_pd(r0, r1, 0x31));
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    _mm_storeu_pd(dst + 2 * (j * rows + i), _mm_loadu_pd(src + 2 * (i * cols + j)));
+                    _mm_storeu_pd(dst + 2 * (j * rows + i + 1), _mm_loadu_pd(src + 2 * ((i + 1) * cols + j)));
+                }
+            }
+
+            for (; i < iEnd; i++)
+            {
+                for (size_t j = jj; j < jEnd; j++)
+                {
+                    _mm_storeu_pd(dst + 2 * (j * rows + i), _mm_loadu_pd(src + 2 * (i * cols + j)));
+                }
+            }
+        }
+    }
+}
+
+///--------------------------------------------------------
+/// @brief out += a * b for interleaved single precision complex, 2x8 register tiles
+/// over cache blocks of b
+///
+/// @note Same scheme as multiplyComplexAvx2 with four complex values per register
+__attribute__((target("avx2,fma")))
+static void multiplySingleComplexAvx2(const size_t& rows, const size_t& inner, const size_t& cols,
+    const float* a, const float* b, float* out)
+{
+    for (size_t kk = 0; kk < inner; kk += block_inner)
+    {
+        size_t kEnd = std::min(kk + block_inner, inner);
+        for (size_t jj = 0; jj < cols; jj += block_cols)
+        {
+            size_t jEnd = std::min(jj + block_cols, cols);
+            for (size_t i = 0; i < rows; i += 2)
+            {
+                // Two row tiles, the last row of an odd count repeats into a tile that is never stored
+                bool pair = (i + 1 < rows);
+                const float* a0 = a + 2 * i * inner;
+                const float* a1 = pair ? a0 + 2 * inner : a0;
+                float* o0 = out + 2 * i * cols;
+                float* o1 = pair ? o0 + 2 * cols : o0;
+
+                size_t j = jj;
+                for (; j + 8 <= jEnd; j += 8)
+                {
+                    __m256 r00 = _mm256_setzero_ps(), r01 = _mm256_setzero_ps();
+                    __m256 r10 = _mm256_setzero_ps(), r11 = _mm256_setzero_ps();
+                    __m256 q00 = _mm256_setzero_ps(), q01 = _mm256_setzero_ps();
+                    __m256 q10 = _mm256_setzero_ps(), q11 = _mm256_setzero_ps();
+                    for (size_t k = kk; k < kEnd; k++)
+                    {
+                        __m256 b0 = _mm256_loadu_ps(b + 2 * (k * cols + j));
+                        __m256 b1 = _mm256_loadu_ps(b + 2 * (k * cols + j) + 8);
+                        __m256 s0 = _mm256_permute_ps(b0, 0b10110001);
+                        __m256 s1 = _mm256_permute_ps(b1, 0b10110001);
+
+                        __m256 ar = _mm256_broadcast_ss(a0 + 2 * k);
+                        __m256 ai = _mm256_broadcast_ss(a0 + 2 * k + 1);
+                        r00 = _mm256_fmadd_ps(ar, b0, r00);
+                        r01 = _mm256_fmadd_ps(ar, b1, r01);
+                        q00 = _mm256_fmadd_ps(ai, s0, q00);
+                        q01 = _mm256_fmadd_ps(ai, s1, q01);
+
+                        ar = _mm256_broadcast_ss(a1 + 2 * k);
+                        ai = _mm256_broadcast_ss(a1 + 2 * k + 1);
+                        r10 = _mm256_fmadd_ps(ar, b0, r10);
+                        r11 = _mm256_fmadd_ps(ar, b1, r11);
+                        q10 = _mm256_fmadd_ps(ai, s0, q10);
+                        q11 = _mm256_fmadd_ps(ai, s1, q11);
+                    }
+
+                    float* p = o0 + 2 * j;
+                    _mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_addsub_ps(r00, q00)));
+                    _mm256_storeu_ps(p + 8, _mm256_add_ps(_mm256_loadu_ps(p + 8), _mm256_addsub_ps(r01, q01)));
+                    if (pair)
+                    {
+                        p = o1 + 2 * j;
+                        _mm256_storeu_ps(p, _mm256_add_ps(_mm256_loadu_ps(p), _mm256_addsub_ps(r10, q10)));
+                        _mm256_storeu_ps(p + 8, _mm256_add_ps(_mm256_loadu_ps(p + 8), _mm256_addsub_ps(r11, q11)));
+                    }
+                }
+
+                for (; j < jEnd; j++)
+                {
+                    for (size_t r = 0; r < (pair ? 2 : 1); r++)
+                    {
+                        const float* aRow = (r == 0) ? a0 : a1;
+                        float* oRow = (r == 0) ? o0 : o1;
+                        float re = oRow[2 * j];
+                        float im = oRow[2 * j + 1];
+                        for (size_t k = kk; k < kEnd; k++)
+                        {
+                            float br = b[2 * (k * cols + j)];
+                            float bi = b[2 * (k * cols + j) + 1];
+                            re += aRow[2 * k] * br - aRow[2 * k + 1] * bi;
+                            im += aRow[2 * k] * bi + aRow[2 * k + 1] * br;
+                        }
+                        oRow[2 * j] = re;
+                        oRow[2 * j + 1] = im;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
+
+///--------------------------------------------------------
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const double* a, const double* b, double* out)
+{
+    switch (getSimdLevel())
+    {
+#if DENSE_KERNELS_X86
+        case Simd_Level_t::avx512:
+            if (cols == 1)
+            {
+                multiplyVectorDoubleAvx512(rows, inner, a, b, out);
+            }
+            else
+            {
+                multiplyDoubleAvx512(rows, inner, cols, a, b, out);
+            }
+            break;
+
+        case Simd_Level_t::avx2:
+            if (cols == 1)
+            {
+                multiplyVectorDoubleAvx2(rows, inner, a, b, out);
+            }
+            else
+            {
+                multiplyDoubleAvx2(rows, inner, cols, a, b, out);
+            }
+            break;
+#endif
+
+        default:
+            denseMultiply<double>(rows, inner, cols, a, b, out);
+    }
+}
+
+///--------------------------------------------------------
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const Complex_C_t* a, const Complex_C_t* b, Complex_C_t* out)
+{
+    const double* aData = reinterpret_cast<const double*>(a);
+    const double* bData = reinterpret_cast<const double*>(b);
+    double* outData = reinterpret_cast<double*>(out);
+
+    switch (getSimdLevel())
+    {
+#if DENSE_KERNELS_X86
+        case Simd_Level_t::avx512:
+            if (cols == 1)
+            {
+                multiplyVectorComplexAvx512(rows, inner, aData, bData, outData);
+            }
+            else
+            {
+                multiplyComplexAvx512(rows, inner, cols, aData, bData, outData);
+            }
+            break;
+
+        case Simd_Level_t::avx2:
+            if (cols == 1)
+            {
+                multiplyVectorComplexAvx2(rows, inner, aData, bData, outData);
+            }
+            else
+            {
+                multiplyComplexAvx2(rows, inner, cols, aData, bData, outData);
+            }
+            break;
+#endif
+
+        default:
+            denseMultiply<Complex_C_t>(rows, inner, cols, a, b, out);
+    }
+}
+
+///--------------------------------------------------------
+void denseMultiply(const size_t& rows, const size_t& inner, const size_t& cols,
+    const Complex_F_t* a, const Complex_F_t* b, Complex_F_t* out)
+{
+    const float* aData = reinterpret_cast<const float*>(a);
+    const float* bData = reinterpret_cast<const float*>(b);
+    float* outData = reinterpret_cast<float*>(out);
+
+    switch (getSimdLevel())
+    {
+#if DENSE_KERNELS_X86
+        // Every AVX-512 CPU has AVX2, the single precision factors are bandwidth bound anyway
+        case Simd_Level_t::avx512:
+        case Simd_Level_t::avx2:
+            multiplySingleComplexAvx2(rows, inner, cols, aData, bData, outData);
+            break;
+#endif
+
+        default:
+            multiplySingleComplex(rows, inner, cols, aData, bData, outData);
+    }
+}
+
+///--------------------------------------------------------
+void denseTranspose(const size_t& rows, const size_t& cols, const double* src, double* dst)
+{
+    // Transposes are bound by memory traffic, wider registers do not help past AVX2
+#if DENSE_KERNELS_X86
+    if (getSimdLevel() != Simd_Level_t::scalar)
+    {
+        transposeDoubleAvx2(rows, cols, src, dst);
+        return;
+    }
+#endif
+
+    denseTranspose<double>(rows, cols, src, dst);
+}
+
+///--------------------------------------------------------
+void denseTranspose(const size_t& rows, const size_t& cols, const Complex_C_t* src, Complex_C_t* dst)
+{
+#if DENSE_KERNELS_X86
+    if (getSimdLevel() != Simd_Level_t::scalar)
+    {
+        transposeComplexAvx2(rows, cols, reinterpret_cast<const double*>(src), reinterpret_cast<double*>(dst));
+        return;
+    }
+#endif
+
+    denseTranspose<Complex_C_t>(rows, cols, src, dst);
+}
@@ -0,0 +1,517 @@
+/// ------------------------------------------
+/// @file Domain_Decomposition.cpp
+///
+/// @brief Source for solving a sparse system by subdomains and the Schur complement of their interface
+/// ------------------------------------------
+
+#include "../inc/Domain_Decomposition.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#include "../inc/Complex_C.h"
+#include "../inc/Sparse_LU.h"
+#include "../inc/Sparse_Ordering.h"
+#include "../inc/Dense_LU.h"
+#include "../inc/Thread_Pool.h"
+
+/// @brief Interface columns solved together when forming a subdomain's part of the Schur complement
+static const size_t schur_block = 64;
+
+/// @brief One entry coupling a subdomain to the interface
+template <typename T>
+struct Coupling_t
+{
+    /// @brief Row of the entry, local to the subdomain or the index of its interface unknown
+    uint32_t row;
+
+    /// @brief Column of the entry, local to the subdomain or the index of its interface unknown
+    uint32_t col;
+
+    /// @brief Value of the entry
+    T value;
+};
+
+/// @brief Factor of one subdomain and its part of the interface system
+template <typename T>
+struct Subdomain_t
+{
+    /// @brief Unknowns of the subdomain in increasing order
+    std::vector<uint32_t> members;
+
+    /// @brief Factor of the subdomain block A_DD
+    Sparse_LU<T> lu;
+
+    /// @brief Entries of A_DG, local row and interface column
+    std::vector<Coupling_t<T>> to_interface;
+
+    /// @brief Entries of A_GD, interface row and local column
+    std::vector<Coupling_t<T>> from_interface;
+
+    /// @brief Interface unknowns in the columns of A_DG, increasing
+    std::vector<uint32_t> interface_cols;
+
+    /// @brief Interface unknowns in the rows of A_GD, increasing
+    std::vector<uint32_t> interface_rows;
+
+    /// @brief (rows, cols) row major -A_GD * A_DD^-1 * A_DG over interface_rows and interface_cols
+    std::vector<T> schur;
+
+    /// @brief -A_GD * A_DD^-1 * b_D over interface_rows
+    std::vector<T> reduced_rhs;
+};
+
+///--------------------------------------------------------
+/// @brief Finds the sorted, unique interface unknowns used by a list of couplings
+///
+/// @param couplings entries coupling a subdomain to the interface
+/// @param useRow take the row (true) or the column (false) of each entry
+///
+/// @return interface unknowns in increasing order
+template <typename T>
+static std::vector<uint32_t> interfaceIndices(const std::vector<Coupling_t<T>>& couplings, const bool& useRow)
+{
+    std::vector<uint32_t> indices;
+    indices.reserve(couplings.size());
+    for (const Coupling_t<T>& entry : couplings)
+    {
+        indices.push_back(useRow ? entry.row : entry.col);
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    return indices;
+}
+
+///--------------------------------------------------------
+/// @brief Drops empty subdomains and renumbers the rest in order
+///
+/// @param domain subdomain of every unknown, -1 for interface unknowns
+/// @param largest highest subdomain id in domain
+///
+/// @return partition over the renumbered subdomains
+static Domain_Partition_t compactDomains(std::vector<int> domain, const int& largest)
+{
+    std::vector<int> renumber(largest + 1, -1);
+    for (int d : domain)
+    {
+        if (d != -1)
+        {
+            renumber[d] = 0;
+        }
+    }
+
+    Domain_Partition_t partition;
+    for (int& id : renumber)
+    {
+        if (id == 0)
+        {
+            id = partition.domain_count++;
+        }
+    }
+
+    for (int& d : domain)
+    {
+        d = (d == -1) ? -1 : renumber[d];
+    }
+    partition.domain = std::move(domain);
+
+    return partition;
+}
+
+///--------------------------------------------------------
+Domain_Partition_t partitionDomains(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, const size_t& domainCount)
+{
+    std::vector<Dissection_Node_t> tree;
+    std::vector<uint32_t> perm = nestedDissectionOrdering(n, colPtr, rowIdx, tree);
+
+    // Unknowns and first node of the subtree below every separator, the tree is in postorder
+    const size_t nodes = tree.size();
+    std::vector<size_t> weight(nodes, 0);
+    std::vector<uint32_t> first(nodes);
+    std::vector<std::vector<uint32_t>> children(nodes);
+    for (size_t s = 0; s < nodes; s++)
+    {
+        first[s] = children[s].empty() ? s : first[children[s].front()];
+        weight[s] += tree[s].end - tree[s].begin;
+        if (tree[s].parent != -1)
+        {
+            weight[tree[s].parent] += weight[s];
+            children[tree[s].parent].push_back(s);
+        }
+    }
+
+    std::priority_queue<std::pair<size_t, uint32_t>> open;
+    for (size_t s = 0; s < nodes; s++)
+    {
+        if (tree[s].parent == -1)
+        {
+            open.push({weight[s], s});
+        }
+    }
+
+    // Splitting a subtree puts its separator on the interface and its children in the queue
+    std::vector<uint32_t> roots;
+    while (!open.empty() and open.size() + roots.size() < domainCount)
+    {
+        uint32_t s = open.top().second;
+        open.pop();
+        if (children[s].empty())
+        {
+            roots.push_back(s);
+            continue;
+        }
+
+        for (uint32_t child : children[s])
+        {
+            open.push({weight[child], child});
+        }
+    }
+    for (; !open.empty(); open.pop())
+    {
+        roots.push_back(open.top().second);
+    }
+
+    // Subdomains numbered by where they start in the ordering
+    std::sort(roots.begin(), roots.end(), [&](const uint32_t& a, const uint32_t& b)
+    {
+        return tree[first[a]].begin < tree[first[b]].begin;
+    });
+
+    Domain_Partition_t partition;
+    partition.domain.assign(n, -1);
+    partition.domain_count = roots.size();
+    for (size_t d = 0; d < roots.size(); d++)
+    {
+        for (uint32_t pos = tree[first[roots[d]]].begin; pos < tree[roots[d]].end; pos++)
+        {
+            partition.domain[perm[pos]] = d;
+        }
+    }
+
+    return partition;
+}
+
+///--------------------------------------------------------
+Domain_Partition_t separateDomains(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<int> domain)
+{
+    if (domain.size() != n)
+    {
+        throw std::invalid_argument("Partition must give a subdomain for every unknown");
+    }
+
+    int largest = -1;
+    for (int d : domain)
+    {
+        if (d < -1)
+        {
+            throw std::invalid_argument("Subdomain ids must be at least -1, -1 places an unknown on the interface");
+        }
+        largest = std::max(largest, d);
+    }
+
+    // The unknown in the higher numbered subdomain goes to the interface, so the result
+    // only depends on the pattern and the given ids
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            uint32_t i = rowIdx[p];
+            if (domain[i] != -1 and domain[j] != -1 and domain[i] != domain[j])
+            {
+                domain[(domain[i] > domain[j]) ? i : j] = -1;
+            }
+        }
+    }
+
+    return compactDomains(std::move(domain), largest);
+}
+
+///--------------------------------------------------------
+template <typename T>
+void interfaceZeroDiagonals(const Sparse_Matrix<T>& mat, Domain_Partition_t& partition)
+{
+    const size_t n = mat.getRowCount();
+    if (mat.getColCount() != n or partition.domain.size() != n)
+    {
+        throw std::invalid_argument("Partition must give a subdomain for every unknown");
+    }
+
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<T>& values = mat.getValues();
+
+    bool moved = false;
+    for (size_t j = 0; j < n; j++)
+    {
+        if (partition.domain[j] == -1)
+        {
+            continue;
+        }
+
+        T diagonal = (T) 0;
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            if (rowIdx[p] == j)
+            {
+                diagonal = diagonal + values[p];
+            }
+        }
+
+        if (diagonal == (T) 0)
+        {
+            partition.domain[j] = -1;
+            moved = true;
+        }
+    }
+
+    // A subdomain of only zero diagonals is now empty
+    if (moved)
+    {
+        partition = compactDomains(std::move(partition.domain), (int) partition.domain_count - 1);
+    }
+}
+
+///--------------------------------------------------------
+template <typename T>
+Matrix<T> schurComplementSolve(const Sparse_Matrix<T>& mat, const Matrix<T>& rhs,
+    const Domain_Partition_t& partition, const size_t& threadCount)
+{
+    const size_t n = mat.getRowCount();
+    if (mat.getColCount() != n or rhs.getRowCount() != n or rhs.getColCount() != 1)
+    {
+        throw std::invalid_argument("Schur complement solve requires a square matrix and a single column rhs of the same row count");
+    }
+
+    if (partition.domain.size() != n)
+    {
+        throw std::invalid_argument("Partition must give a subdomain for every unknown");
+    }
+
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<T>& values = mat.getValues();
+    const std::vector<int>& domain = partition.domain;
+
+    // Local index of every unknown within its subdomain, or within the interface
+    std::vector<Subdomain_t<T>> subdomains(partition.domain_count);
+    std::vector<uint32_t> interface;
+    std::vector<uint32_t> localIdx(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (domain[i] < -1 or domain[i] >= (int) partition.domain_count)
+        {
+            throw std::invalid_argument("Partition has a subdomain id out of range");
+        }
+
+        std::vector<uint32_t>& group = (domain[i] == -1) ? interface : subdomains[domain[i]].members;
+        localIdx[i] = group.size();
+        group.push_back(i);
+    }
+
+    // Interface columns hold A_DG and A_GG, A_GG starts the Schur complement
+    const size_t interfaceSize = interface.size();
+    std::vector<T> schur(interfaceSize * interfaceSize, (T) 0);
+    for (size_t g = 0; g < interfaceSize; g++)
+    {
+        uint32_t j = interface[g];
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            uint32_t i = rowIdx[p];
+            if (domain[i] == -1)
+            {
+                schur[localIdx[i] * interfaceSize + g] = schur[localIdx[i] * interfaceSize + g] + values[p];
+            }
+            else
+            {
+                subdomains[domain[i]].to_interface.push_back(Coupling_t<T>{localIdx[i], (uint32_t) g, values[p]});
+            }
+        }
+    }
+
+    Thread_Pool pool(threadCount);
+    std::vector<char> singular(subdomains.size(), 0);
+
+    // Subdomains vary in size, idle workers steal from busy ones
+    pool.parallelForStealing(0, subdomains.size(), [&](size_t d)
+    {
+        Subdomain_t<T>& sub = subdomains[d];
+        const size_t size = sub.members.size();
+
+        Sparse_Matrix<T> block(size, size);
+        Matrix<T> blockRhs(size, 1);
+        for (size_t c = 0; c < size; c++)
+        {
+            uint32_t j = sub.members[c];
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                uint32_t i = rowIdx[p];
+                if (domain[i] == (int) d)
+                {
+                    block.add(localIdx[i], c, values[p]);
+                }
+                else if (domain[i] == -1)
+                {
+                    sub.from_interface.push_back(Coupling_t<T>{localIdx[i], (uint32_t) c, values[p]});
+                }
+                else
+                {
+                    throw std::invalid_argument("Partition has an entry joining two subdomains, it must pass through the interface");
+                }
+            }
+            blockRhs.set(c, 0, rhs.get(j, 0));
+        }
+        block.compress();
+        try
+        {
+            sub.lu = Sparse_LU<T>(block);
+        }
+        catch (const std::invalid_argument&)
+        {
+            singular[d] = 1;
+            return;
+        }
+
+        // Couplings are renumbered onto the interface unknowns this subdomain touches
+        sub.interface_cols = interfaceIndices(sub.to_interface, false);
+        sub.interface_rows = interfaceIndices(sub.from_interface, true);
+        for (Coupling_t<T>& entry : sub.to_interface)
+        {
+            entry.col = std::lower_bound(sub.interface_cols.begin(), sub.interface_cols.end(), entry.col) - sub.interface_cols.begin();
+        }
+        for (Coupling_t<T>& entry : sub.from_interface)
+        {
+            entry.row = std::lower_bound(sub.interface_rows.begin(), sub.interface_rows.end(), entry.row) - sub.interface_rows.begin();
+        }
+
+        const size_t rows = sub.interface_rows.size();
+        const size_t cols = sub.interface_cols.size();
+        Matrix<T> solved = sub.lu.solve(blockRhs);
+        sub.reduced_rhs.assign(rows, (T) 0);
+        for (const Coupling_t<T>& entry : sub.from_interface)
+        {
+            sub.reduced_rhs[entry.row] = sub.reduced_rhs[entry.row] - entry.value * solved[entry.col];
+        }
+
+        // A_DD^-1 * A_DG a block of columns at a time, only its product with A_GD is kept
+        sub.schur.assign(rows * cols, (T) 0);
+        if (rows == 0)
+        {
+            return;
+        }
+
+        std::sort(sub.to_interface.begin(), sub.to_interface.end(), [](const Coupling_t<T>& a, const Coupling_t<T>& b)
+        {
+            return a.col < b.col;
+        });
+        auto next = sub.to_interface.begin();
+        for (size_t c0 = 0; c0 < cols; c0 += schur_block)
+        {
+            const size_t width = std::min(schur_block, cols - c0);
+            Matrix<T> coupling(size, width);
+            for (; next != sub.to_interface.end() and next->col < c0 + width; ++next)
+            {
+                coupling.set(next->row, next->col - c0, coupling.get(next->row, next->col - c0) + next->value);
+            }
+
+            Matrix<T> columns = sub.lu.solve(coupling);
+            for (const Coupling_t<T>& entry : sub.from_interface)
+            {
+                T* out = sub.schur.data() + entry.row * cols + c0;
+                const T* in = columns.get_data() + entry.col * width;
+                for (size_t k = 0; k < width; k++)
+                {
+                    out[k] = out[k] - entry.value * in[k];
+                }
+            }
+        }
+    });
+
+    // A_DD can be singular when A is not, the pivot a subdomain needs is then on the interface
+    if (std::find(singular.begin(), singular.end(), 1) != singular.end())
+    {
+        Sparse_LU<T> lu(mat);
+        return lu.solve(rhs);
+    }
+
+    // Contributions are summed in subdomain order so the result does not depend on the thread count
+    std::vector<T> interfaceRhs(interfaceSize);
+    for (size_t g = 0; g < interfaceSize; g++)
+    {
+        interfaceRhs[g] = rhs.get(interface[g], 0);
+    }
+    for (const Subdomain_t<T>& sub : subdomains)
+    {
+        const size_t cols = sub.interface_cols.size();
+        for (size_t r = 0; r < sub.interface_rows.size(); r++)
+        {
+            uint32_t g = sub.interface_rows[r];
+            interfaceRhs[g] = interfaceRhs[g] + sub.reduced_rhs[r];
+            for (size_t c = 0; c < cols; c++)
+            {
+                T& out = schur[g * interfaceSize + sub.interface_cols[c]];
+                out = out + sub.schur[r * cols + c];
+            }
+        }
+    }
+
+    // The interface couples every subdomain, its Schur complement is dense
+    std::vector<T> interfaceRes;
+    if (interfaceSize > 0)
+    {
+        Matrix<T> schurMat(interfaceSize, interfaceSize);
+        Matrix<T> schurRhs(interfaceSize, 1);
+        std::copy(schur.begin(), schur.end(), schurMat.get_data());
+        std::copy(interfaceRhs.begin(), interfaceRhs.end(), schurRhs.get_data());
+        schur.clear();
+        schur.shrink_to_fit();
+
+        Dense_LU<T> dense(schurMat, threadCount);
+        Matrix<T> solved = dense.solve(schurRhs);
+        interfaceRes.assign(solved.get_data(), solved.get_data() + interfaceSize);
+    }
+
+    Matrix<T> result(n, 1);
+    for (size_t g = 0; g < interfaceSize; g++)
+    {
+        result.set(interface[g], 0, interfaceRes[g]);
+    }
+
+    // Every subdomain writes a disjoint set of rows
+    pool.parallelForStealing(0, subdomains.size(), [&](size_t d)
+    {
+        const Subdomain_t<T>& sub = subdomains[d];
+        const size_t size = sub.members.size();
+
+        Matrix<T> blockRhs(size, 1);
+        for (size_t c = 0; c < size; c++)
+        {
+            blockRhs.set(c, 0, rhs.get(sub.members[c], 0));
+        }
+        for (const Coupling_t<T>& entry : sub.to_interface)
+        {
+            T known = entry.value * interfaceRes[sub.interface_cols[entry.col]];
+            blockRhs.set(entry.row, 0, blockRhs.get(entry.row, 0) - known);
+        }
+
+        Matrix<T> solved = sub.lu.solve(blockRhs);
+        for (size_t c = 0; c < size; c++)
+        {
+            result.set(sub.members[c], 0, solved[c]);
+        }
+    });
+
+    return result;
+}
+
+template void interfaceZeroDiagonals<double>(const Sparse_Matrix<double>&, Domain_Partition_t&);
+template void interfaceZeroDiagonals<Complex_C_t>(const Sparse_Matrix<Complex_C_t>&, Domain_Partition_t&);
+
+template Matrix<double> schurComplementSolve<double>(const Sparse_Matrix<double>&, const Matrix<double>&,
+    const Domain_Partition_t&, const size_t&);
+template Matrix<Complex_C_t> schurComplementSolve<Complex_C_t>(const Sparse_Matrix<Complex_C_t>&, const Matrix<Complex_C_t>&,
+    const Domain_Partition_t&, const size_t&);
@@ -0,0 +1,596 @@
+/// ------------------------------------------
+/// @file Netlist_Parser.cpp
+///
+/// @brief Source for reading netlist text into components
+/// ------------------------------------------
+
+#include "../inc/Netlist_Parser.h"
+
+#include <charconv>
+#include <algorithm>
+#include <exception>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///--------------------------------------------------------
+Mapped_File::Mapped_File(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::invalid_argument("Could not open file: " + filename);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        throw std::invalid_argument("Could not read the size of file: " + filename);
+    }
+
+    m_size = info.st_size;
+    if (m_size > 0)
+    {
+        void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            throw std::invalid_argument("Could not map file: " + filename);
+        }
+
+        m_data = static_cast<char*>(mapping);
+        madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+
+    // Mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+///--------------------------------------------------------
+Mapped_File::~Mapped_File()
+{
+    if (m_data != nullptr)
+    {
+        munmap(m_data, m_size);
+    }
+}
+
+///--------------------------------------------------------
+std::string_view Mapped_File::getContent() const
+{
+    return std::string_view(m_data, m_size);
+}
+
+///--------------------------------------------------------
+int Node_Table::intern(std::string_view name)
+{
+    auto it = m_ids.find(name);
+    if (it != m_ids.end())
+    {
+        return it->second;
+    }
+
+    int id = m_names.size();
+    m_names.emplace_back(name);
+    m_ids.emplace(m_names.back(), id);
+    return id;
+}
+
+///--------------------------------------------------------
+int Node_Table::find(std::string_view name) const
+{
+    auto it = m_ids.find(name);
+    if (it == m_ids.end())
+    {
+        return -1;
+    }
+
+    return it->second;
+}
+
+///--------------------------------------------------------
+size_t Node_Table::size() const
+{
+    return m_names.size();
+}
+
+///--------------------------------------------------------
+std::vector<std::string> Node_Table::getNames() const
+{
+    return std::vector<std::string>(m_names.begin(), m_names.end());
+}
+
+///--------------------------------------------------------
+size_t tokenize(std::string_view line, std::string_view* tokens, const size_t& maxTokens)
+{
+    size_t count = 0;
+    size_t pos = line.find_first_not_of(whitespace);
+    while (pos != std::string_view::npos)
+    {
+        size_t end = line.find_first_of(whitespace, pos);
+        if (end == std::string_view::npos)
+        {
+            end = line.size();
+        }
+
+        if (count < maxTokens)
+        {
+            tokens[count] = line.substr(pos, end - pos);
+        }
+        count++;
+
+        pos = line.find_first_not_of(whitespace, end);
+    }
+
+    return count;
+}
+
+/// @brief Components parsed from one chunk of netlist text by one worker
+struct Parse_Chunk_t
+{
+    /// @brief Components in chunk order, lines are counted from the start of the chunk
+    std::vector<Component_t> components;
+
+    /// @brief Nodes first used in the chunk when nodes are declared implicitly, ids are chunk local
+    Node_Table nodes;
+
+    /// @brief Number of newlines in the chunk
+    size_t line_count = 0;
+
+    /// @brief First error thrown while parsing the chunk, the rest of the chunk is skipped
+    std::exception_ptr error;
+};
+
+///--------------------------------------------------------
+/// @brief Cuts text into chunks of about chunkBytes that each end just after a newline
+///
+/// @param content text to cut
+/// @param chunkBytes target size of a chunk
+///
+/// @return start offset of every chunk followed by content.size()
+static std::vector<size_t> splitLineChunks(std::string_view content, const size_t& chunkBytes)
+{
+    std::vector<size_t> starts{0};
+    do
+    {
+        size_t target = starts.back() + chunkBytes;
+        if (target >= content.size())
+        {
+            starts.push_back(content.size());
+            break;
+        }
+
+        const char* lineEnd = static_cast<const char*>(memchr(content.data() + target, '\n', content.size() - target));
+        starts.push_back((lineEnd == nullptr) ? content.size() : lineEnd - content.data() + 1);
+    } while (starts.back() < content.size());
+
+    return starts;
+}
+
+///--------------------------------------------------------
+/// @brief Parses a component line in the form [Symbol char] [component value] [Node1] [Node2]
+///
+/// @tparam F callable taking (std::string_view name, size_t lineNumber) returning a node id
+///
+/// @param line whitespace trimmed line
+/// @param lineNumber line number used in errors and stored in the component
+/// @param nodeId resolves node names to ids
+///
+/// @return parsed component
+///
+/// @throws std::invalid_argument if the line is malformed
+template <typename F>
+static Component_t parseComponent(std::string_view line, const size_t& lineNumber, F&& nodeId)
+{
+    const size_t componentTokens = 4;
+    std::string_view tokens[componentTokens];
+
+    if (tokenize(line, tokens, componentTokens) != componentTokens)
+    {
+        throw std::invalid_argument("Bad component command (line " + std::to_string(lineNumber) + ")");
+    }
+
+    if (tokens[0].size() != 1 or
+        std::find(valid_component_symbols.begin(), valid_component_symbols.end(), tokens[0][0]) == valid_component_symbols.end())
+    {
+        throw std::invalid_argument("Symbol: " + std::string(tokens[0]) + " is not a valid symbol {I,V,R,L,C} (line " +
+            std::to_string(lineNumber) + ")");
+    }
+
+    Component_t comp;
+    comp.symbol = tokens[0][0];
+    comp.line = lineNumber;
+
+    if (comp.symbol == 'I' or comp.symbol == 'V')
+    {
+        // sources may carry a phase in the form [mag],[phase]
+        Complex_P_t phasor = decodePhasor(tokens[1]);
+        comp.value = phasor.m_mag;
+        comp.phase = phasor.m_arg;
+    }
+    else
+    {
+        comp.value = convertCompToValue(tokens[1]);
+        comp.phase = 0;
+    }
+
+    comp.node1 = nodeId(tokens[2], lineNumber);
+    comp.node2 = nodeId(tokens[3], lineNumber);
+
+    return comp;
+}
+
+///--------------------------------------------------------
+Netlist_t parseNetlist(std::string_view content, const size_t& headerLines, const size_t& threadCount)
+{
+    Netlist_t netlist;
+    Node_Table nodes;
+    bool implicitNodes = false;
+    bool declared = false;
+
+    auto declaredNodeId = [&](std::string_view name, const size_t& lineNumber)
+    {
+        if (name == ground_node_name)
+        {
+            return -1;
+        }
+
+        int id = nodes.find(name);
+        if (id == -1)
+        {
+            throw std::invalid_argument("Node name: " + std::string(name) +
+            " is not found in the initial node name delcaration (line " + std::to_string(lineNumber) + ")");
+        }
+
+        return id;
+    };
+
+    auto nodeId = [&](std::string_view name, const size_t& lineNumber)
+    {
+        if (implicitNodes and name != ground_node_name)
+        {
+            return nodes.intern(name);
+        }
+
+        return declaredNodeId(name, lineNumber);
+    };
+
+    auto onLine = [&](std::string_view line, size_t lineNumber)
+    {
+        // First non-empty line should be a space-seperated list of the names of all nodes
+        if (!declared)
+        {
+            declared = true;
+            if (line == implicit_nodes_marker)
+            {
+                implicitNodes = true;
+                return;
+            }
+
+            size_t pos = 0;
+            while (pos < line.size())
+            {
+                size_t end = std::min(line.find_first_of(whitespace, pos), line.size());
+                std::string_view name = line.substr(pos, end - pos);
+
+                if (name == ground_node_name)
+                {
+                    throw std::invalid_argument("GND is a reserved node name and cannot be in the node list");
+                }
+
+                if (nodes.find(name) != -1)
+                {
+                    throw std::invalid_argument("Node name: " + std::string(name) + " is declared more than once");
+                }
+                nodes.intern(name);
+
+                pos = std::min(line.find_first_not_of(whitespace, end), line.size());
+            }
+            return;
+        }
+
+        if (netlist.header.size() < headerLines)
+        {
+            netlist.header.emplace_back(line);
+            netlist.header_lines.push_back(lineNumber);
+            return;
+        }
+
+        netlist.components.push_back(parseComponent(line, lineNumber, nodeId));
+    };
+
+    // Whether a line is the declaration, a header or a component depends on every line
+    // before it, so chunks are parsed in order until the header is complete. A single
+    // chunk left after that is not worth a pool and is parsed here as well
+    std::vector<size_t> chunkStarts = splitLineChunks(content, parse_chunk_bytes);
+    size_t chunkCount = chunkStarts.size() - 1;
+    size_t chunk = 0;
+    size_t lineNumber = 1;
+    auto chunkText = [&](const size_t& idx)
+    {
+        return content.substr(chunkStarts[idx], chunkStarts[idx + 1] - chunkStarts[idx]);
+    };
+
+    do
+    {
+        std::string_view text = chunkText(chunk);
+        forEachLine(text, onLine, lineNumber);
+        lineNumber += std::count(text.begin(), text.end(), '\n');
+        chunk++;
+    } while (chunk < chunkCount and
+        (!(declared and netlist.header.size() == headerLines) or chunkCount - chunk < 2));
+
+    if (!declared)
+    {
+        throw std::invalid_argument("File has no content");
+    }
+
+    // Every later line is a component, chunks are parsed in parallel with chunk relative
+    // line numbers and implicit nodes interned into chunk local tables
+    if (chunk < chunkCount)
+    {
+        size_t firstChunk = chunk;
+        std::vector<Parse_Chunk_t> parts(chunkCount - firstChunk);
+
+        Thread_Pool pool(threadCount);
+        pool.parallelFor(0, parts.size(), [&](size_t idx)
+        {
+            Parse_Chunk_t& part = parts[idx];
+            std::string_view text = chunkText(firstChunk + idx);
+            part.line_count = std::count(text.begin(), text.end(), '\n');
+
+            auto chunkNodeId = [&](std::string_view name, const size_t& chunkLine)
+            {
+                if (implicitNodes and name != ground_node_name)
+                {
+                    return part.nodes.intern(name);
+                }
+
+                // Declared nodes are only read, the table is shared by every worker
+                return declaredNodeId(name, chunkLine);
+            };
+
+            try
+            {
+                forEachLine(text, [&](std::string_view line, size_t chunkLine)
+                {
+                    part.components.push_back(parseComponent(line, chunkLine, chunkNodeId));
+                });
+            }
+            catch (...)
+            {
+                part.error = std::current_exception();
+            }
+        });
+
+        // Chunks are merged in file order, so the first chunk to fail has the first bad line
+        // and implicit nodes get their ids in order of first use as on one thread
+        std::vector<size_t> lineOffsets(parts.size());
+        std::vector<size_t> compOffsets(parts.size());
+        std::vector<std::vector<int>> idMaps(parts.size());
+        size_t compCount = netlist.components.size();
+        for (size_t idx = 0; idx < parts.size(); idx++)
+        {
+            Parse_Chunk_t& part = parts[idx];
+            if (part.error)
+            {
+                // Reparsed on this thread to report the error with its line in the file
+                forEachLine(chunkText(firstChunk + idx), [&](std::string_view line, size_t fileLine)
+                {
+                    parseComponent(line, fileLine, nodeId);
+                }, lineNumber);
+                std::rethrow_exception(part.error);
+            }
+
+            lineOffsets[idx] = lineNumber - 1;
+            compOffsets[idx] = compCount;
+            lineNumber += part.line_count;
+            compCount += part.components.size();
+
+            if (implicitNodes)
+            {
+                for (const std::string& name : part.nodes.getNames())
+                {
+                    idMaps[idx].push_back(nodes.intern(name));
+                }
+            }
+        }
+
+        netlist.components.resize(compCount);
+        pool.parallelFor(0, parts.size(), [&](size_t idx)
+        {
+            const std::vector<int>& idMap = idMaps[idx];
+            Component_t* out = netlist.components.data() + compOffsets[idx];
+            for (Component_t comp : parts[idx].components)
+            {
+                comp.line += lineOffsets[idx];
+                if (implicitNodes)
+                {
+                    comp.node1 = (comp.node1 == -1) ? -1 : idMap[comp.node1];
+                    comp.node2 = (comp.node2 == -1) ? -1 : idMap[comp.node2];
+                }
+                *out++ = comp;
+            }
+
+            // Chunk storage is released as soon as it is copied
+            std::vector<Component_t>().swap(parts[idx].components);
+        });
+    }
+
+    netlist.node_names = nodes.getNames();
+    if (netlist.node_names.empty())
+    {
+        throw std::invalid_argument("Netlist has no nodes other than GND");
+    }
+
+    return netlist;
+}
+
+///--------------------------------------------------------
+Netlist_t readNetlistFile(const std::string& filename, const size_t& headerLines, const size_t& threadCount)
+{
+    Mapped_File file(filename);
+    return parseNetlist(file.getContent(), headerLines, threadCount);
+}
+
+///--------------------------------------------------------
+std::vector<int> findUngroundedNodes(const Netlist_t& netlist, std::string_view conducting)
+{
+    // Ground is the last set, every node starts in its own set
+    size_t groundSet = netlist.node_names.size();
+    std::vector<size_t> parent(groundSet + 1);
+    std::vector<size_t> setSize(groundSet + 1, 1);
+    for (size_t i = 0; i < parent.size(); i++)
+    {
+        parent[i] = i;
+    }
+
+    auto findRoot = [&](size_t node)
+    {
+        // Path halving keeps the trees shallow without recursion
+        while (parent[node] != node)
+        {
+            parent[node] = parent[parent[node]];
+            node = parent[node];
+        }
+        return node;
+    };
+
+    for (const Component_t& comp : netlist.components)
+    {
+        if (conducting.find(comp.symbol) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        size_t root1 = findRoot(comp.node1 == -1 ? groundSet : comp.node1);
+        size_t root2 = findRoot(comp.node2 == -1 ? groundSet : comp.node2);
+        if (root1 == root2)
+        {
+            continue;
+        }
+
+        // Union by size
+        if (setSize[root1] < setSize[root2])
+        {
+            std::swap(root1, root2);
+        }
+        parent[root2] = root1;
+        setSize[root1] += setSize[root2];
+    }
+
+    std::vector<int> ungrounded;
+    size_t groundRoot = findRoot(groundSet);
+    for (size_t i = 0; i < groundSet; i++)
+    {
+        if (findRoot(i) != groundRoot)
+        {
+            ungrounded.push_back(i);
+        }
+    }
+
+    return ungrounded;
+}
+
+///--------------------------------------------------------
+Complex_P_t decodePhasor(std::string_view phasorStr)
+{
+    size_t comma = phasorStr.find(',');
+    if (comma == std::string_view::npos)
+    {
+        return Complex_P_t{convertCompToValue(phasorStr)};
+    }
+
+    std::string_view phase = phasorStr.substr(comma + 1);
+    if (phase.find(',') != std::string_view::npos)
+    {
+        throw std::invalid_argument(std::string(phasorStr) + " is not a valid phasor");
+    }
+
+    return Complex_P_t{convertCompToValue(phasorStr.substr(0, comma)), convertCompToValue(phase)};
+}
+
+///--------------------------------------------------------
+double convertCompToValue(std::string_view comp)
+{
+    // remove all whitespace
+    size_t first_non_space = comp.find_first_not_of(whitespace);
+    if (first_non_space == std::string_view::npos)
+    {
+        throw std::invalid_argument("Component value is empty");
+    }
+    std::string_view workingComp = comp.substr(first_non_space, comp.find_last_not_of(whitespace) - first_non_space + 1);
+
+    // from_chars does not accept an explicit plus sign
+    if (workingComp.front() == '+')
+    {
+        workingComp.remove_prefix(1);
+    }
+
+    // extract multipler from string
+    char last = workingComp.back();
+    double multiplier = 1;
+    if (!isdigit(last) and last != '.')
+    {
+        switch(last)
+        {
+            case 'p':
+                // Pico
+                multiplier = 1e-12;
+                break;
+
+            case 'n':
+                // Nano
+                multiplier = 1e-9;
+                break;
+
+            case 'u':
+                // Micro
+                multiplier = 1e-6;
+                break;
+
+            case 'm':
+                // Milli
+                multiplier = 1e-3;
+                break;
+
+            case 'k':
+                // Kilo
+                multiplier = 1e3;
+                break;
+
+            case 'M':
+                // Mega
+                multiplier = 1e6;
+                break;
+
+            case 'G':
+                // Giga
+                multiplier = 1e9;
+                break;
+
+            default:
+                // unrecognized multiplier
+                throw std::invalid_argument(std::string(comp) + " cannot be evaluated, " + last + " is not a recognized multiplier.");
+        }
+
+        workingComp.remove_suffix(1);
+    }
+
+    double num = 0;
+    auto [end, err] = std::from_chars(workingComp.data(), workingComp.data() + workingComp.size(), num);
+    if (err != std::errc() or end != workingComp.data() + workingComp.size())
+    {
+        if (multiplier != 1)
+        {
+            throw std::invalid_argument("Only one modifier may be used on a component value: " + std::string(comp));
+        }
+
+        throw std::invalid_argument(std::string(comp) + " is not a valid component value");
+    }
+
+    return num * multiplier;
+}
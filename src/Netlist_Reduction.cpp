@@ -0,0 +1,324 @@
+/// ------------------------------------------
+/// @file Netlist_Reduction.cpp
+///
+/// @brief Source for collapsing a parsed netlist before it is stamped
+/// ------------------------------------------
+
+#include "../inc/Netlist_Reduction.h"
+
+#include <algorithm>
+#include <tuple>
+#include <cmath>
+
+///--------------------------------------------------------
+/// @brief Finds the scale of a passive element's admittance, 1/R, C or 1/L
+///
+/// @note Admittances of one symbol are this scale times the same factor (1, jw or 1/jw),
+/// so elements of one symbol combine in parallel and series like conductances
+///
+/// @param comp R, L or C component
+///
+/// @return admittance scale of the component
+static double admittanceScale(const Component_t& comp)
+{
+    return (comp.symbol == 'C') ? comp.value : 1 / comp.value;
+}
+
+///--------------------------------------------------------
+/// @brief Converts an admittance scale back into a component value
+///
+/// @param symbol R, L or C
+/// @param scale admittance scale, see admittanceScale()
+///
+/// @return resistance, capacitance or inductance
+static double valueFromScale(const char& symbol, const double& scale)
+{
+    return (symbol == 'C') ? scale : 1 / scale;
+}
+
+///--------------------------------------------------------
+Netlist_Reduction_t reduceNetlist(const Netlist_t& netlist, std::string_view mergeable)
+{
+    Netlist_Reduction_t reduction;
+    reduction.node_names = netlist.node_names;
+    size_t nodeCount = netlist.node_names.size();
+
+    // Floating nodes are left for the analysis to report by name
+    std::vector<char> pinned(nodeCount, 0);
+    for (int node : findUngroundedNodes(netlist, std::string(mergeable) + "V"))
+    {
+        pinned[node] = 1;
+    }
+
+    // Sources and anything else that cannot be combined pin both of their nodes
+    std::vector<Component_t> elements;
+    std::vector<char> combinable;
+    elements.reserve(netlist.components.size());
+    combinable.reserve(netlist.components.size());
+    for (const Component_t& comp : netlist.components)
+    {
+        bool passive = mergeable.find(comp.symbol) != std::string_view::npos and
+            comp.value > 0 and std::isfinite(comp.value);
+        if (passive and comp.node1 == comp.node2)
+        {
+            // Both ends on one node, no current flows through it
+            continue;
+        }
+
+        if (!passive)
+        {
+            for (int node : {comp.node1, comp.node2})
+            {
+                if (node != -1)
+                {
+                    pinned[node] = 1;
+                }
+            }
+        }
+
+        elements.push_back(comp);
+        combinable.push_back(passive);
+    }
+    std::vector<char> alive(elements.size(), 1);
+
+    auto otherEnd = [&](const size_t& elem, const int& node)
+    {
+        return (elements[elem].node1 == node) ? elements[elem].node2 : elements[elem].node1;
+    };
+
+    // Parallel elements of one symbol sort next to each other and are folded into the first
+    std::vector<uint32_t> order;
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        if (combinable[i])
+        {
+            order.push_back(i);
+        }
+    }
+
+    auto pairKey = [&](const uint32_t& elem)
+    {
+        const Component_t& comp = elements[elem];
+        return std::make_tuple(comp.symbol, std::min(comp.node1, comp.node2), std::max(comp.node1, comp.node2));
+    };
+    std::sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b)
+    {
+        return std::make_tuple(pairKey(a), a) < std::make_tuple(pairKey(b), b);
+    });
+
+    for (size_t k = 0; k < order.size();)
+    {
+        uint32_t head = order[k];
+        double scale = admittanceScale(elements[head]);
+        size_t next = k + 1;
+        for (; next < order.size() and pairKey(order[next]) == pairKey(head); next++)
+        {
+            scale += admittanceScale(elements[order[next]]);
+            alive[order[next]] = 0;
+            reduction.parallel_merges++;
+        }
+
+        if (next > k + 1)
+        {
+            elements[head].value = valueFromScale(elements[head].symbol, scale);
+        }
+        k = next;
+    }
+
+    // Only combinable elements are tracked, every other element pins its nodes
+    std::vector<std::vector<uint32_t>> incident(nodeCount);
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        if (alive[i] and combinable[i])
+        {
+            for (int node : {elements[i].node1, elements[i].node2})
+            {
+                if (node != -1)
+                {
+                    incident[node].push_back(i);
+                }
+            }
+        }
+    }
+
+    // Removing a node lowers the degree of its neighbours, which are then revisited
+    std::vector<char> removed(nodeCount, 0);
+    std::vector<int> work;
+    for (size_t i = nodeCount; i-- > 0;)
+    {
+        if (!pinned[i])
+        {
+            work.push_back(i);
+        }
+    }
+
+    while (!work.empty())
+    {
+        int node = work.back();
+        work.pop_back();
+        if (removed[node] or pinned[node])
+        {
+            continue;
+        }
+
+        std::vector<uint32_t>& inc = incident[node];
+        inc.erase(std::remove_if(inc.begin(), inc.end(), [&](const uint32_t& elem) { return !alive[elem]; }), inc.end());
+
+        if (inc.size() == 1)
+        {
+            // Dead end, no current flows so the node follows its only neighbour
+            int neighbour = otherEnd(inc[0], node);
+            alive[inc[0]] = 0;
+            removed[node] = 1;
+            inc.clear();
+
+            reduction.eliminated.push_back(Eliminated_Node_t{node, neighbour, -1, 1});
+            reduction.pruned_nodes++;
+            if (neighbour != -1)
+            {
+                work.push_back(neighbour);
+            }
+            continue;
+        }
+
+        if (inc.size() != 2 or elements[inc[0]].symbol != elements[inc[1]].symbol)
+        {
+            continue;
+        }
+
+        // Series pair a - node - b becomes one element a - b, the node divides the voltage between them
+        uint32_t elemA = inc[0];
+        uint32_t elemB = inc[1];
+        int nodeA = otherEnd(elemA, node);
+        int nodeB = otherEnd(elemB, node);
+        double scaleA = admittanceScale(elements[elemA]);
+        double scaleB = admittanceScale(elements[elemB]);
+        char symbol = elements[elemA].symbol;
+
+        alive[elemA] = 0;
+        alive[elemB] = 0;
+        removed[node] = 1;
+        inc.clear();
+        reduction.eliminated.push_back(Eliminated_Node_t{node, nodeA, nodeB, scaleA / (scaleA + scaleB)});
+        reduction.series_merges++;
+
+        if (nodeA != nodeB)
+        {
+            double scale = scaleA * scaleB / (scaleA + scaleB);
+
+            // Fold into an element already joining a and b, searching the smaller non-ground list
+            int near = (nodeA == -1 or (nodeB != -1 and incident[nodeB].size() < incident[nodeA].size())) ? nodeB : nodeA;
+            int far = (near == nodeA) ? nodeB : nodeA;
+            bool folded = false;
+            for (uint32_t elem : incident[near])
+            {
+                if (alive[elem] and elements[elem].symbol == symbol and otherEnd(elem, near) == far)
+                {
+                    elements[elem].value = valueFromScale(symbol, admittanceScale(elements[elem]) + scale);
+                    reduction.parallel_merges++;
+                    folded = true;
+                    break;
+                }
+            }
+
+            if (!folded)
+            {
+                Component_t comp = elements[elemA];
+                comp.node1 = nodeA;
+                comp.node2 = nodeB;
+                comp.value = valueFromScale(symbol, scale);
+                comp.line = std::min(elements[elemA].line, elements[elemB].line);
+
+                uint32_t elem = elements.size();
+                elements.push_back(comp);
+                combinable.push_back(1);
+                alive.push_back(1);
+                for (int end : {nodeA, nodeB})
+                {
+                    if (end != -1)
+                    {
+                        incident[end].push_back(elem);
+                    }
+                }
+            }
+        }
+
+        for (int end : {nodeA, nodeB})
+        {
+            if (end != -1)
+            {
+                work.push_back(end);
+            }
+        }
+    }
+
+    // Remaining nodes keep their relative order
+    reduction.reduced_ids.assign(nodeCount, -1);
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        if (!removed[i])
+        {
+            reduction.reduced_ids[i] = reduction.netlist.node_names.size();
+            reduction.netlist.node_names.push_back(netlist.node_names[i]);
+        }
+    }
+
+    reduction.netlist.header = netlist.header;
+    reduction.netlist.header_lines = netlist.header_lines;
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        if (alive[i])
+        {
+            Component_t comp = elements[i];
+            comp.node1 = (comp.node1 == -1) ? -1 : reduction.reduced_ids[comp.node1];
+            comp.node2 = (comp.node2 == -1) ? -1 : reduction.reduced_ids[comp.node2];
+            reduction.netlist.components.push_back(comp);
+        }
+    }
+
+    // Series elements take the line of their first part, errors still point at the file
+    std::stable_sort(reduction.netlist.components.begin(), reduction.netlist.components.end(),
+        [](const Component_t& a, const Component_t& b) { return a.line < b.line; });
+
+    return reduction;
+}
+
+///--------------------------------------------------------
+template<typename T>
+std::vector<std::pair<std::string, T>> restoreNodeVoltages(const Netlist_Reduction_t& reduction,
+    const std::vector<std::pair<std::string, T>>& reducedResults)
+{
+    size_t nodeCount = reduction.node_names.size();
+    std::vector<T> volts(nodeCount, (T) 0);
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        if (reduction.reduced_ids[i] != -1)
+        {
+            volts[i] = reducedResults.at(reduction.reduced_ids[i]).second;
+        }
+    }
+
+    // Each removed node only depends on nodes removed after it or kept
+    auto voltage = [&](const int& node)
+    {
+        return (node == -1) ? (T) 0 : volts[node];
+    };
+    for (auto it = reduction.eliminated.rbegin(); it != reduction.eliminated.rend(); ++it)
+    {
+        volts[it->node] = voltage(it->node_a) * it->weight + voltage(it->node_b) * (1 - it->weight);
+    }
+
+    std::vector<std::pair<std::string, T>> nodeResults;
+    nodeResults.reserve(nodeCount);
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        nodeResults.push_back({reduction.node_names[i], volts[i]});
+    }
+
+    return nodeResults;
+}
+
+template std::vector<std::pair<std::string, double>> restoreNodeVoltages<double>(const Netlist_Reduction_t&,
+    const std::vector<std::pair<std::string, double>>&);
+template std::vector<std::pair<std::string, Complex_C_t>> restoreNodeVoltages<Complex_C_t>(const Netlist_Reduction_t&,
+    const std::vector<std::pair<std::string, Complex_C_t>>&);
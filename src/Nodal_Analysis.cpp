@@ -6,473 +6,1782 @@
 
 #include "../inc/Nodal_Analysis.h"
 
+#include <exception>
+#include <charconv>
+
+/// @brief Netlists with fewer components are stamped on the calling thread
+static const size_t parallel_stamp_components = 1 << 17;
+
+///--------------------------------------------------------
+/// @brief Solves A*x = b island by island, each connected component of the pattern of A
+/// is extracted as its own system and factored on the thread pool
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (m, m) compressed system matrix
+/// @param rhs (m, 1) right hand side
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return (m, 1) solution
+///
+/// @throws std::invalid_argument if an island is singular
+template<typename T>
+static Matrix<T> solveIslands(const Sparse_Matrix<T>& mat, const Matrix<T>& rhs, const size_t& threadCount)
+{
+    size_t n = mat.getRowCount();
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<T>& values = mat.getValues();
+
+    std::vector<uint32_t> island;
+    size_t islandCount = connectedComponents(n, colPtr, rowIdx, island);
+    if (islandCount == 1)
+    {
+        Sparse_LU<T> lu(mat);
+        return lu.solve(rhs);
+    }
+
+    // Unknowns grouped by island in increasing order, so each island's pattern stays sorted
+    std::vector<size_t> islandStart(islandCount + 1, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        islandStart[island[i] + 1]++;
+    }
+    for (size_t k = 0; k < islandCount; k++)
+    {
+        islandStart[k + 1] += islandStart[k];
+    }
+
+    std::vector<uint32_t> members(n);
+    std::vector<uint32_t> localIdx(n);
+    std::vector<size_t> next(islandStart.begin(), islandStart.end() - 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t slot = next[island[i]]++;
+        members[slot] = i;
+        localIdx[i] = slot - islandStart[island[i]];
+    }
+
+    Matrix<T> voltRes(n, 1);
+    Thread_Pool pool(threadCount);
+
+    // Island sizes vary widely, idle workers steal from busy ones
+    pool.parallelForStealing(0, islandCount, [&](size_t k)
+    {
+        size_t first = islandStart[k];
+        size_t size = islandStart[k + 1] - first;
+
+        // A lone unknown only has its diagonal
+        if (size == 1)
+        {
+            uint32_t i = members[first];
+            if (colPtr[i + 1] == colPtr[i] or values[colPtr[i]] == 0)
+            {
+                throw std::invalid_argument("Matrix is singular, no LU factor exists");
+            }
+            voltRes.set(i, 0, rhs.get(i, 0) / values[colPtr[i]]);
+            return;
+        }
+
+        Sparse_Matrix<T> sub(size, size);
+        Matrix<T> subRhs(size, 1);
+        sub.reserve(colPtr[members[first + size - 1] + 1] - colPtr[members[first]]);
+        for (size_t c = 0; c < size; c++)
+        {
+            uint32_t j = members[first + c];
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                sub.add(localIdx[rowIdx[p]], c, values[p]);
+            }
+            subRhs.set(c, 0, rhs.get(j, 0));
+        }
+        sub.compress();
+
+        Sparse_LU<T> lu(sub);
+        Matrix<T> subRes = lu.solve(subRhs);
+
+        // Every island writes a disjoint set of rows
+        for (size_t c = 0; c < size; c++)
+        {
+            voltRes.set(members[first + c], 0, subRes.get(c, 0));
+        }
+    });
+
+    return voltRes;
+}
+
+///--------------------------------------------------------
+/// @brief Solves a reduced system with the supernodal LU, falling back to the sparse LU
+///
+/// @note The supernodal LU only pivots within a supernode. A node where an inductor and a
+/// capacitor resonate has a zero diagonal and its pivot lies in a later front, such a
+/// system is valid and is refactored with threshold pivoting over every row
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (m, m) compressed system matrix
+/// @param rhs (m, 1) right hand side
+/// @param threadCount number of worker threads, 0 uses the hardware thread count
+///
+/// @return (m, 1) solution
+///
+/// @throws std::invalid_argument if the matrix is singular
+template<typename T>
+static Matrix<T> solveDissection(const Sparse_Matrix<T>& mat, const Matrix<T>& rhs, const size_t& threadCount)
+{
+    try
+    {
+        Supernodal_LU<T> lu(mat, threadCount);
+        return lu.solve(rhs);
+    }
+    catch (const std::invalid_argument&)
+    {
+        Sparse_LU<T> lu(mat);
+        return lu.solve(rhs);
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Finds the subdomains of the unknowns of a reduced system, from the given
+/// node partition or automatically
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (m, m) compressed system matrix
+/// @param reduction mapping of the nodes onto the m unknowns
+/// @param options given or automatic partition and thread count
+///
+/// @return subdomain of every unknown
+///
+/// @throws std::invalid_argument if the partition does not have one entry per node
+template<typename T>
+static Domain_Partition_t partitionUnknowns(const Sparse_Matrix<T>& mat, const Node_Reduction_t<T>& reduction,
+    const Domain_Options_t& options)
+{
+    size_t n = mat.getRowCount();
+    if (options.node_domains.empty())
+    {
+        size_t domainCount = options.domain_count;
+        if (domainCount == 0)
+        {
+            size_t threads = options.thread_count ? options.thread_count : std::max(1u, std::thread::hardware_concurrency());
+            domainCount = domains_per_thread * threads;
+        }
+
+        return partitionDomains(n, mat.getColPointers(), mat.getRowIndices(), domainCount);
+    }
+
+    if (options.node_domains.size() != reduction.node_rows.size())
+    {
+        throw std::invalid_argument("Partition must give a subdomain for every node");
+    }
+
+    // Nodes joined by voltage sources share an unknown, it goes to the interface if they disagree
+    std::vector<int> domain(n, -1);
+    std::vector<char> assigned(n, 0);
+    for (size_t i = 0; i < reduction.node_rows.size(); i++)
+    {
+        int row = reduction.node_rows[i];
+        if (row == -1)
+        {
+            continue;
+        }
+
+        if (!assigned[row])
+        {
+            domain[row] = options.node_domains[i];
+            assigned[row] = 1;
+        }
+        else if (domain[row] != options.node_domains[i])
+        {
+            domain[row] = -1;
+        }
+    }
+
+    return separateDomains(n, mat.getColPointers(), mat.getRowIndices(), std::move(domain));
+}
+
+///--------------------------------------------------------
+/// @brief Solves a reduced system by domain decomposition
+///
+/// @tparam T type of the system (pure real, complex)
+///
+/// @param mat (m, m) compressed system matrix
+/// @param rhs (m, 1) right hand side
+/// @param reduction mapping of the nodes onto the m unknowns
+/// @param options given or automatic partition and thread count
+/// @param stats filled with the number of subdomains and interface unknowns
+///
+/// @return (m, 1) solution
+template<typename T>
+static Matrix<T> solveDomains(const Sparse_Matrix<T>& mat, const Matrix<T>& rhs, const Node_Reduction_t<T>& reduction,
+    const Domain_Options_t& options, Domain_Stats_t& stats)
+{
+    Domain_Partition_t partition = partitionUnknowns(mat, reduction, options);
+    interfaceZeroDiagonals(mat, partition);
+    stats.domain_count = partition.domain_count;
+    stats.interface_size = std::count(partition.domain.begin(), partition.domain.end(), -1);
+
+    return schurComplementSolve(mat, rhs, partition, options.thread_count);
+}
+
 ///--------------------------------------------------------
 std::vector<std::pair<std::string, double>> DCNodalAnalysis(const Nodal_Analysis_DC_t& node_info)
 {
-    Matrix<double> voltRes = node_info.conductance_mat.inverse() % node_info.net_currents;
+    // Solve G*v = i directly, the inverse of G is never needed
+    Sparse_LU<double> lu(node_info.conductance_mat);
+    Matrix<double> voltRes = lu.solve(node_info.net_currents);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    Solve_Diagnostics_t& diagnostics)
+{
+    Sparse_LU<double> lu(node_info.conductance_mat);
+    Matrix<double> voltRes = lu.solve(node_info.net_currents);
+
+    diagnostics.condition_estimate = lu.estimateConditionNumber(node_info.conductance_mat);
+    diagnostics.pivot_growth = lu.getPivotGrowth(node_info.conductance_mat);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCDenseNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount)
+{
+    Dense_LU<double> lu(node_info.conductance_mat.toDense(), threadCount);
+    Matrix<double> voltRes = lu.solve(node_info.net_currents);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCIslandNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount)
+{
+    Matrix<double> voltRes = solveIslands(node_info.conductance_mat, node_info.net_currents, threadCount);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCDissectionNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const size_t& threadCount)
+{
+    Matrix<double> voltRes = solveDissection(node_info.conductance_mat, node_info.net_currents, threadCount);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCDomainNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const Domain_Options_t& options, Domain_Stats_t& stats)
+{
+    Matrix<double> voltRes = solveDomains(node_info.conductance_mat, node_info.net_currents, node_info.reduction,
+        options, stats);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
 
-    std::vector<std::pair<std::string, double>> nodeResults;
-    for (size_t i = 0; i < voltRes.getRowCount(); i++)
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCIterativeNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const PCG_Options_t& options, PCG_Stats_t& stats)
+{
+    Matrix<double> voltRes = conjugateGradient(node_info.conductance_mat, node_info.net_currents, options, stats);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, double>> DCMultigridNodalAnalysis(const Nodal_Analysis_DC_t& node_info,
+    const PCG_Options_t& options, PCG_Stats_t& stats)
+{
+    Matrix<double> voltRes = multigridSolve(node_info.conductance_mat, node_info.net_currents, options, stats);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+Matrix<double> DCMultiSourceNodalAnalysis(const Nodal_Analysis_DC_t& node_info, const Matrix<double>& excitations)
+{
+    if (excitations.getRowCount() != node_info.node_names.size())
     {
-        nodeResults.push_back({node_info.node_names.at(i), voltRes.get(i,0)});
+        throw std::invalid_argument("Excitations must have one row per node");
     }
 
-    return nodeResults;
+    // Node currents are summed onto their unknowns, voltage sources drive every pattern
+    const Node_Reduction_t<double>& reduction = node_info.reduction;
+    size_t patterns = excitations.getColCount();
+    Matrix<double> reducedCurrents(node_info.conductance_mat.getRowCount(), patterns);
+    for (size_t col = 0; col < patterns; col++)
+    {
+        for (size_t row = 0; row < reducedCurrents.getRowCount(); row++)
+        {
+            reducedCurrents.set(row, col, node_info.constraint_currents.get(row, 0));
+        }
+
+        for (size_t i = 0; i < reduction.node_rows.size(); i++)
+        {
+            if (reduction.node_rows[i] != -1)
+            {
+                int row = reduction.node_rows[i];
+                reducedCurrents.set(row, col, reducedCurrents.get(row, col) + excitations.get(i, col));
+            }
+        }
+    }
+
+    // One factorization, every pattern is a column of the same blocked triangular solve
+    Sparse_LU<double> lu(node_info.conductance_mat);
+    Matrix<double> voltRes = lu.solve(reducedCurrents);
+
+    Matrix<double> nodeVolts(reduction.node_rows.size(), patterns);
+    for (size_t col = 0; col < patterns; col++)
+    {
+        std::vector<std::pair<std::string, double>> nodeResults =
+            expandNodeVoltages(node_info.node_names, reduction, voltRes, col);
+        for (size_t i = 0; i < nodeResults.size(); i++)
+        {
+            nodeVolts.set(i, col, nodeResults[i].second);
+        }
+    }
+
+    return nodeVolts;
 }
 
 ///--------------------------------------------------------
-std::vector<std::pair<std::string, Complex_P_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info)
+std::vector<std::pair<std::string, Complex_C_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info)
 {
-    Matrix<Complex_P_t> voltRes = node_info.admittance_mat.inverse() % node_info.net_currents;
+    // Solve Y*v = i directly, the inverse of Y is never needed
+    Sparse_LU<Complex_C_t> lu(node_info.admittance_mat);
+    Matrix<Complex_C_t> voltRes = lu.solve(node_info.net_currents);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    Solve_Diagnostics_t& diagnostics)
+{
+    Sparse_LU<Complex_C_t> lu(node_info.admittance_mat);
+    Matrix<Complex_C_t> voltRes = lu.solve(node_info.net_currents);
+
+    diagnostics.condition_estimate = lu.estimateConditionNumber(node_info.admittance_mat);
+    diagnostics.pivot_growth = lu.getPivotGrowth(node_info.admittance_mat);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACDenseNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount)
+{
+    Dense_LU<Complex_C_t> lu(node_info.admittance_mat.toDense(), threadCount);
+    Matrix<Complex_C_t> voltRes = lu.solve(node_info.net_currents);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACIslandNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount)
+{
+    Matrix<Complex_C_t> voltRes = solveIslands(node_info.admittance_mat, node_info.net_currents, threadCount);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACDissectionNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const size_t& threadCount)
+{
+    Matrix<Complex_C_t> voltRes = solveDissection(node_info.admittance_mat, node_info.net_currents, threadCount);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACDomainNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const Domain_Options_t& options, Domain_Stats_t& stats)
+{
+    Matrix<Complex_C_t> voltRes = solveDomains(node_info.admittance_mat, node_info.net_currents, node_info.reduction,
+        options, stats);
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+/// @brief Finds the infinity norm (largest absolute row sum) of a dense complex matrix
+///
+/// @param mat matrix to find the norm of
+///
+/// @return infinity norm of the matrix
+static double infinityNorm(const Matrix<Complex_C_t>& mat)
+{
+    double norm = 0;
+    for (size_t i = 0; i < mat.getRowCount(); i++)
+    {
+        double rowSum = 0;
+        for (const Complex_C_t& val : mat.row(i))
+        {
+            rowSum += val.absolute();
+        }
+        norm = std::max(norm, rowSum);
+    }
+
+    return norm;
+}
+
+///--------------------------------------------------------
+/// @brief Finds the infinity norm (largest absolute row sum) of a sparse complex matrix
+///
+/// @param mat compressed matrix to find the norm of
+///
+/// @return infinity norm of the matrix
+static double infinityNorm(const Sparse_Matrix<Complex_C_t>& mat)
+{
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<Complex_C_t>& values = mat.getValues();
+    std::vector<double> rowSums(mat.getRowCount(), 0);
+    for (size_t p = 0; p < values.size(); p++)
+    {
+        rowSums[rowIdx[p]] += values[p].absolute();
+    }
+
+    return rowSums.empty() ? 0 : *std::max_element(rowSums.begin(), rowSums.end());
+}
+
+///--------------------------------------------------------
+std::vector<std::pair<std::string, Complex_C_t>> ACMixedNodalAnalysis(const Nodal_Analysis_AC_t& node_info,
+    const Refinement_Options_t& options, Refinement_Stats_t& stats)
+{
+    stats = Refinement_Stats_t();
+
+    // Only the single precision copy is dense, residuals use the sparse double matrix
+    const Sparse_Matrix<Complex_C_t>& admittance = node_info.admittance_mat;
+    const Matrix<Complex_C_t>& currents = node_info.net_currents;
+    size_t n = admittance.getRowCount();
+
+    // Round the system to single precision, entries beyond float range can only be solved in double
+    const std::vector<uint32_t>& colPtr = admittance.getColPointers();
+    const std::vector<uint32_t>& rowIdx = admittance.getRowIndices();
+    const std::vector<Complex_C_t>& values = admittance.getValues();
+    Matrix<Complex_F_t> single(n, n);
+    bool representable = true;
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            Complex_F_t val = cartToSingle(values[p]);
+            representable = representable and std::isfinite(val.m_real) and std::isfinite(val.m_imagine);
+            single.get_data()[rowIdx[p] * n + j] = val;
+        }
+    }
+
+    double matNorm = infinityNorm(admittance);
+    double rhsNorm = infinityNorm(currents);
+    Matrix<Complex_C_t> voltRes(n, 1);
+
+    // r = b - A*x in double precision, returns the normwise backward error of x
+    Matrix<Complex_C_t> residual(n, 1);
+    auto backwardError = [&]() -> double
+    {
+        Matrix<Complex_C_t> product = admittance % voltRes;
+        residual = currents - product;
+
+        double denom = matNorm * infinityNorm(voltRes) + rhsNorm;
+        return (denom == 0) ? 0 : infinityNorm(residual) / denom;
+    };
+
+    if (representable)
+    {
+        try
+        {
+            Dense_LU<Complex_F_t> lu(single, options.thread_count);
+
+            // Solves with the single precision factor, widening the result
+            auto solveSingle = [&](const Matrix<Complex_C_t>& rhs)
+            {
+                Matrix<Complex_F_t> rhsSingle(n, 1);
+                for (size_t i = 0; i < n; i++)
+                {
+                    rhsSingle.get_data()[i] = cartToSingle(rhs.get_data()[i]);
+                }
+
+                Matrix<Complex_F_t> sol = lu.solve(std::move(rhsSingle));
+                Matrix<Complex_C_t> wide(n, 1);
+                for (size_t i = 0; i < n; i++)
+                {
+                    wide.get_data()[i] = singleToCart(sol.get_data()[i]);
+                }
+                return wide;
+            };
+
+            voltRes = solveSingle(currents);
+            double error = backwardError();
+            while (std::isfinite(error) and error > options.tolerance and stats.iterations < options.max_iterations)
+            {
+                voltRes = voltRes + solveSingle(residual);
+                stats.iterations++;
+
+                // Each step should gain several digits, a stalled one means single precision is not enough
+                double next = backwardError();
+                if (!(next < error * 0.5))
+                {
+                    error = next;
+                    break;
+                }
+                error = next;
+            }
+
+            stats.backward_error = error;
+            stats.converged = std::isfinite(error) and error <= options.tolerance;
+        }
+        catch (const std::invalid_argument&)
+        {
+            // Singular in single precision, the double precision factor decides
+            stats.converged = false;
+        }
+    }
+
+    if (!stats.converged)
+    {
+        Dense_LU<Complex_C_t> lu(admittance.toDense(), options.thread_count);
+        voltRes = lu.solve(currents);
+        stats.double_fallback = true;
+        stats.backward_error = backwardError();
+    }
+
+    return expandNodeVoltages(node_info.node_names, node_info.reduction, voltRes);
+}
+
+///--------------------------------------------------------
+void ACSweepNodalAnalysis(const Nodal_Analysis_AC_Sweep_t& sweep,
+    const std::function<void(const double&, const std::vector<std::pair<std::string, Complex_C_t>>&)>& onPoint,
+    const size_t& threadCount)
+{
+    size_t nodeCount = sweep.conductance_mat.getRowCount();
+    std::vector<double> freqs = sweepFrequencies(sweep);
+
+    // Every frequency shares the union of the G, C and Gamma patterns
+    std::vector<std::vector<size_t>> offsets;
+    Sparse_Matrix<Complex_C_t> pattern = unionPattern<Complex_C_t>(
+        {&sweep.conductance_mat, &sweep.capacitance_mat, &sweep.inv_inductance_mat}, offsets);
+    const std::vector<size_t>& condOffsets = offsets[0];
+    const std::vector<size_t>& capOffsets = offsets[1];
+    const std::vector<size_t>& indOffsets = offsets[2];
+
+    // Ordering is computed once and shared by every worker's factor
+    Sparse_LU<Complex_C_t> symbolic;
+    symbolic.analyze(pattern);
+
+    Thread_Pool pool(threadCount);
+    size_t workers = pool.getThreadCount();
+    std::vector<Sparse_LU<Complex_C_t>> factors(workers, symbolic);
+    std::vector<Sparse_Matrix<Complex_C_t>> admittances(workers, pattern);
+    std::vector<Matrix<Complex_C_t>> currents(workers, sweep.net_currents);
+    std::vector<char> factored(workers, 0);
+
+    // Only a bounded window of points is in flight so memory stays flat for long sweeps
+    size_t window = workers * 4;
+    std::vector<Matrix<Complex_C_t>> results(window, Matrix<Complex_C_t>(nodeCount, 1));
+
+    for (size_t first = 0; first < freqs.size(); first += window)
+    {
+        size_t count = std::min(window, freqs.size() - first);
+
+        pool.parallelFor(0, workers, [&](size_t w)
+        {
+            for (size_t idx = w; idx < count; idx += workers)
+            {
+                double omega = 2 * M_PI * freqs.at(first + idx);
+
+                // Y(w) = G + jwC + Gamma/(jw)
+                std::vector<Complex_C_t>& values = admittances[w].getValues();
+                std::fill(values.begin(), values.end(), Complex_C_t{0});
+
+                const std::vector<double>& cond = sweep.conductance_mat.getValues();
+                for (size_t p = 0; p < cond.size(); p++)
+                {
+                    values[condOffsets[p]] += Complex_C_t{cond[p]};
+                }
+
+                const std::vector<double>& cap = sweep.capacitance_mat.getValues();
+                for (size_t p = 0; p < cap.size(); p++)
+                {
+                    values[capOffsets[p]] += Complex_C_t{0, omega * cap[p]};
+                }
+
+                const std::vector<double>& ind = sweep.inv_inductance_mat.getValues();
+                for (size_t p = 0; p < ind.size(); p++)
+                {
+                    values[indOffsets[p]] += Complex_C_t{0, -ind[p] / omega};
+                }
+
+                if (factored[w])
+                {
+                    factors[w].refactor(admittances[w]);
+                }
+                else
+                {
+                    factors[w].factor(admittances[w]);
+                    factored[w] = 1;
+                }
+
+                // i(w) = i + jw * i_C + i_Gamma/(jw), evaluated in one pass into the worker's vector
+                currents[w] = sweep.net_currents + sweep.capacitance_currents * Complex_C_t{0, omega} +
+                    sweep.inv_inductance_currents * Complex_C_t{0, -1 / omega};
+
+                results[idx] = factors[w].solve(currents[w]);
+            }
+        });
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            onPoint(freqs.at(first + idx), expandNodeVoltages(sweep.node_names, sweep.reduction, results[idx]));
+        }
+    }
+}
+
+///--------------------------------------------------------
+std::vector<double> sweepFrequencies(const Nodal_Analysis_AC_Sweep_t& sweep)
+{
+    std::vector<double> freqs;
+    freqs.reserve(sweep.points);
+
+    if (sweep.points == 1)
+    {
+        freqs.push_back(sweep.start_freq);
+        return freqs;
+    }
+
+    for (size_t i = 0; i < sweep.points; i++)
+    {
+        double frac = (double) i / (sweep.points - 1);
+        if (sweep.log_spacing)
+        {
+            freqs.push_back(sweep.start_freq * pow(sweep.stop_freq / sweep.start_freq, frac));
+        }
+        else
+        {
+            freqs.push_back(sweep.start_freq + (sweep.stop_freq - sweep.start_freq) * frac);
+        }
+    }
+
+    return freqs;
+}
+
+///--------------------------------------------------------
+Transient_Stats_t TransientNodalAnalysis(const Nodal_Analysis_Transient_t& tran,
+    const std::function<void(const double&, const std::vector<std::pair<std::string, double>>&)>& onPoint)
+{
+    size_t nodeCount = tran.conductance_mat.getRowCount();
+    Transient_Stats_t stats;
+
+    // Every step size shares the union of the G, C and Gamma patterns and one ordering
+    std::vector<std::vector<size_t>> offsets;
+    Sparse_Matrix<double> system = unionPattern<double>(
+        {&tran.conductance_mat, &tran.capacitance_mat, &tran.inv_inductance_mat}, offsets);
+    Sparse_LU<double> lu;
+    lu.analyze(system);
+
+    // Companion models, backward Euler:  (G + C/h + h*Gamma) x1 = i + (C/h) x0 - y0 + h*i_Gamma
+    //                   trapezoidal:     (G + 2C/h + (h/2)Gamma) x1 = 2i + (2C/h) x0 - G x0 - 2 y0 - (h/2) Gamma x0 + h*i_Gamma
+    // where y is the inductor current into each unknown
+    double capScale = 0;
+    double indScale = 0;
+    double factoredStep = 0;
+    auto factorStep = [&](const double& step)
+    {
+        capScale = (tran.trapezoidal ? 2 : 1) / step;
+        indScale = step / (tran.trapezoidal ? 2 : 1);
+
+        std::vector<double>& values = system.getValues();
+        std::fill(values.begin(), values.end(), 0.0);
+        const std::vector<double>& cond = tran.conductance_mat.getValues();
+        for (size_t p = 0; p < cond.size(); p++)
+        {
+            values[offsets[0][p]] += cond[p];
+        }
+
+        const std::vector<double>& cap = tran.capacitance_mat.getValues();
+        for (size_t p = 0; p < cap.size(); p++)
+        {
+            values[offsets[1][p]] += capScale * cap[p];
+        }
+
+        const std::vector<double>& ind = tran.inv_inductance_mat.getValues();
+        for (size_t p = 0; p < ind.size(); p++)
+        {
+            values[offsets[2][p]] += indScale * ind[p];
+        }
+
+        if (stats.factorizations == 0)
+        {
+            lu.factor(system);
+        }
+        else
+        {
+            lu.refactor(system);
+        }
+        stats.factorizations++;
+        factoredStep = step;
+    };
+
+    const double* sources = tran.net_currents.get_data();
+    const double* indSources = tran.inv_inductance_currents.get_data();
+    std::vector<double> x(nodeCount, 0.0);
+    std::vector<double> y(nodeCount, 0.0);
+    std::vector<double> capX(nodeCount);
+    std::vector<double> condX(nodeCount);
+    std::vector<double> indX(nodeCount);
+    std::vector<double> indNext(nodeCount);
+    Matrix<double> rhs(nodeCount, 1);
+    Matrix<double> xNext(nodeCount, 1);
+    std::vector<double> yNext(nodeCount);
+
+    // One companion model step from (from, fromY), result left in xNext and yNext
+    auto solveStep = [&](const std::vector<double>& from, const std::vector<double>& fromY, const bool& trapezoidal)
+    {
+        double* rhsData = rhs.get_data();
+        sparseMultiply(tran.capacitance_mat, from, capX);
+        if (trapezoidal)
+        {
+            sparseMultiply(tran.conductance_mat, from, condX);
+            sparseMultiply(tran.inv_inductance_mat, from, indX);
+            for (size_t i = 0; i < nodeCount; i++)
+            {
+                rhsData[i] = 2 * sources[i] + capScale * capX[i] - condX[i] - 2 * fromY[i] - indScale * indX[i] +
+                    2 * indScale * indSources[i];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < nodeCount; i++)
+            {
+                rhsData[i] = sources[i] + capScale * capX[i] - fromY[i] + indScale * indSources[i];
+            }
+        }
+
+        xNext = lu.solve(rhs);
+
+        std::vector<double> next(xNext.get_data(), xNext.get_data() + nodeCount);
+        sparseMultiply(tran.inv_inductance_mat, next, indNext);
+        for (size_t i = 0; i < nodeCount; i++)
+        {
+            double indTerm = trapezoidal ? indScale * (indNext[i] + indX[i] - 2 * indSources[i]) :
+                indScale * (indNext[i] - indSources[i]);
+            yNext[i] = fromY[i] + indTerm;
+        }
+    };
+
+    // One step of size factoredStep from (x, y). The zero state at power up is not a solution of the
+    // network, which the trapezoidal rule would carry forward as ringing, so the first step is taken as
+    // two backward Euler half steps instead. Those have exactly the same matrix so need no refactor.
+    std::vector<double> xHalf(nodeCount);
+    std::vector<double> yHalf(nodeCount);
+    auto takeStep = [&](const bool& startup)
+    {
+        if (!tran.trapezoidal or !startup)
+        {
+            solveStep(x, y, tran.trapezoidal);
+            return;
+        }
+
+        solveStep(x, y, false);
+        std::copy(xNext.get_data(), xNext.get_data() + nodeCount, xHalf.begin());
+        yHalf = yNext;
+        solveStep(xHalf, yHalf, false);
+    };
+
+    auto emit = [&](const double& time)
+    {
+        Matrix<double> state(nodeCount, 1);
+        std::copy(x.begin(), x.end(), state.get_data());
+        onPoint(time, expandNodeVoltages(tran.node_names, tran.reduction, state));
+    };
+
+    emit(0);
+
+    if (!tran.adaptive)
+    {
+        // Steps are evened out to land on the stop time, so one factorization covers them all
+        size_t steps = std::max<size_t>(1, std::ceil(tran.stop_time / tran.time_step - 1e-9));
+        double step = tran.stop_time / steps;
+        factorStep(step);
+        for (size_t k = 1; k <= steps; k++)
+        {
+            takeStep(k == 1);
+            std::copy(xNext.get_data(), xNext.get_data() + nodeCount, x.begin());
+            y.swap(yNext);
+            stats.steps++;
+            emit(k * step);
+        }
+
+        return stats;
+    }
+
+    // Truncation error from divided differences through the last order + 1 accepted points,
+    // LTE = errConst * h^(order+1) * (order+1)! * DD[order+1]
+    size_t order = tran.trapezoidal ? 2 : 1;
+    double errConst = tran.trapezoidal ? 1.0 / 12 : 1.0 / 2;
+    std::vector<double> times = {0};
+    std::vector<std::vector<double>> history = {x};
+
+    double maxStep = tran.time_step;
+    double minStep = maxStep * 1e-9;
+    double step = maxStep / 100;
+    double time = 0;
+    std::vector<double> dd;
+    while (time < tran.stop_time * (1 - 1e-12))
+    {
+        double tryStep = std::min(step, tran.stop_time - time);
+        if (tryStep != factoredStep)
+        {
+            factorStep(tryStep);
+        }
+        takeStep(stats.steps == 0);
+
+        double errRatio = -1;
+        if (history.size() == order + 1)
+        {
+            // Divided differences of every unknown through the history and the new point
+            std::vector<double> pointTimes = times;
+            pointTimes.push_back(time + tryStep);
+            double factorial = 1;
+            for (size_t k = 2; k <= order + 1; k++)
+            {
+                factorial *= k;
+            }
+
+            errRatio = 0;
+            for (size_t i = 0; i < nodeCount; i++)
+            {
+                dd.clear();
+                for (const std::vector<double>& past : history)
+                {
+                    dd.push_back(past[i]);
+                }
+                dd.push_back(xNext.get_data()[i]);
+
+                for (size_t level = 1; level <= order + 1; level++)
+                {
+                    for (size_t k = 0; k + level < dd.size(); k++)
+                    {
+                        dd[k] = (dd[k + 1] - dd[k]) / (pointTimes[k + level] - pointTimes[k]);
+                    }
+                }
+
+                double lte = errConst * std::pow(tryStep, order + 1) * factorial * std::fabs(dd[0]);
+                double allowed = tran.abs_tol + tran.rel_tol * std::fabs(xNext.get_data()[i]);
+                errRatio = std::max(errRatio, lte / allowed);
+            }
+        }
+
+        double growth = (errRatio > 0) ? 0.9 * std::pow(errRatio, -1.0 / (order + 1)) : 2;
+        if (errRatio > 1)
+        {
+            stats.rejected_steps++;
+            step = tryStep * std::max(0.25, growth);
+            if (step < minStep)
+            {
+                throw std::invalid_argument("Transient step fell below " + std::to_string(minStep) + "s at t = " +
+                    std::to_string(time) + "s");
+            }
+            continue;
+        }
+
+        time += tryStep;
+        std::copy(xNext.get_data(), xNext.get_data() + nodeCount, x.begin());
+        y.swap(yNext);
+        stats.steps++;
+        emit(time);
+
+        times.push_back(time);
+        history.push_back(x);
+        if (history.size() > order + 1)
+        {
+            times.erase(times.begin());
+            history.erase(history.begin());
+        }
+
+        // Only grow in whole doublings once the error is known, so the matrix is refactored rarely
+        if (errRatio >= 0 and growth >= 2)
+        {
+            step = std::min(2 * step, maxStep);
+        }
+    }
+
+    return stats;
+}
+
+///--------------------------------------------------------
+template<typename T>
+Sparse_Matrix<T> unionPattern(const std::vector<const Sparse_Matrix<double>*>& parts, std::vector<std::vector<size_t>>& offsets)
+{
+    size_t rows = parts.at(0)->getRowCount();
+    size_t cols = parts.at(0)->getColCount();
+    Sparse_Matrix<T> pattern(rows, cols);
+    for (const Sparse_Matrix<double>* part : parts)
+    {
+        const std::vector<uint32_t>& colPtr = part->getColPointers();
+        const std::vector<uint32_t>& rowIdx = part->getRowIndices();
+        for (size_t j = 0; j < cols; j++)
+        {
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                pattern.add(rowIdx[p], j, (T) 0);
+            }
+        }
+    }
+    pattern.compress();
+
+    // Where each entry of each part lands in the shared pattern
+    offsets.assign(parts.size(), std::vector<size_t>());
+    for (size_t k = 0; k < parts.size(); k++)
+    {
+        const std::vector<uint32_t>& colPtr = parts[k]->getColPointers();
+        const std::vector<uint32_t>& rowIdx = parts[k]->getRowIndices();
+        offsets[k].reserve(parts[k]->getNonZeroCount());
+        for (size_t j = 0; j < cols; j++)
+        {
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                offsets[k].push_back(pattern.findEntry(rowIdx[p], j));
+            }
+        }
+    }
+
+    return pattern;
+}
+
+///--------------------------------------------------------
+template<typename T>
+void addAdmittance(Sparse_Matrix<T>& mat, const T& admittance, const int& node1, const int& node2)
+{
+    if (node1 != -1)
+    {
+        mat.add(node1, node1, admittance);
+
+        // apply negative to col of opposite node if not ground
+        if (node2 != -1)
+        {
+            mat.add(node1, node2, (T) 0 - admittance);
+        }
+    }
+
+    if (node2 != -1)
+    {
+        mat.add(node2, node2, admittance);
+
+        // apply negative to col of opposite node if not ground
+        if (node1 != -1)
+        {
+            mat.add(node2, node1, (T) 0 - admittance);
+        }
+    }
+}
+
+///--------------------------------------------------------
+template<typename T>
+void addCurrent(Matrix<T>& net_currents, const T& current, const int& node1, const int& node2)
+{
+    // Current sources are always pointing into node 1, away from node 2
+    if (node1 != -1)
+    {
+        net_currents.set(node1, 0, net_currents.get(node1, 0) + current);
+    }
+
+    if (node2 != -1)
+    {
+        net_currents.set(node2, 0, net_currents.get(node2, 0) - current);
+    }
+}
+
+///--------------------------------------------------------
+template<typename T>
+void addCurrent(Current_Stamps_t<T>& stamps, const T& current, const int& node1, const int& node2)
+{
+    if (node1 != -1)
+    {
+        stamps.emplace_back(node1, current);
+    }
 
-    std::vector<std::pair<std::string, Complex_P_t>> nodeResults;
-    for (size_t i = 0; i < voltRes.getRowCount(); i++)
+    if (node2 != -1)
     {
-        nodeResults.push_back({node_info.node_names.at(i), voltRes.get(i,0)});
+        stamps.emplace_back(node2, (T) 0 - current);
     }
-
-    return nodeResults;
 }
 
 ///--------------------------------------------------------
-std::vector<std::string> split(const std::string& str, const char& delim)
+/// @brief Adds recorded current stamps onto a net current matrix in order
+///
+/// @param net_currents (m, 1) matrix of net currents to add to
+/// @param stamps (row, current) pairs to add
+template<typename T>
+static void applyCurrentStamps(Matrix<T>& net_currents, const Current_Stamps_t<T>& stamps)
 {
-    std::stringstream ss(str);
-    std::string token;
-    std::vector<std::string> tokens;
-    while (getline(ss, token, delim))
+    for (const std::pair<int, T>& stamp : stamps)
     {
-        tokens.push_back(token);
+        net_currents.set(stamp.first, 0, net_currents.get(stamp.first, 0) + stamp.second);
     }
-    return tokens;
 }
 
 ///--------------------------------------------------------
-std::vector<std::string> parseTextContent(const std::string& filename)
+/// @brief Stamps every component of a netlist, large netlists are split into one
+/// contiguous range of components per thread, each stamping its own triplets and
+/// current stamps, merged in file order so the sums match stamping on one thread
+///
+/// @tparam Y type of admittance (pure real, complex)
+/// @tparam T type of the currents (pure real, complex)
+/// @tparam F callable taking (const Component_t&, Sparse_Matrix<Y>&, Current_Stamps_t<T>& currents,
+/// Current_Stamps_t<T>& known_currents)
+///
+/// @param components components to stamp
+/// @param mat matrix the triplets are merged into, compressed on return
+/// @param currents (m, 1) matrix the source currents are added to
+/// @param known_currents (m, 1) matrix the voltage source driven currents are added to
+/// @param stamp stamps one component
+///
+/// @throws the error of the first component, in file order, that cannot be stamped
+template<typename Y, typename T, typename F>
+static void stampComponents(const std::vector<Component_t>& components, Sparse_Matrix<Y>& mat,
+    Matrix<T>& currents, Matrix<T>& known_currents, F&& stamp)
 {
-    std::ifstream file(filename);
-    std::vector<std::string> fileLines;
-
-    std::string line;
-    while (std::getline(file, line))
+    if (components.size() < parallel_stamp_components)
     {
-        line.erase(0, line.find_first_not_of(whitespace));
-
-        // Skip lines commented out or blank lines
-        if (line.substr(0, 2) != "//" and line.size() != 0)
-        {
-            fileLines.push_back(line);
-        }
-        else
+        Current_Stamps_t<T> currentStamps;
+        Current_Stamps_t<T> knownStamps;
+        mat.reserve(4 * components.size());
+        for (const Component_t& comp : components)
         {
-            // Pushing blank strings onto list so line numbers are correct
-            fileLines.push_back("");
+            stamp(comp, mat, currentStamps, knownStamps);
         }
+
+        applyCurrentStamps(currents, currentStamps);
+        applyCurrentStamps(known_currents, knownStamps);
+        mat.compress();
+        return;
     }
 
-    return fileLines;
-}
+    Thread_Pool pool;
+    size_t partCount = pool.getThreadCount();
+    std::vector<Sparse_Matrix<Y>> parts(partCount, Sparse_Matrix<Y>(mat.getRowCount(), mat.getColCount()));
+    std::vector<Current_Stamps_t<T>> currentStamps(partCount);
+    std::vector<Current_Stamps_t<T>> knownStamps(partCount);
+    std::vector<std::exception_ptr> errors(partCount);
 
-///--------------------------------------------------------
-template<typename T>
-void addAdmittance(Matrix<T>& mat, const T& admittance, const int& node1, const int& node2)
-{
-    if (node1 != -1)
+    pool.parallelFor(0, partCount, [&](size_t idx)
     {
-        T newVal = mat.get(node1, node1) + admittance;
-        mat.set(node1, node1, newVal);
+        size_t first = (components.size() * idx) / partCount;
+        size_t last = (components.size() * (idx + 1)) / partCount;
+        parts[idx].reserve(4 * (last - first));
 
-        // apply negative to col of opposite node if not ground
-        if (node2 != -1)
+        try
         {
-            newVal = mat.get(node1, node2) - admittance;
-            mat.set(node1, node2, newVal);
+            for (size_t i = first; i < last; i++)
+            {
+                stamp(components[i], parts[idx], currentStamps[idx], knownStamps[idx]);
+            }
         }
-    }
+        catch (...)
+        {
+            errors[idx] = std::current_exception();
+        }
+    });
 
-    if (node2 != -1)
+    for (size_t idx = 0; idx < partCount; idx++)
     {
-        T newVal = mat.get(node2, node2) + admittance;
-        mat.set(node2, node2, newVal);
-
-        // apply negative to col of opposite node if not ground
-        if (node1 != -1)
+        if (errors[idx])
         {
-            newVal = mat.get(node2, node1) - admittance;
-            mat.set(node2, node1, newVal);
+            std::rethrow_exception(errors[idx]);
         }
+
+        applyCurrentStamps(currents, currentStamps[idx]);
+        applyCurrentStamps(known_currents, knownStamps[idx]);
     }
+
+    mat.compress(parts, pool);
 }
 
 ///--------------------------------------------------------
-Nodal_Analysis_DC_t readDCAnalysisFile(const std::string& filename)
+template<typename T>
+Node_Reduction_t<T> reduceVoltageSources(const Netlist_t& netlist, const std::function<T(const Component_t&)>& sourceValue)
 {
-    std::vector<std::string> fileLines = parseTextContent(filename);
-
-    auto it = std::find_if_not(fileLines.begin(), fileLines.end(),
-                [](const std::string& x) { return x.empty();});
-    if (it == fileLines.end())
-    {
-        throw std::invalid_argument("File has no content");
-    }
-
-    // First non-empty line should be a space-seperated list of the names of all nodes
-    std::vector<std::string> node_names = split(fileLines.at(std::distance(fileLines.begin(), it)), ' ');
-    if (std::find(node_names.begin(), node_names.end(), ground_node_name) != node_names.end())
+    // Union-find over the nodes plus ground (the last entry), each entry holds its
+    // voltage above its parent so finding a root also gives the offset to it
+    size_t nodeCount = netlist.node_names.size();
+    size_t ground = nodeCount;
+    std::vector<size_t> parent(nodeCount + 1);
+    std::vector<size_t> setSize(nodeCount + 1, 1);
+    std::vector<T> offset(nodeCount + 1, (T) 0);
+    for (size_t i = 0; i <= nodeCount; i++)
     {
-        throw std::invalid_argument("GND is a reserved node name and cannot be in the node list");
+        parent[i] = i;
     }
 
-    Nodal_Analysis_DC_t analysis{
-        node_names,
-        Matrix<double>(node_names.size(), node_names.size()),
-        Matrix<double>(node_names.size(), 1)
-        };
-
-    // Start at the first line after the net names
-    for (size_t i = std::distance(fileLines.begin(), it) + 1; i < fileLines.size(); i++)
+    std::vector<size_t> path;
+    auto findRoot = [&](size_t node)
     {
-        // skip empty lines
-        if (fileLines.at(i).empty())
-        {
-            continue;
-        }
-
-        // Each line should be in the following form:
-        // [Symbol char] [component value] [Node1] [Node2]
-        auto lineSplit = split(fileLines.at(i), ' ');
-
-        if (lineSplit.size() != 4)
+        path.clear();
+        while (parent[node] != node)
         {
-            throw std::invalid_argument("Bad component command (line " + std::to_string(i+1) + ")");
+            path.push_back(node);
+            node = parent[node];
         }
 
-        if (lineSplit.at(0).size() != 1 or
-            std::find(valid_component_symbols.begin(), valid_component_symbols.end(), lineSplit.at(0)[0]) == valid_component_symbols.end())
+        // Point the whole path straight at the root, nearest the root first
+        for (size_t k = path.size(); k-- > 0;)
         {
-            throw std::invalid_argument("Symbol: " + lineSplit.at(0) + " is not a valid symbol {I,V,R,L,C} (line " + std::to_string(i+1)+ ")");
+            size_t up = parent[path[k]];
+            if (up != node)
+            {
+                offset[path[k]] = offset[path[k]] + offset[up];
+            }
+            parent[path[k]] = node;
         }
 
-        char symbol = lineSplit.at(0)[0];
-        // Write conversion for 10k -> 10,000 etc
-        double magnitude = convertCompToValue(lineSplit.at(1));
-        std::pair<std::string, std::string> nodes_connected{lineSplit.at(2), lineSplit.at(3)};
+        return node;
+    };
 
-        if (symbol == 'L' or symbol == 'C')
+    for (const Component_t& comp : netlist.components)
+    {
+        if (comp.symbol != 'V')
         {
-            throw std::invalid_argument("Symbol: " + std::to_string(symbol) + " is not allowed in DC analysis {I,V,R} (line " + std::to_string(i+1) + ")");
+            continue;
         }
 
-        // If first node is groud on a direction agnostic component, swap nodes to make sure calculation in correct magnitude
-        if (symbol == 'R' and nodes_connected.first == ground_node_name)
-        {
-            swap(nodes_connected.first, nodes_connected.second);
-        }
+        T volts = sourceValue(comp);
+        size_t node1 = (comp.node1 == -1) ? ground : comp.node1;
+        size_t node2 = (comp.node2 == -1) ? ground : comp.node2;
+        size_t root1 = findRoot(node1);
+        size_t root2 = findRoot(node2);
 
-        int node_idx_1, node_idx_2;
-        if (nodes_connected.first == ground_node_name)
-        {
-            node_idx_1 = -1;
-        }
-        else
+        // V(node1) - V(node2) = volts, with V(node) = V(root) + offset(node)
+        T rootDiff = offset[node1] - offset[node2] - volts;
+        if (root1 == root2)
         {
-            auto it = std::find(node_names.begin(), node_names.end(), nodes_connected.first);
-            if (it == node_names.end())
+            if (absoluteValue(rootDiff) > 1e-9 * std::max({absoluteValue(volts), absoluteValue(offset[node1] - offset[node2]), 1.0}))
             {
-                throw std::invalid_argument("Node name: " + nodes_connected.first +
-                " is not found in the initial node name delcaration (line " + std::to_string(i+1) + ")");
+                throw std::invalid_argument("Voltage sources in a loop do not sum to zero (line " + std::to_string(comp.line) + ")");
             }
-
-            node_idx_1 = std::distance(node_names.begin(), it);
+            continue;
         }
 
-        if (nodes_connected.second == ground_node_name)
+        // Ground always stays a root, otherwise the smaller set joins the larger
+        if (root1 != ground and (root2 == ground or setSize[root1] > setSize[root2]))
         {
-            node_idx_2 = -1;
+            // V(root1) = V(root2) - rootDiff
+            parent[root1] = root2;
+            offset[root1] = (T) 0 - rootDiff;
+            setSize[root2] += setSize[root1];
         }
         else
         {
-            auto it = std::find(node_names.begin(), node_names.end(), nodes_connected.second);
-            if (it == node_names.end())
-            {
-                throw std::invalid_argument("Node name: " + nodes_connected.first +
-                " is not found in the initial node name delcaration (line " + std::to_string(i+1) + ")");
-            }
-
-            node_idx_2 = std::distance(node_names.begin(), it);
+            // V(root2) = V(root1) + rootDiff
+            parent[root2] = root1;
+            offset[root2] = rootDiff;
+            setSize[root1] += setSize[root2];
         }
+    }
 
-        switch(symbol)
+    // Unknowns are numbered in order of the first node of each supernode
+    Node_Reduction_t<T> reduction{std::vector<int>(nodeCount, -1), std::vector<T>(nodeCount, (T) 0), 0};
+    std::vector<int> rootRows(nodeCount + 1, -1);
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        size_t root = findRoot(i);
+        reduction.node_offsets[i] = (root == i) ? (T) 0 : offset[i];
+        if (root == ground)
         {
-            case 'I':
-                // set the net current values for both node columns in the net currents matrix
-                // only if the node is not ground
-                if (node_idx_1 != -1)
-                {
-                    double newVal = analysis.net_currents.get(node_idx_1, 0) + magnitude;
-                    analysis.net_currents.set(node_idx_1, 0, newVal);
-                }
+            continue;
+        }
 
-                if (node_idx_2 != -1)
-                {
-                    double newVal = analysis.net_currents.get(node_idx_2, 0) - magnitude;
-                    analysis.net_currents.set(node_idx_2, 0, newVal);
-                }
-                break;
+        if (rootRows[root] == -1)
+        {
+            rootRows[root] = reduction.unknown_count++;
+        }
+        reduction.node_rows[i] = rootRows[root];
+    }
 
-            case 'V':
-                throw std::invalid_argument("V is not implemented yet");
-                break;
+    return reduction;
+}
 
-            case 'R':
-                // 1 / magnitude is conductance
-                addAdmittance<double>(analysis.conductance_mat, (1/magnitude), node_idx_1, node_idx_2);
-                break;
+///--------------------------------------------------------
+template<typename T>
+std::vector<std::pair<std::string, T>> expandNodeVoltages(const std::vector<std::string>& node_names,
+    const Node_Reduction_t<T>& reduction, const Matrix<T>& solution, const size_t& col)
+{
+    std::vector<std::pair<std::string, T>> nodeResults;
+    nodeResults.reserve(node_names.size());
+    for (size_t i = 0; i < node_names.size(); i++)
+    {
+        T volts = reduction.node_offsets.at(i);
+        if (reduction.node_rows.at(i) != -1)
+        {
+            volts = volts + solution.get(reduction.node_rows[i], col);
         }
+
+        nodeResults.push_back({node_names[i], volts});
     }
 
-    return analysis;
+    return nodeResults;
 }
 
 ///--------------------------------------------------------
-Nodal_Analysis_AC_t readACAnalysisFile(const std::string& filename)
+template<typename Y, typename T, typename C>
+void addReducedAdmittance(Sparse_Matrix<Y>& mat, C& known_currents, const Y& admittance,
+    const int& node1, const int& node2, const Node_Reduction_t<T>& reduction)
 {
-    std::vector<std::string> fileLines = parseTextContent(filename);
+    int row1 = (node1 == -1) ? -1 : reduction.node_rows.at(node1);
+    int row2 = (node2 == -1) ? -1 : reduction.node_rows.at(node2);
 
-    auto it = std::find_if_not(fileLines.begin(), fileLines.end(),
-                [](const std::string& x) { return x.empty();});
-    if (it == fileLines.end())
+    // Both ends on the same unknown (or both fixed), no current depends on the unknowns
+    if (row1 == row2)
     {
-        throw std::invalid_argument("File has no content");
+        return;
     }
 
-    // First non-empty line should be a space-seperated list of the names of all nodes
-    std::vector<std::string> node_names = split(fileLines.at(std::distance(fileLines.begin(), it)), ' ');
-    if (std::find(node_names.begin(), node_names.end(), ground_node_name) != node_names.end())
+    addAdmittance<Y>(mat, admittance, row1, row2);
+
+    // y*(V1 - V2) = y*(x1 - x2) + y*(offset1 - offset2), the known part leaves row 1 and enters row 2
+    T offset1 = (node1 == -1) ? (T) 0 : reduction.node_offsets[node1];
+    T offset2 = (node2 == -1) ? (T) 0 : reduction.node_offsets[node2];
+    T known = admittance * (offset1 - offset2);
+    if (known != (T) 0)
     {
-        throw std::invalid_argument("GND is a reserved node name and cannot be in the node list");
+        addCurrent<T>(known_currents, known, row2, row1);
     }
+}
 
-    double freq = -1;
-    // second non empty line has the frequency
-    it = std::find_if_not(++it, fileLines.end(),
-                [](const std::string& x) { return x.empty();});
-    if (it == fileLines.end())
+///--------------------------------------------------------
+void checkGroundPaths(const Netlist_t& netlist, std::string_view conducting, const std::string& pathName)
+{
+    std::vector<int> ungrounded = findUngroundedNodes(netlist, conducting);
+    if (ungrounded.empty())
     {
-        throw std::invalid_argument("Frequnecy should be stated on line after netnames");
+        return;
     }
-    freq = convertCompToValue(fileLines.at(std::distance(fileLines.begin(), it)));
 
-    if (freq <= 0)
+    std::string names;
+    for (int node : ungrounded)
     {
-        throw std::invalid_argument("Freq must be greater than 0");
+        names += (names.empty() ? "" : ", ") + netlist.node_names[node];
     }
 
-    Nodal_Analysis_AC_t analysis{
-        node_names,
-        Matrix<Complex_P_t>(node_names.size(), node_names.size()),
-        Matrix<Complex_P_t>(node_names.size(), 1)
-        };
-
-    // Start at the first line after the net names and freq (+2)
-    for (size_t i = std::distance(fileLines.begin(), it) + 2; i < fileLines.size(); i++)
-    {
-        // skip empty lines
-        if (fileLines.at(i).empty())
-        {
-            continue;
-        }
+    throw std::invalid_argument("Nodes with no " + pathName + " to GND: " + names);
+}
 
-        // Each line should be in the following form, phase only used on voltage/current sources:
-        // [Symbol char] [component magnitude,phase] [Node1] [Node2]
-        auto lineSplit = split(fileLines.at(i), ' ');
+///--------------------------------------------------------
+Nodal_Analysis_DC_t readDCAnalysisFile(const std::string& filename)
+{
+    return compileDCAnalysis(readNetlistFile(filename, 0));
+}
 
-        if (lineSplit.size() != 4)
+///--------------------------------------------------------
+Nodal_Analysis_DC_t compileDCAnalysis(const Netlist_t& netlist)
+{
+    auto sourcePhaseCheck = [](const Component_t& comp)
+    {
+        if (comp.phase != 0)
         {
-            throw std::invalid_argument("Bad component command (line " + std::to_string(i+1) + ")");
+            throw std::invalid_argument("Sources cannot have a phase in DC analysis (line " + std::to_string(comp.line) + ")");
         }
+    };
 
-        if (lineSplit.at(0).size() != 1 or
-            std::find(valid_component_symbols.begin(), valid_component_symbols.end(), lineSplit.at(0)[0]) == valid_component_symbols.end())
+    // Voltage sources are eliminated first, the rest is stamped onto the remaining unknowns
+    Node_Reduction_t<double> reduction = reduceVoltageSources<double>(netlist,
+        [&](const Component_t& comp)
         {
-            throw std::invalid_argument("Symbol: " + lineSplit.at(0) + " is not a valid symbol {I,V,R,L,C} (line " + std::to_string(i+1)+ ")");
-        }
+            sourcePhaseCheck(comp);
+            return comp.value;
+        });
 
-        char symbol = lineSplit.at(0)[0];
-        std::pair<std::string, std::string> nodes_connected{lineSplit.at(2), lineSplit.at(3)};
+    // A floating node would only show up later as a singular matrix, it is rejected before stamping
+    checkGroundPaths(netlist, "RV", "DC path");
 
-        // If first node is groud on a direction agnostic component, swap nodes to make sure calculation in correct magnitude
-        if (symbol == 'R' and nodes_connected.first == ground_node_name)
-        {
-            swap(nodes_connected.first, nodes_connected.second);
-        }
+    // A network fully fixed by sources keeps one unused unknown so the system is never empty
+    size_t unknownCount = std::max<size_t>(1, reduction.unknown_count);
+    Nodal_Analysis_DC_t analysis{
+        netlist.node_names,
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Matrix<double>(unknownCount, 1),
+        reduction,
+        Matrix<double>(unknownCount, 1)
+        };
+    if (reduction.unknown_count == 0)
+    {
+        analysis.conductance_mat.add(0, 0, 1);
+    }
 
-        int node_idx_1, node_idx_2;
-        if (nodes_connected.first == ground_node_name)
-        {
-            node_idx_1 = -1;
-        }
-        else
+    // Triplets are summed into compressed storage as the stamps are merged
+    stampComponents<double, double>(netlist.components, analysis.conductance_mat, analysis.net_currents,
+        analysis.constraint_currents,
+        [&](const Component_t& comp, Sparse_Matrix<double>& mat, Current_Stamps_t<double>& currents,
+            Current_Stamps_t<double>& knownCurrents)
         {
-            auto it = std::find(node_names.begin(), node_names.end(), nodes_connected.first);
-            if (it == node_names.end())
+            switch(comp.symbol)
             {
-                throw std::invalid_argument("Node name: " + nodes_connected.first +
-                " is not found in the initial node name delcaration (line " + std::to_string(i+1) + ")");
+                case 'I':
+                    sourcePhaseCheck(comp);
+                    addCurrent<double>(currents, comp.value,
+                        comp.node1 == -1 ? -1 : reduction.node_rows.at(comp.node1),
+                        comp.node2 == -1 ? -1 : reduction.node_rows.at(comp.node2));
+                    break;
+
+                case 'V':
+                    // eliminated by reduceVoltageSources
+                    break;
+
+                case 'R':
+                    // 1 / magnitude is conductance
+                    addReducedAdmittance<double, double>(mat, knownCurrents, (1/comp.value), comp.node1, comp.node2, reduction);
+                    break;
+
+                default:
+                    throw std::invalid_argument("Symbol: " + std::string(1, comp.symbol) +
+                        " is not allowed in DC analysis {I,V,R} (line " + std::to_string(comp.line) + ")");
             }
+        });
 
-            node_idx_1 = std::distance(node_names.begin(), it);
-        }
+    analysis.net_currents += analysis.constraint_currents;
+
+    return analysis;
+}
+
+///--------------------------------------------------------
+Nodal_Analysis_AC_t readACAnalysisFile(const std::string& filename)
+{
+    return compileACAnalysis(readNetlistFile(filename, 1));
+}
+
+///--------------------------------------------------------
+Nodal_Analysis_AC_t compileACAnalysis(const Netlist_t& netlist)
+{
+    // line after the net names has the frequency
+    if (netlist.header.size() < 1)
+    {
+        throw std::invalid_argument("Frequnecy should be stated on line after netnames");
+    }
 
-        if (nodes_connected.second == ground_node_name)
+    double freq = convertCompToValue(netlist.header.at(0));
+    if (freq <= 0)
+    {
+        throw std::invalid_argument("Freq must be greater than 0");
+    }
+
+    // Voltage sources are eliminated first, the rest is stamped onto the remaining unknowns
+    Node_Reduction_t<Complex_C_t> reduction = reduceVoltageSources<Complex_C_t>(netlist,
+        [](const Component_t& comp)
         {
-            node_idx_2 = -1;
-        }
-        else
+            return polarToCart(Complex_P_t{comp.value, comp.phase});
+        });
+
+    checkGroundPaths(netlist, "RLCV", "path");
+
+    // A network fully fixed by sources keeps one unused unknown so the system is never empty
+    size_t unknownCount = std::max<size_t>(1, reduction.unknown_count);
+    Nodal_Analysis_AC_t analysis{
+        netlist.node_names,
+        Sparse_Matrix<Complex_C_t>(unknownCount, unknownCount),
+        Matrix<Complex_C_t>(unknownCount, 1),
+        reduction
+        };
+    if (reduction.unknown_count == 0)
+    {
+        analysis.admittance_mat.add(0, 0, Complex_C_t{1});
+    }
+
+    // Voltage source driven currents are stamped in line with the sources, both land in net_currents
+    double omega = 2 * M_PI * freq;
+    stampComponents<Complex_C_t, Complex_C_t>(netlist.components, analysis.admittance_mat, analysis.net_currents,
+        analysis.net_currents,
+        [&](const Component_t& comp, Sparse_Matrix<Complex_C_t>& mat, Current_Stamps_t<Complex_C_t>& currents,
+            Current_Stamps_t<Complex_C_t>&)
         {
-            auto it = std::find(node_names.begin(), node_names.end(), nodes_connected.second);
-            if (it == node_names.end())
+            switch(comp.symbol)
             {
-                throw std::invalid_argument("Node name: " + nodes_connected.first +
-                " is not found in the initial node name delcaration (line " + std::to_string(i+1) + ")");
+                case 'I':
+                    addCurrent<Complex_C_t>(currents, polarToCart(Complex_P_t{comp.value, comp.phase}),
+                        comp.node1 == -1 ? -1 : reduction.node_rows.at(comp.node1),
+                        comp.node2 == -1 ? -1 : reduction.node_rows.at(comp.node2));
+                    break;
+
+                case 'V':
+                    // eliminated by reduceVoltageSources
+                    break;
+
+                case 'R':
+                    // 1 / magnitude is addmittance
+                    addReducedAdmittance<Complex_C_t, Complex_C_t>(mat, currents,
+                        Complex_C_t{1 / comp.value, 0}, comp.node1, comp.node2, reduction);
+                    break;
+
+                case 'C':
+                    // jwC
+                    addReducedAdmittance<Complex_C_t, Complex_C_t>(mat, currents,
+                        Complex_C_t{0, omega * comp.value}, comp.node1, comp.node2, reduction);
+                    break;
+
+                case 'L':
+                    // 1 / jwL = -j / wL
+                    addReducedAdmittance<Complex_C_t, Complex_C_t>(mat, currents,
+                        Complex_C_t{0, -1 / (omega * comp.value)}, comp.node1, comp.node2, reduction);
+                    break;
+
+                default:
+                    // should be caught by the parser, but keeping this here for completeness
+                    throw std::invalid_argument("Unkwon symbol: " + std::string(1, comp.symbol));
             }
+        });
 
-            node_idx_2 = std::distance(node_names.begin(), it);
-        }
+    return analysis;
+}
 
-        if (symbol == 'I')
-        {
-            // set the net current values for both node columns in the net currents matrix
-            // only if the node is not ground
-            Complex_P_t phasor = decodePhasor(lineSplit.at(1));
+///--------------------------------------------------------
+Matrix<double> readExcitationFile(const std::string& filename, const std::vector<std::string>& node_names)
+{
+    Node_Table nodes;
+    for (const std::string& name : node_names)
+    {
+        nodes.intern(name);
+    }
 
-            if (node_idx_1 != -1)
-            {
-                Complex_P_t newVal = analysis.net_currents.get(node_idx_1, 0) + phasor;
-                analysis.net_currents.set(node_idx_1, 0, newVal);
-            }
+    Mapped_File file(filename);
+    std::vector<size_t> driven_rows;
+    std::vector<std::string_view> tokens;
+    std::vector<double> values;
+    size_t patternCount = 0;
 
-            if (node_idx_2 != -1)
+    forEachLine(file.getContent(), [&](std::string_view line, size_t lineNumber)
+    {
+        tokens.resize(std::max(tokens.size(), tokenize(line, nullptr, 0)));
+        size_t count = tokenize(line, tokens.data(), tokens.size());
+
+        // First non-empty line lists the driven nodes, in the order values are given
+        if (driven_rows.empty())
+        {
+            for (size_t t = 0; t < count; t++)
             {
-                Complex_P_t newVal = analysis.net_currents.get(node_idx_2, 0) - phasor;
-                analysis.net_currents.set(node_idx_2, 0, newVal);
+                int id = nodes.find(tokens[t]);
+                if (id == -1)
+                {
+                    throw std::invalid_argument("Node name: " + std::string(tokens[t]) +
+                    " is not found in the netlist node name delcaration (line " + std::to_string(lineNumber) + ")");
+                }
+
+                driven_rows.push_back(id);
             }
+            return;
         }
-        else if (symbol == 'V')
+
+        if (count != driven_rows.size())
         {
-            throw std::invalid_argument("V is not implemented yet");
+            throw std::invalid_argument("Excitation must have one current per driven node (line " + std::to_string(lineNumber) + ")");
         }
-        else if (symbol == 'R')
+
+        for (size_t t = 0; t < count; t++)
         {
-            // 1 / magnitude is addmittance
-            Complex_P_t res_admittance{1 / convertCompToValue(lineSplit.at(1)), 0};
-            addAdmittance<Complex_P_t>(analysis.admittance_mat, res_admittance, node_idx_1, node_idx_2);
+            values.push_back(convertCompToValue(tokens[t]));
         }
-        else if (symbol == 'C')
+        patternCount++;
+    });
+
+    if (driven_rows.empty())
+    {
+        throw std::invalid_argument("File has no content");
+    }
+
+    if (patternCount == 0)
+    {
+        throw std::invalid_argument("Excitation file has no patterns");
+    }
+
+    Matrix<double> excitations(node_names.size(), patternCount);
+    for (size_t col = 0; col < patternCount; col++)
+    {
+        for (size_t k = 0; k < driven_rows.size(); k++)
         {
-            Complex_C_t cap_admittance{0, 2 * M_PI * freq * convertCompToValue(lineSplit.at(1))};
-            addAdmittance<Complex_P_t>(analysis.admittance_mat, cartToPolar(cap_admittance), node_idx_1, node_idx_2);
+            size_t row = driven_rows.at(k);
+            excitations.set(row, col, excitations.get(row, col) + values.at(col * driven_rows.size() + k));
         }
-        else if (symbol == 'L')
+    }
+
+    return excitations;
+}
+
+///--------------------------------------------------------
+std::vector<int> readPartitionFile(const std::string& filename, const std::vector<std::string>& node_names)
+{
+    Node_Table nodes;
+    for (const std::string& name : node_names)
+    {
+        nodes.intern(name);
+    }
+
+    Mapped_File file(filename);
+    std::vector<int> node_domains(node_names.size(), -1);
+    std::string_view tokens[2];
+
+    forEachLine(file.getContent(), [&](std::string_view line, size_t lineNumber)
+    {
+        if (tokenize(line, tokens, 2) != 2)
         {
-            Complex_C_t ind_admittance{0, 1 / (2 * M_PI * freq * convertCompToValue(lineSplit.at(1)))};
-            addAdmittance<Complex_P_t>(analysis.admittance_mat, cartToPolar(ind_admittance), node_idx_1, node_idx_2);
+            throw std::invalid_argument("Partition lines must be a node name and a subdomain id (line " +
+                std::to_string(lineNumber) + ")");
         }
-        else
+
+        int id = nodes.find(tokens[0]);
+        if (id == -1)
         {
-            // should be caught by prevoius check, but keeping this here for completeness
-            throw std::invalid_argument("Unkwon symbol: " + std::to_string(symbol));
+            throw std::invalid_argument("Node name: " + std::string(tokens[0]) +
+            " is not found in the netlist node name delcaration (line " + std::to_string(lineNumber) + ")");
         }
-    }
 
-    return analysis;
+        int domain = 0;
+        auto [end, error] = std::from_chars(tokens[1].data(), tokens[1].data() + tokens[1].size(), domain);
+        if (error != std::errc() or end != tokens[1].data() + tokens[1].size() or domain < -1)
+        {
+            throw std::invalid_argument("Subdomain id: " + std::string(tokens[1]) +
+                " must be a whole number of at least -1 (line " + std::to_string(lineNumber) + ")");
+        }
+
+        node_domains[id] = domain;
+    });
+
+    return node_domains;
+}
+
+///--------------------------------------------------------
+Nodal_Analysis_AC_Sweep_t readACSweepFile(const std::string& filename)
+{
+    return compileACSweep(readNetlistFile(filename, 1));
 }
 
 ///--------------------------------------------------------
-Complex_P_t decodePhasor(const std::string& phasorStr)
+Nodal_Analysis_AC_Sweep_t compileACSweep(const Netlist_t& netlist)
 {
-    std::vector<std::string> phasorSplit = split(phasorStr, ',');
+    // line after the net names has the sweep range
+    if (netlist.header.size() < 1)
+    {
+        throw std::invalid_argument("Sweep should be stated on line after netnames");
+    }
+
+    std::string_view sweepSplit[4];
+    if (tokenize(netlist.header.at(0), sweepSplit, 4) != 4 or (sweepSplit[3] != "lin" and sweepSplit[3] != "log"))
+    {
+        throw std::invalid_argument("Sweep should be in the form [start freq] [stop freq] [points] [lin/log] (line " +
+            std::to_string(netlist.header_lines.at(0)) + ")");
+    }
+
+    double startFreq = convertCompToValue(sweepSplit[0]);
+    double stopFreq = convertCompToValue(sweepSplit[1]);
+    double points = convertCompToValue(sweepSplit[2]);
+
+    if (startFreq <= 0 or stopFreq < startFreq)
+    {
+        throw std::invalid_argument("Sweep frequencies must be greater than 0 with stop freq >= start freq");
+    }
 
-    if (phasorSplit.size() == 1)
+    if (points < 1 or points != floor(points))
     {
-        return Complex_P_t{convertCompToValue(phasorSplit.at(0))};
+        throw std::invalid_argument("Sweep point count must be a whole number above 0");
     }
-    else if (phasorSplit.size() == 2)
+
+    // Voltage sources are eliminated first, the rest is stamped onto the remaining unknowns
+    Node_Reduction_t<Complex_C_t> reduction = reduceVoltageSources<Complex_C_t>(netlist,
+        [](const Component_t& comp)
+        {
+            return polarToCart(Complex_P_t{comp.value, comp.phase});
+        });
+
+    checkGroundPaths(netlist, "RLCV", "path");
+
+    // A network fully fixed by sources keeps one unused unknown so the system is never empty
+    size_t unknownCount = std::max<size_t>(1, reduction.unknown_count);
+    Nodal_Analysis_AC_Sweep_t sweep{
+        netlist.node_names,
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Matrix<Complex_C_t>(unknownCount, 1),
+        Matrix<Complex_C_t>(unknownCount, 1),
+        Matrix<Complex_C_t>(unknownCount, 1),
+        reduction,
+        startFreq,
+        stopFreq,
+        (size_t) points,
+        sweepSplit[3] == "log"
+        };
+    if (reduction.unknown_count == 0)
     {
-        return Complex_P_t{convertCompToValue(phasorSplit.at(0)), convertCompToValue(phasorSplit.at(1))};
+        sweep.conductance_mat.add(0, 0, 1);
     }
-    else
+
+    for (const Component_t& comp : netlist.components)
     {
-        throw std::invalid_argument(phasorStr + " is not a valid phasor");
+        switch(comp.symbol)
+        {
+            case 'I':
+                addCurrent<Complex_C_t>(sweep.net_currents, polarToCart(Complex_P_t{comp.value, comp.phase}),
+                    comp.node1 == -1 ? -1 : reduction.node_rows.at(comp.node1),
+                    comp.node2 == -1 ? -1 : reduction.node_rows.at(comp.node2));
+                break;
+
+            case 'V':
+                // eliminated by reduceVoltageSources
+                break;
+
+            case 'R':
+                addReducedAdmittance<double, Complex_C_t>(sweep.conductance_mat, sweep.net_currents,
+                    1 / comp.value, comp.node1, comp.node2, reduction);
+                break;
+
+            case 'C':
+                addReducedAdmittance<double, Complex_C_t>(sweep.capacitance_mat, sweep.capacitance_currents,
+                    comp.value, comp.node1, comp.node2, reduction);
+                break;
+
+            case 'L':
+                addReducedAdmittance<double, Complex_C_t>(sweep.inv_inductance_mat, sweep.inv_inductance_currents,
+                    1 / comp.value, comp.node1, comp.node2, reduction);
+                break;
+
+            default:
+                // should be caught by the parser, but keeping this here for completeness
+                throw std::invalid_argument("Unkwon symbol: " + std::string(1, comp.symbol));
+        }
     }
+
+    // Sum all stamped triplets into compressed storage
+    sweep.conductance_mat.compress();
+    sweep.capacitance_mat.compress();
+    sweep.inv_inductance_mat.compress();
+
+    return sweep;
 }
 
 ///--------------------------------------------------------
-double convertCompToValue(const std::string& comp)
+Nodal_Analysis_Transient_t readTransientAnalysisFile(const std::string& filename)
 {
-    std::string workingComp = comp;
-    // remove all whitespace
-    size_t first_non_space = workingComp.find_first_not_of(whitespace);
-    workingComp.erase(0, first_non_space);
-
-    size_t last_non_space = workingComp.find_last_not_of(whitespace);
-    workingComp.erase(last_non_space + 1);
+    return compileTransientAnalysis(readNetlistFile(filename, 1));
+}
 
-    // extract multipler from string
-    char last = workingComp.at(workingComp.size() - 1);
+///--------------------------------------------------------
+Nodal_Analysis_Transient_t compileTransientAnalysis(const Netlist_t& netlist)
+{
+    // line after the net names has the time range
+    if (netlist.header.size() < 1)
+    {
+        throw std::invalid_argument("Time range should be stated on line after netnames");
+    }
 
-    if (isdigit(last))
+    std::string_view rangeSplit[4];
+    size_t rangeTokens = tokenize(netlist.header.at(0), rangeSplit, 4);
+    if ((rangeTokens != 3 and rangeTokens != 4) or (rangeSplit[2] != "be" and rangeSplit[2] != "trap") or
+        (rangeTokens == 4 and rangeSplit[3] != "fixed" and rangeSplit[3] != "adaptive"))
     {
-        return stod(workingComp);
+        throw std::invalid_argument("Time range should be in the form [stop time] [step] [be/trap] ([fixed/adaptive]) (line " +
+            std::to_string(netlist.header_lines.at(0)) + ")");
     }
 
-    // extract number from string
-    workingComp = workingComp.substr(0, workingComp.size() - 1);
+    double stopTime = convertCompToValue(rangeSplit[0]);
+    double timeStep = convertCompToValue(rangeSplit[1]);
+    if (stopTime <= 0 or timeStep <= 0)
+    {
+        throw std::invalid_argument("Stop time and step must be greater than 0");
+    }
 
-    // Check that rest of component value is completely numeric
-    for (char c : workingComp)
+    auto sourcePhaseCheck = [](const Component_t& comp)
     {
-        // Decimal place dot is only allowed char
-        if (!isdigit(c) and c != '.')
+        if (comp.phase != 0)
         {
-            throw std::invalid_argument("Only one modifier may be used on a component value: " + comp);
+            throw std::invalid_argument("Sources cannot have a phase in transient analysis (line " + std::to_string(comp.line) + ")");
         }
+    };
+
+    // Voltage sources are eliminated first, the rest is stamped onto the remaining unknowns
+    Node_Reduction_t<double> reduction = reduceVoltageSources<double>(netlist,
+        [&](const Component_t& comp)
+        {
+            sourcePhaseCheck(comp);
+            return comp.value;
+        });
+
+    checkGroundPaths(netlist, "RLCV", "path");
+
+    // A network fully fixed by sources keeps one unused unknown so the system is never empty
+    size_t unknownCount = std::max<size_t>(1, reduction.unknown_count);
+    Nodal_Analysis_Transient_t tran{
+        netlist.node_names,
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Sparse_Matrix<double>(unknownCount, unknownCount),
+        Matrix<double>(unknownCount, 1),
+        Matrix<double>(unknownCount, 1),
+        reduction,
+        stopTime,
+        timeStep,
+        rangeSplit[2] == "trap",
+        rangeTokens == 4 and rangeSplit[3] == "adaptive"
+        };
+    if (reduction.unknown_count == 0)
+    {
+        tran.conductance_mat.add(0, 0, 1);
     }
 
-    double num = stod(workingComp);
+    // The offset across a capacitor is constant after t = 0 so draws no current
+    Matrix<double> capacitanceCurrents(unknownCount, 1);
 
-    switch(last)
+    for (const Component_t& comp : netlist.components)
     {
-        case 'p':
-            // Pico
-            return num * pow(10, -12);
+        switch(comp.symbol)
+        {
+            case 'I':
+                sourcePhaseCheck(comp);
+                addCurrent<double>(tran.net_currents, comp.value,
+                    comp.node1 == -1 ? -1 : reduction.node_rows.at(comp.node1),
+                    comp.node2 == -1 ? -1 : reduction.node_rows.at(comp.node2));
+                break;
+
+            case 'V':
+                // eliminated by reduceVoltageSources
+                break;
 
-        case 'n':
-            // Nano
-            return num * pow(10, -9);
+            case 'R':
+                addReducedAdmittance<double, double>(tran.conductance_mat, tran.net_currents,
+                    1 / comp.value, comp.node1, comp.node2, reduction);
+                break;
 
-        case 'u':
-            // Micro
-            return num * pow(10, -6);
+            case 'C':
+                addReducedAdmittance<double, double>(tran.capacitance_mat, capacitanceCurrents,
+                    comp.value, comp.node1, comp.node2, reduction);
+                break;
 
-        case 'm':
-            // Milli
-            return num * pow(10, -3);
+            case 'L':
+                addReducedAdmittance<double, double>(tran.inv_inductance_mat, tran.inv_inductance_currents,
+                    1 / comp.value, comp.node1, comp.node2, reduction);
+                break;
 
-        case 'k':
-            // Kilo
-            return num * pow(10, 3);
+            default:
+                // should be caught by the parser, but keeping this here for completeness
+                throw std::invalid_argument("Unkwon symbol: " + std::string(1, comp.symbol));
+        }
+    }
 
-        case 'M':
-            // Mega
-            return num * pow(10, 6);
+    // Sum all stamped triplets into compressed storage
+    tran.conductance_mat.compress();
+    tran.capacitance_mat.compress();
+    tran.inv_inductance_mat.compress();
 
-        case 'G':
-            // Giga
-            return num * pow(10, 9);
+    return tran;
+}
 
-        default:
-            // unrecognized multiplier
-            throw std::invalid_argument(comp + " cannot be evaluated, " + last + " is not a recognized multiplier.");
-    }
-}
\ No newline at end of file
+// Instantiated for the analyses outside this file (e.g. benchmarks, sessions) that stamp and expand their own solves
+template std::vector<std::pair<std::string, double>> expandNodeVoltages<double>(const std::vector<std::string>&,
+    const Node_Reduction_t<double>&, const Matrix<double>&, const size_t&);
+template std::vector<std::pair<std::string, Complex_C_t>> expandNodeVoltages<Complex_C_t>(const std::vector<std::string>&,
+    const Node_Reduction_t<Complex_C_t>&, const Matrix<Complex_C_t>&, const size_t&);
+template void addCurrent<double>(Matrix<double>&, const double&, const int&, const int&);
@@ -0,0 +1,434 @@
+/// ------------------------------------------
+/// @file Sparse_AMG.cpp
+///
+/// @brief Source for the smoothed aggregation algebraic multigrid hierarchy
+/// used on symmetric positive definite sparse systems
+/// ------------------------------------------
+
+#include "../inc/Sparse_AMG.h"
+
+#include <cmath>
+
+/// @brief Levels smaller than this are not worth splitting across the pool
+static const size_t parallel_rows = 8192;
+
+///--------------------------------------------------------
+Sparse_AMG::Sparse_AMG(const Sparse_Matrix<double>& mat, const AMG_Options_t& options)
+{
+    if (mat.getRowCount() != mat.getColCount())
+    {
+        throw std::invalid_argument("Matrix must be square for multigrid");
+    }
+
+    m_sweeps = options.smoothing_sweeps;
+    m_pool = std::make_unique<Thread_Pool>(options.thread_count);
+    m_mats.push_back(mat);
+
+    while (true)
+    {
+        const Sparse_Matrix<double>& fine = m_mats.back();
+        size_t n = fine.getRowCount();
+        const std::vector<uint32_t>& colPtr = fine.getColPointers();
+        const std::vector<uint32_t>& rowIdx = fine.getRowIndices();
+        const std::vector<double>& values = fine.getValues();
+
+        // Gershgorin bound on the spectral radius of D^-1 * A sets the Jacobi damping
+        std::vector<double> invDiag(n, 0);
+        double radius = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            double rowSum = 0;
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                rowSum += std::fabs(values[p]);
+                if (rowIdx[p] == j)
+                {
+                    invDiag[j] = values[p];
+                }
+            }
+
+            if (!(invDiag[j] > 0))
+            {
+                throw std::invalid_argument("Multigrid requires a positive diagonal, row " + std::to_string(j) + " is not");
+            }
+
+            invDiag[j] = 1 / invDiag[j];
+            radius = std::max(radius, rowSum * invDiag[j]);
+        }
+
+        double omega = 4 / (3 * radius);
+        for (double& scale : invDiag)
+        {
+            scale *= omega;
+        }
+        m_smooth_scale.push_back(invDiag);
+        m_rhs.emplace_back(n, 0);
+        m_x.emplace_back(n, 0);
+        m_residual.emplace_back(n, 0);
+
+        if (n <= options.coarse_size or m_mats.size() >= options.max_levels)
+        {
+            break;
+        }
+
+        size_t aggregateCount = 0;
+        std::vector<uint32_t> aggregates = _aggregate(fine, options.strength_threshold, aggregateCount);
+        if (aggregateCount == 0 or aggregateCount >= n)
+        {
+            // Coarsening has stalled, the current level is solved directly
+            break;
+        }
+
+        // Tentative prolongation, piecewise constant over each aggregate, columns of unit length
+        std::vector<size_t> aggregateSize(aggregateCount, 0);
+        for (uint32_t agg : aggregates)
+        {
+            aggregateSize[agg]++;
+        }
+
+        Sparse_Matrix<double> tentative(n, aggregateCount);
+        tentative.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            tentative.add(i, aggregates[i], 1 / std::sqrt((double) aggregateSize[aggregates[i]]));
+        }
+        tentative.compress();
+
+        // Smoothed prolongation, P = (I - w * D^-1 * A) * P_tentative
+        Sparse_Matrix<double> smoothing = fine % tentative;
+        const std::vector<uint32_t>& smoothColPtr = smoothing.getColPointers();
+        const std::vector<uint32_t>& smoothRowIdx = smoothing.getRowIndices();
+        const std::vector<double>& smoothValues = smoothing.getValues();
+
+        Sparse_Matrix<double> prolong(n, aggregateCount);
+        prolong.reserve(n + smoothing.getNonZeroCount());
+        for (size_t i = 0; i < n; i++)
+        {
+            prolong.add(i, aggregates[i], 1 / std::sqrt((double) aggregateSize[aggregates[i]]));
+        }
+        for (size_t k = 0; k < aggregateCount; k++)
+        {
+            for (size_t p = smoothColPtr[k]; p < smoothColPtr[k + 1]; p++)
+            {
+                prolong.add(smoothRowIdx[p], k, -m_smooth_scale.back()[smoothRowIdx[p]] * smoothValues[p]);
+            }
+        }
+        prolong.compress();
+
+        // Galerkin coarse operator, A_c = P' * A * P
+        Sparse_Matrix<double> restriction = prolong.transpose();
+        Sparse_Matrix<double> coarse = restriction % (fine % prolong);
+        if (options.drop_threshold > 0)
+        {
+            coarse = _drop_weak(coarse, options.drop_threshold);
+        }
+
+        m_prolong.push_back(std::move(prolong));
+        m_restrict.push_back(std::move(restriction));
+        m_mats.push_back(std::move(coarse));
+    }
+
+    m_coarse_lu.analyze(m_mats.back());
+    m_coarse_lu.factor(m_mats.back());
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::vCycle(const std::vector<double>& rhs, std::vector<double>& x)
+{
+    if (rhs.size() != m_x[0].size() or x.size() != m_x[0].size())
+    {
+        throw std::invalid_argument("Multigrid vectors must have one entry per row of the matrix");
+    }
+
+    m_rhs[0] = rhs;
+    m_x[0] = x;
+    _cycle(0);
+    x = m_x[0];
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::precondition(std::vector<double>& vec)
+{
+    std::vector<double> z(vec.size(), 0);
+    vCycle(vec, z);
+    vec.swap(z);
+}
+
+///--------------------------------------------------------
+size_t Sparse_AMG::getLevelCount() const
+{
+    return m_mats.size();
+}
+
+///--------------------------------------------------------
+double Sparse_AMG::getOperatorComplexity() const
+{
+    double total = 0;
+    for (const Sparse_Matrix<double>& mat : m_mats)
+    {
+        total += mat.getNonZeroCount();
+    }
+
+    return total / m_mats.front().getNonZeroCount();
+}
+
+///--------------------------------------------------------
+std::vector<uint32_t> Sparse_AMG::_aggregate(const Sparse_Matrix<double>& mat, const double& threshold, size_t& aggregateCount) const
+{
+    static const uint32_t unaggregated = std::numeric_limits<uint32_t>::max();
+
+    size_t n = mat.getRowCount();
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<double>& values = mat.getValues();
+
+    std::vector<double> diag(n, 0);
+    for (size_t j = 0; j < n; j++)
+    {
+        diag[j] = mat.get(j, j);
+    }
+
+    auto isStrong = [&](const size_t& i, const size_t& p)
+    {
+        uint32_t j = rowIdx[p];
+        return j != i and std::fabs(values[p]) > threshold * std::sqrt(diag[i] * diag[j]);
+    };
+
+    std::vector<uint32_t> aggregates(n, unaggregated);
+    aggregateCount = 0;
+
+    // Phase 1, a node whose strong neighbours are all free seeds an aggregate of its neighbourhood
+    for (size_t i = 0; i < n; i++)
+    {
+        if (aggregates[i] != unaggregated)
+        {
+            continue;
+        }
+
+        bool free = true;
+        bool hasStrong = false;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1] and free; p++)
+        {
+            if (isStrong(i, p))
+            {
+                hasStrong = true;
+                free = (aggregates[rowIdx[p]] == unaggregated);
+            }
+        }
+
+        if (!free or !hasStrong)
+        {
+            continue;
+        }
+
+        aggregates[i] = aggregateCount;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1]; p++)
+        {
+            if (isStrong(i, p))
+            {
+                aggregates[rowIdx[p]] = aggregateCount;
+            }
+        }
+        aggregateCount++;
+    }
+
+    // Phase 2, remaining nodes join the phase 1 aggregate they are most strongly connected to
+    std::vector<uint32_t> seeded = aggregates;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (seeded[i] != unaggregated)
+        {
+            continue;
+        }
+
+        double strongest = 0;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1]; p++)
+        {
+            if (isStrong(i, p) and seeded[rowIdx[p]] != unaggregated and std::fabs(values[p]) > strongest)
+            {
+                strongest = std::fabs(values[p]);
+                aggregates[i] = seeded[rowIdx[p]];
+            }
+        }
+    }
+
+    // Phase 3, what is left forms aggregates with its free strong neighbours, nodes with
+    // no strong neighbours join the aggregate they are most connected to or stand alone
+    for (size_t i = 0; i < n; i++)
+    {
+        if (aggregates[i] != unaggregated)
+        {
+            continue;
+        }
+
+        bool hasStrong = false;
+        double strongest = 0;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1]; p++)
+        {
+            hasStrong = hasStrong or isStrong(i, p);
+            if (rowIdx[p] != i and aggregates[rowIdx[p]] != unaggregated and std::fabs(values[p]) > strongest)
+            {
+                strongest = std::fabs(values[p]);
+                aggregates[i] = aggregates[rowIdx[p]];
+            }
+        }
+
+        if (!hasStrong and aggregates[i] != unaggregated)
+        {
+            continue;
+        }
+
+        aggregates[i] = aggregateCount;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1]; p++)
+        {
+            if (isStrong(i, p) and aggregates[rowIdx[p]] == unaggregated)
+            {
+                aggregates[rowIdx[p]] = aggregateCount;
+            }
+        }
+        aggregateCount++;
+    }
+
+    return aggregates;
+}
+
+///--------------------------------------------------------
+Sparse_Matrix<double> Sparse_AMG::_drop_weak(const Sparse_Matrix<double>& mat, const double& threshold) const
+{
+    size_t n = mat.getRowCount();
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<double>& values = mat.getValues();
+
+    std::vector<double> diag(n, 0);
+    for (size_t j = 0; j < n; j++)
+    {
+        diag[j] = mat.get(j, j);
+    }
+
+    // A weak a_ij is replaced by |a_ij| on a_ii, this adds a positive semi-definite
+    // term so the coarse operator stays definite
+    Sparse_Matrix<double> outMat(n, n);
+    outMat.reserve(mat.getNonZeroCount());
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            uint32_t i = rowIdx[p];
+            if (i != j and std::fabs(values[p]) <= threshold * std::sqrt(diag[i] * diag[j]))
+            {
+                outMat.add(j, j, std::fabs(values[p]));
+            }
+            else
+            {
+                outMat.add(i, j, values[p]);
+            }
+        }
+    }
+    outMat.compress();
+
+    return outMat;
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::_for_rows(const size_t& n, const std::function<void(size_t, size_t)>& fn)
+{
+    size_t workers = m_pool->getThreadCount();
+    if (n < parallel_rows or workers == 1)
+    {
+        fn(0, n);
+        return;
+    }
+
+    m_pool->parallelFor(0, workers, [&](size_t b)
+    {
+        fn((n * b) / workers, (n * (b + 1)) / workers);
+    });
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::_gather(const Sparse_Matrix<double>& mat, const std::vector<double>& x, std::vector<double>& out)
+{
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<double>& values = mat.getValues();
+
+    _for_rows(mat.getColCount(), [&](size_t first, size_t last)
+    {
+        for (size_t j = first; j < last; j++)
+        {
+            double sum = 0;
+            for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+            {
+                sum += values[p] * x[rowIdx[p]];
+            }
+            out[j] = sum;
+        }
+    });
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::_cycle(const size_t& level)
+{
+    std::vector<double>& x = m_x[level];
+    std::vector<double>& rhs = m_rhs[level];
+
+    if (level + 1 == m_mats.size())
+    {
+        Matrix<double> coarseRhs(rhs.size(), 1);
+        std::copy(rhs.begin(), rhs.end(), coarseRhs.get_data());
+        Matrix<double> coarseX = m_coarse_lu.solve(coarseRhs);
+        std::copy(coarseX.get_data(), coarseX.get_data() + x.size(), x.begin());
+        return;
+    }
+
+    _smooth(level);
+
+    // Restrict the residual, solve the coarse error equation from a zero guess
+    std::vector<double>& residual = m_residual[level];
+    _gather(m_mats[level], x, residual);
+    _for_rows(x.size(), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; i++)
+        {
+            residual[i] = rhs[i] - residual[i];
+        }
+    });
+
+    _gather(m_prolong[level], residual, m_rhs[level + 1]);
+    std::fill(m_x[level + 1].begin(), m_x[level + 1].end(), 0.0);
+    _cycle(level + 1);
+
+    // Prolongate the coarse correction, reusing the residual vector
+    _gather(m_restrict[level], m_x[level + 1], residual);
+    _for_rows(x.size(), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; i++)
+        {
+            x[i] += residual[i];
+        }
+    });
+
+    _smooth(level);
+}
+
+///--------------------------------------------------------
+void Sparse_AMG::_smooth(const size_t& level)
+{
+    std::vector<double>& x = m_x[level];
+    const std::vector<double>& rhs = m_rhs[level];
+    const std::vector<double>& scale = m_smooth_scale[level];
+    std::vector<double>& residual = m_residual[level];
+
+    for (size_t sweep = 0; sweep < m_sweeps; sweep++)
+    {
+        _gather(m_mats[level], x, residual);
+        _for_rows(x.size(), [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                x[i] += scale[i] * (rhs[i] - residual[i]);
+            }
+        });
+    }
+}
@@ -0,0 +1,464 @@
+/// ------------------------------------------
+/// @file Sparse_Ordering.cpp
+///
+/// @brief Source for fill reducing orderings and structural analysis of sparse matrices
+/// ------------------------------------------
+
+#include "../inc/Sparse_Ordering.h"
+
+#include <set>
+#include <algorithm>
+#include <utility>
+
+/// @brief Most restarts when searching for a pseudo-peripheral vertex
+static const size_t peripheral_searches = 4;
+
+/// @brief Part of the graph still to be split by nested dissection
+struct Dissection_Subgraph_t
+{
+    /// @brief Vertices of the part
+    std::vector<uint32_t> vertices;
+
+    /// @brief Separator whose removal produced the part, -1 for the whole graph
+    int parent;
+};
+
+///--------------------------------------------------------
+std::vector<std::vector<uint32_t>> symmetricAdjacency(const size_t& n,
+    const std::vector<uint32_t>& colPtr, const std::vector<uint32_t>& rowIdx)
+{
+    std::vector<std::vector<uint32_t>> adj(n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            uint32_t i = rowIdx[p];
+            if (i == j)
+            {
+                continue;
+            }
+
+            adj[i].push_back(j);
+            adj[j].push_back(i);
+        }
+    }
+
+    for (auto& neighbours : adj)
+    {
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    return adj;
+}
+
+///--------------------------------------------------------
+std::vector<uint32_t> minimumDegreeOrdering(const size_t& n,
+    const std::vector<uint32_t>& colPtr, const std::vector<uint32_t>& rowIdx)
+{
+    // Quotient graph: every variable keeps its remaining variable neighbours and the
+    // elements (eliminated pivots) it touches, every element keeps its variable list
+    std::vector<std::vector<uint32_t>> adjVars = symmetricAdjacency(n, colPtr, rowIdx);
+    std::vector<std::vector<uint32_t>> adjElems(n);
+    std::vector<std::vector<uint32_t>> elemVars(n);
+
+    std::vector<char> eliminated(n, 0);
+    std::vector<char> elemAlive(n, 0);
+    std::vector<size_t> degree(n);
+
+    // mark is used to flag members of the current pivot element,
+    // weight holds |L_e \ L_p| for elements adjacent to the pivot element
+    std::vector<size_t> mark(n, 0);
+    std::vector<size_t> weightTag(n, 0);
+    std::vector<size_t> weight(n, 0);
+    size_t tag = 0;
+
+    std::set<std::pair<size_t, uint32_t>> degreeQueue;
+    for (size_t i = 0; i < n; i++)
+    {
+        degree[i] = adjVars[i].size();
+        degreeQueue.insert({degree[i], (uint32_t) i});
+    }
+
+    std::vector<uint32_t> perm;
+    perm.reserve(n);
+
+    std::vector<uint32_t> pivotVars;
+    for (size_t k = 0; k < n; k++)
+    {
+        uint32_t piv = degreeQueue.begin()->second;
+        degreeQueue.erase(degreeQueue.begin());
+        perm.push_back(piv);
+        eliminated[piv] = 1;
+
+        // Pivot element variables are the union of its variable neighbours and the
+        // variables of every element it touches, those elements are absorbed
+        tag++;
+        pivotVars.clear();
+        for (uint32_t v : adjVars[piv])
+        {
+            if (!eliminated[v] and mark[v] != tag)
+            {
+                mark[v] = tag;
+                pivotVars.push_back(v);
+            }
+        }
+
+        for (uint32_t e : adjElems[piv])
+        {
+            if (!elemAlive[e])
+            {
+                continue;
+            }
+
+            for (uint32_t v : elemVars[e])
+            {
+                if (!eliminated[v] and mark[v] != tag)
+                {
+                    mark[v] = tag;
+                    pivotVars.push_back(v);
+                }
+            }
+
+            elemAlive[e] = 0;
+            std::vector<uint32_t>().swap(elemVars[e]);
+        }
+
+        std::vector<uint32_t>().swap(adjVars[piv]);
+        std::vector<uint32_t>().swap(adjElems[piv]);
+        elemVars[piv] = pivotVars;
+        elemAlive[piv] = 1;
+
+        // Find |L_e \ L_p| for every element that shares a variable with the pivot element
+        for (uint32_t i : pivotVars)
+        {
+            for (uint32_t e : adjElems[i])
+            {
+                if (!elemAlive[e])
+                {
+                    continue;
+                }
+
+                if (weightTag[e] != tag)
+                {
+                    weightTag[e] = tag;
+                    weight[e] = elemVars[e].size();
+                }
+                weight[e]--;
+            }
+        }
+
+        for (uint32_t i : pivotVars)
+        {
+            degreeQueue.erase({degree[i], i});
+
+            // Elements entirely inside the pivot element are absorbed into it
+            std::vector<uint32_t>& elems = adjElems[i];
+            size_t elemDegree = 0;
+            size_t kept = 0;
+            for (uint32_t e : elems)
+            {
+                if (!elemAlive[e])
+                {
+                    continue;
+                }
+
+                if (weight[e] == 0)
+                {
+                    elemAlive[e] = 0;
+                    std::vector<uint32_t>().swap(elemVars[e]);
+                    continue;
+                }
+
+                elemDegree += weight[e];
+                elems[kept++] = e;
+            }
+            elems.resize(kept);
+            elems.push_back(piv);
+
+            // Variables in the pivot element are now reached through it
+            std::vector<uint32_t>& vars = adjVars[i];
+            kept = 0;
+            for (uint32_t v : vars)
+            {
+                if (!eliminated[v] and mark[v] != tag)
+                {
+                    vars[kept++] = v;
+                }
+            }
+            vars.resize(kept);
+
+            degree[i] = std::min(n - k - 1, vars.size() + pivotVars.size() - 1 + elemDegree);
+            degreeQueue.insert({degree[i], i});
+        }
+    }
+
+    return perm;
+}
+
+///--------------------------------------------------------
+size_t connectedComponents(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<uint32_t>& component)
+{
+    std::vector<uint32_t> parent(n);
+    std::vector<uint32_t> setSize(n, 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        parent[i] = i;
+    }
+
+    auto findRoot = [&](uint32_t node)
+    {
+        // Path halving keeps the trees shallow without recursion
+        while (parent[node] != node)
+        {
+            parent[node] = parent[parent[node]];
+            node = parent[node];
+        }
+        return node;
+    };
+
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            uint32_t root1 = findRoot(rowIdx[p]);
+            uint32_t root2 = findRoot(j);
+            if (root1 == root2)
+            {
+                continue;
+            }
+
+            // Union by size
+            if (setSize[root1] < setSize[root2])
+            {
+                std::swap(root1, root2);
+            }
+            parent[root2] = root1;
+            setSize[root1] += setSize[root2];
+        }
+    }
+
+    // Number the islands by first appearance so the numbering only depends on the pattern
+    const uint32_t unnumbered = UINT32_MAX;
+    std::vector<uint32_t> rootIsland(n, unnumbered);
+    component.assign(n, 0);
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t root = findRoot(i);
+        if (rootIsland[root] == unnumbered)
+        {
+            rootIsland[root] = count++;
+        }
+        component[i] = rootIsland[root];
+    }
+
+    return count;
+}
+
+///--------------------------------------------------------
+std::vector<uint32_t> nestedDissectionOrdering(const size_t& n, const std::vector<uint32_t>& colPtr,
+    const std::vector<uint32_t>& rowIdx, std::vector<Dissection_Node_t>& tree)
+{
+    std::vector<std::vector<uint32_t>> adj = symmetricAdjacency(n, colPtr, rowIdx);
+
+    // owner limits each search to the subgraph being split, seen and depth belong to the latest search
+    std::vector<size_t> owner(n, 0);
+    std::vector<size_t> seen(n, 0);
+    std::vector<uint32_t> depth(n, 0);
+    size_t ownerTag = 0;
+    size_t searchTag = 0;
+
+    // Breadth first search inside the current subgraph, order is filled level by level
+    std::vector<uint32_t> order;
+    std::vector<size_t> levelStart;
+    auto search = [&](const uint32_t& root)
+    {
+        searchTag++;
+        order.clear();
+        levelStart.assign(1, 0);
+        order.push_back(root);
+        seen[root] = searchTag;
+        depth[root] = 0;
+        for (size_t head = 0; head < order.size(); head++)
+        {
+            uint32_t v = order[head];
+            if (head > 0 and depth[v] != depth[order[head - 1]])
+            {
+                levelStart.push_back(head);
+            }
+
+            for (uint32_t u : adj[v])
+            {
+                if (owner[u] == ownerTag and seen[u] != searchTag)
+                {
+                    seen[u] = searchTag;
+                    depth[u] = depth[v] + 1;
+                    order.push_back(u);
+                }
+            }
+        }
+        levelStart.push_back(order.size());
+    };
+
+    std::vector<std::vector<uint32_t>> nodeVertices;
+    std::vector<int> nodeParent;
+    auto addNode = [&](std::vector<uint32_t> vertices, const int& parent)
+    {
+        nodeVertices.push_back(std::move(vertices));
+        nodeParent.push_back(parent);
+        return (int) nodeParent.size() - 1;
+    };
+
+    std::vector<Dissection_Subgraph_t> pending;
+    if (n > 0)
+    {
+        pending.push_back(Dissection_Subgraph_t{std::vector<uint32_t>(n), -1});
+        for (size_t i = 0; i < n; i++)
+        {
+            pending.back().vertices[i] = i;
+        }
+    }
+
+    while (!pending.empty())
+    {
+        Dissection_Subgraph_t sub = std::move(pending.back());
+        pending.pop_back();
+        ownerTag++;
+        for (uint32_t v : sub.vertices)
+        {
+            owner[v] = ownerTag;
+        }
+
+        // Pieces that fell apart are independent subtrees of the same separator
+        search(sub.vertices[0]);
+        if (order.size() < sub.vertices.size())
+        {
+            size_t firstSearch = searchTag;
+            std::vector<uint32_t> unreached;
+            for (uint32_t v : sub.vertices)
+            {
+                if (seen[v] < firstSearch)
+                {
+                    unreached.push_back(v);
+                }
+            }
+
+            pending.push_back(Dissection_Subgraph_t{order, sub.parent});
+            for (uint32_t v : unreached)
+            {
+                if (seen[v] < firstSearch)
+                {
+                    search(v);
+                    pending.push_back(Dissection_Subgraph_t{order, sub.parent});
+                }
+            }
+            continue;
+        }
+
+        if (sub.vertices.size() <= dissection_leaf_size)
+        {
+            addNode(std::move(sub.vertices), sub.parent);
+            continue;
+        }
+
+        // Restart from the lowest degree vertex of the last level while the graph keeps getting deeper
+        for (size_t attempt = 0; attempt < peripheral_searches; attempt++)
+        {
+            size_t levels = levelStart.size() - 1;
+            uint32_t far = order[levelStart[levels - 1]];
+            for (size_t k = levelStart[levels - 1]; k < order.size(); k++)
+            {
+                if (adj[order[k]].size() < adj[far].size())
+                {
+                    far = order[k];
+                }
+            }
+
+            search(far);
+            if (levelStart.size() - 1 <= levels)
+            {
+                break;
+            }
+        }
+
+        size_t levels = levelStart.size() - 1;
+        if (levels < 3)
+        {
+            // Every vertex is near every other, no useful separator exists
+            addNode(std::move(sub.vertices), sub.parent);
+            continue;
+        }
+
+        // Middle level by vertex count, kept off the ends so both sides are non empty
+        size_t middle = 1;
+        while (middle < levels - 2 and levelStart[middle + 1] <= order.size() / 2)
+        {
+            middle++;
+        }
+
+        // Only the vertices that reach the next level are needed to separate the two sides
+        std::vector<uint32_t> separator;
+        std::vector<uint32_t> nearSide(order.begin(), order.begin() + levelStart[middle]);
+        for (size_t k = levelStart[middle]; k < levelStart[middle + 1]; k++)
+        {
+            uint32_t v = order[k];
+            bool touchesFar = std::any_of(adj[v].begin(), adj[v].end(), [&](const uint32_t& u)
+            {
+                return owner[u] == ownerTag and depth[u] == middle + 1;
+            });
+            (touchesFar ? separator : nearSide).push_back(v);
+        }
+
+        int node = addNode(std::move(separator), sub.parent);
+        pending.push_back(Dissection_Subgraph_t{std::vector<uint32_t>(order.begin() + levelStart[middle + 1], order.end()), node});
+        pending.push_back(Dissection_Subgraph_t{std::move(nearSide), node});
+    }
+
+    // Number the nodes in postorder so every subtree owns a contiguous range of the ordering
+    size_t nodeCount = nodeParent.size();
+    std::vector<std::vector<int>> children(nodeCount);
+    std::vector<int> stack;
+    for (size_t s = 0; s < nodeCount; s++)
+    {
+        if (nodeParent[s] == -1)
+        {
+            stack.push_back(s);
+        }
+        else
+        {
+            children[nodeParent[s]].push_back(s);
+        }
+    }
+    std::reverse(stack.begin(), stack.end());
+
+    std::vector<int> postIndex(nodeCount, -1);
+    std::vector<size_t> nextChild(nodeCount, 0);
+    std::vector<uint32_t> perm;
+    perm.reserve(n);
+    tree.clear();
+    tree.reserve(nodeCount);
+    while (!stack.empty())
+    {
+        int s = stack.back();
+        if (nextChild[s] < children[s].size())
+        {
+            stack.push_back(children[s][nextChild[s]++]);
+            continue;
+        }
+        stack.pop_back();
+
+        postIndex[s] = tree.size();
+        uint32_t begin = perm.size();
+        perm.insert(perm.end(), nodeVertices[s].begin(), nodeVertices[s].end());
+        tree.push_back(Dissection_Node_t{begin, (uint32_t) perm.size(), nodeParent[s]});
+    }
+
+    for (Dissection_Node_t& node : tree)
+    {
+        node.parent = (node.parent == -1) ? -1 : postIndex[node.parent];
+    }
+
+    return perm;
+}
@@ -0,0 +1,311 @@
+/// ------------------------------------------
+/// @file Sparse_PCG.cpp
+///
+/// @brief Source for the iterative solvers of symmetric positive definite
+/// sparse systems, preconditioned conjugate gradients and multigrid
+/// ------------------------------------------
+
+#include "../inc/Sparse_PCG.h"
+
+#include <cmath>
+
+///--------------------------------------------------------
+Incomplete_Cholesky_t incompleteCholesky(const Sparse_Matrix<double>& mat)
+{
+    size_t n = mat.getColCount();
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<double>& values = mat.getValues();
+
+    Incomplete_Cholesky_t factor;
+    factor.row_ptr.assign(n + 1, 0);
+    factor.col_idx.reserve(mat.getNonZeroCount() / 2 + n);
+    factor.values.reserve(mat.getNonZeroCount() / 2 + n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double diag = 0;
+        for (size_t p = colPtr[i]; p < colPtr[i + 1] and rowIdx[p] <= i; p++)
+        {
+            uint32_t j = rowIdx[p];
+            if (j == i)
+            {
+                diag = values[p];
+                continue;
+            }
+
+            // L(i,j) = (A(i,j) - sum_k<j L(i,k) L(j,k)) / L(j,j), both rows are sorted
+            double sum = values[p];
+            size_t a = factor.row_ptr[i];
+            size_t aEnd = factor.col_idx.size();
+            size_t b = factor.row_ptr[j];
+            size_t bEnd = factor.row_ptr[j + 1] - 1;
+            while (a < aEnd and b < bEnd)
+            {
+                if (factor.col_idx[a] == factor.col_idx[b])
+                {
+                    sum -= factor.values[a++] * factor.values[b++];
+                }
+                else if (factor.col_idx[a] < factor.col_idx[b])
+                {
+                    a++;
+                }
+                else
+                {
+                    b++;
+                }
+            }
+
+            factor.col_idx.push_back(j);
+            factor.values.push_back(sum / factor.values[bEnd]);
+        }
+
+        for (size_t p = factor.row_ptr[i]; p < factor.values.size(); p++)
+        {
+            diag -= factor.values[p] * factor.values[p];
+        }
+
+        if (!(diag > 0))
+        {
+            throw std::invalid_argument("Incomplete Cholesky broke down at row " + std::to_string(i) +
+                ", matrix is not positive definite");
+        }
+
+        factor.col_idx.push_back(i);
+        factor.values.push_back(std::sqrt(diag));
+        factor.row_ptr[i + 1] = factor.values.size();
+    }
+
+    return factor;
+}
+
+///--------------------------------------------------------
+void applyIncompleteCholesky(const Incomplete_Cholesky_t& factor, std::vector<double>& vec)
+{
+    size_t n = vec.size();
+
+    // Forward L*y = r, row by row
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t diag = factor.row_ptr[i + 1] - 1;
+        double sum = vec[i];
+        for (size_t p = factor.row_ptr[i]; p < diag; p++)
+        {
+            sum -= factor.values[p] * vec[factor.col_idx[p]];
+        }
+        vec[i] = sum / factor.values[diag];
+    }
+
+    // Backward L'*z = y, rows of L are the columns of L'
+    for (size_t i = n; i-- > 0;)
+    {
+        size_t diag = factor.row_ptr[i + 1] - 1;
+        vec[i] /= factor.values[diag];
+        for (size_t p = factor.row_ptr[i]; p < diag; p++)
+        {
+            vec[factor.col_idx[p]] -= factor.values[p] * vec[i];
+        }
+    }
+}
+
+///--------------------------------------------------------
+void sparseMultiply(const Sparse_Matrix<double>& mat, const std::vector<double>& x, std::vector<double>& out)
+{
+    const std::vector<uint32_t>& colPtr = mat.getColPointers();
+    const std::vector<uint32_t>& rowIdx = mat.getRowIndices();
+    const std::vector<double>& values = mat.getValues();
+
+    out.assign(mat.getRowCount(), 0.0);
+    for (size_t j = 0; j < x.size(); j++)
+    {
+        for (size_t p = colPtr[j]; p < colPtr[j + 1]; p++)
+        {
+            out[rowIdx[p]] += values[p] * x[j];
+        }
+    }
+}
+
+///--------------------------------------------------------
+double dotProduct(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+///--------------------------------------------------------
+std::string preconditionerName(const Preconditioner_t& preconditioner)
+{
+    switch(preconditioner)
+    {
+        case Preconditioner_t::jacobi:
+            return "jacobi";
+
+        case Preconditioner_t::ic0:
+            return "ic0";
+
+        case Preconditioner_t::amg:
+            return "amg";
+    }
+
+    throw std::invalid_argument("Unknown preconditioner");
+}
+
+///--------------------------------------------------------
+Matrix<double> conjugateGradient(const Sparse_Matrix<double>& mat, const Matrix<double>& rhs, const PCG_Options_t& options,
+    PCG_Stats_t& stats)
+{
+    size_t n = mat.getRowCount();
+    if (mat.getColCount() != n or rhs.getRowCount() != n or rhs.getColCount() != 1)
+    {
+        throw std::invalid_argument("PCG requires a (n,n) matrix and a (n,1) right hand side");
+    }
+
+    std::vector<double> diagonal(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        diagonal[i] = mat.get(i, i);
+        if (!(diagonal[i] > 0))
+        {
+            throw std::invalid_argument("PCG requires a positive diagonal, row " + std::to_string(i) + " is not");
+        }
+    }
+
+    Incomplete_Cholesky_t cholesky;
+    std::unique_ptr<Sparse_AMG> multigrid;
+    if (options.preconditioner == Preconditioner_t::ic0)
+    {
+        cholesky = incompleteCholesky(mat);
+    }
+    else if (options.preconditioner == Preconditioner_t::amg)
+    {
+        multigrid = std::make_unique<Sparse_AMG>(mat, options.amg);
+    }
+
+    auto precondition = [&](std::vector<double>& vec)
+    {
+        if (options.preconditioner == Preconditioner_t::ic0)
+        {
+            applyIncompleteCholesky(cholesky, vec);
+        }
+        else if (options.preconditioner == Preconditioner_t::amg)
+        {
+            multigrid->precondition(vec);
+        }
+        else
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                vec[i] /= diagonal[i];
+            }
+        }
+    };
+
+    // Start from x = 0 so r = b
+    std::vector<double> x(n, 0.0);
+    std::vector<double> r(rhs.get_data(), rhs.get_data() + n);
+    std::vector<double> z(n);
+    std::vector<double> p(n);
+    std::vector<double> q(n);
+
+    Matrix<double> solution(n, 1);
+    stats = PCG_Stats_t();
+
+    double rhsNorm = std::sqrt(dotProduct(r, r));
+    if (rhsNorm == 0)
+    {
+        return solution;
+    }
+
+    z = r;
+    precondition(z);
+    p = z;
+    double rz = dotProduct(r, z);
+    stats.residual = 1;
+
+    while (stats.residual > options.tolerance)
+    {
+        if (stats.iterations == options.max_iterations)
+        {
+            stats.converged = false;
+            break;
+        }
+        stats.iterations++;
+
+        sparseMultiply(mat, p, q);
+        double alpha = rz / dotProduct(p, q);
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+
+        stats.residual = std::sqrt(dotProduct(r, r)) / rhsNorm;
+
+        z = r;
+        precondition(z);
+        double rzNext = dotProduct(r, z);
+        double beta = rzNext / rz;
+        rz = rzNext;
+        for (size_t i = 0; i < n; i++)
+        {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+
+    std::copy(x.begin(), x.end(), solution.get_data());
+    return solution;
+}
+
+///--------------------------------------------------------
+Matrix<double> multigridSolve(const Sparse_Matrix<double>& mat, const Matrix<double>& rhs, const PCG_Options_t& options,
+    PCG_Stats_t& stats)
+{
+    size_t n = mat.getRowCount();
+    if (mat.getColCount() != n or rhs.getRowCount() != n or rhs.getColCount() != 1)
+    {
+        throw std::invalid_argument("Multigrid requires a (n,n) matrix and a (n,1) right hand side");
+    }
+
+    Sparse_AMG multigrid(mat, options.amg);
+
+    std::vector<double> x(n, 0.0);
+    std::vector<double> b(rhs.get_data(), rhs.get_data() + n);
+    std::vector<double> r(n);
+
+    Matrix<double> solution(n, 1);
+    stats = PCG_Stats_t();
+
+    double rhsNorm = std::sqrt(dotProduct(b, b));
+    if (rhsNorm == 0)
+    {
+        return solution;
+    }
+
+    stats.residual = 1;
+    while (stats.residual > options.tolerance)
+    {
+        if (stats.iterations == options.max_iterations)
+        {
+            stats.converged = false;
+            break;
+        }
+        stats.iterations++;
+
+        multigrid.vCycle(b, x);
+
+        sparseMultiply(mat, x, r);
+        for (size_t i = 0; i < n; i++)
+        {
+            r[i] = b[i] - r[i];
+        }
+        stats.residual = std::sqrt(dotProduct(r, r)) / rhsNorm;
+    }
+
+    std::copy(x.begin(), x.end(), solution.get_data());
+    return solution;
+}
@@ -0,0 +1,216 @@
+/// ------------------------------------------
+/// @file Thread_Pool.cpp
+///
+/// @brief Source for a fixed size pool of worker threads
+/// ------------------------------------------
+
+#include "../inc/Thread_Pool.h"
+
+#include <algorithm>
+
+///--------------------------------------------------------
+Thread_Pool::Thread_Pool(const size_t& threadCount)
+{
+    size_t count = threadCount;
+    if (count == 0)
+    {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_workers.emplace_back(&Thread_Pool::_worker_loop, this);
+    }
+}
+
+///--------------------------------------------------------
+Thread_Pool::~Thread_Pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_task_ready.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+///--------------------------------------------------------
+std::future<void> Thread_Pool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> result = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(packaged));
+    }
+    m_task_ready.notify_one();
+
+    return result;
+}
+
+///--------------------------------------------------------
+void Thread_Pool::parallelFor(const size_t& begin, const size_t& end, const std::function<void(size_t)>& body)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    // One contiguous block of indices per worker
+    size_t count = end - begin;
+    size_t blocks = std::min(count, m_workers.size());
+    std::vector<std::future<void>> results;
+    results.reserve(blocks);
+
+    for (size_t b = 0; b < blocks; b++)
+    {
+        size_t first = begin + (count * b) / blocks;
+        size_t last = begin + (count * (b + 1)) / blocks;
+        results.push_back(submit([first, last, &body]()
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                body(i);
+            }
+        }));
+    }
+
+    // Wait on every block before rethrowing so body is never used after return
+    for (std::future<void>& result : results)
+    {
+        result.wait();
+    }
+
+    for (std::future<void>& result : results)
+    {
+        result.get();
+    }
+}
+
+///--------------------------------------------------------
+void Thread_Pool::parallelForStealing(const size_t& begin, const size_t& end, const std::function<void(size_t)>& body)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    // Indices a worker has left, taken from the front by the owner and the back by thieves
+    struct Steal_Range_t
+    {
+        std::mutex mutex;
+        size_t next;
+        size_t last;
+    };
+
+    size_t count = end - begin;
+    size_t workers = std::min(count, m_workers.size());
+    std::vector<Steal_Range_t> ranges(workers);
+    for (size_t w = 0; w < workers; w++)
+    {
+        ranges[w].next = begin + (count * w) / workers;
+        ranges[w].last = begin + (count * (w + 1)) / workers;
+    }
+
+    std::vector<std::future<void>> results;
+    results.reserve(workers);
+
+    for (size_t w = 0; w < workers; w++)
+    {
+        results.push_back(submit([w, workers, &ranges, &body]()
+        {
+            Steal_Range_t& own = ranges[w];
+            while (true)
+            {
+                size_t index = 0;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (own.next < own.last)
+                    {
+                        index = own.next++;
+                        found = true;
+                    }
+                }
+
+                // Only one range is locked at a time, the stolen half is run as this worker's range
+                for (size_t v = 1; v < workers and !found; v++)
+                {
+                    Steal_Range_t& victim = ranges[(w + v) % workers];
+                    size_t first;
+                    size_t last;
+                    {
+                        std::lock_guard<std::mutex> lock(victim.mutex);
+                        if (victim.next >= victim.last)
+                        {
+                            continue;
+                        }
+
+                        last = victim.last;
+                        victim.last -= (victim.last - victim.next + 1) / 2;
+                        first = victim.last;
+                    }
+
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    index = first;
+                    own.next = first + 1;
+                    own.last = last;
+                    found = true;
+                }
+
+                // Every range was empty when checked, anything stolen meanwhile is run by its thief
+                if (!found)
+                {
+                    return;
+                }
+
+                body(index);
+            }
+        }));
+    }
+
+    // Wait on every worker before rethrowing so body and ranges are never used after return
+    for (std::future<void>& result : results)
+    {
+        result.wait();
+    }
+
+    for (std::future<void>& result : results)
+    {
+        result.get();
+    }
+}
+
+///--------------------------------------------------------
+size_t Thread_Pool::getThreadCount() const
+{
+    return m_workers.size();
+}
+
+///--------------------------------------------------------
+void Thread_Pool::_worker_loop()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_task_ready.wait(lock, [this]() { return m_stopping or !m_tasks.empty(); });
+
+            if (m_tasks.empty())
+            {
+                // Only reached once stopping with no work left
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
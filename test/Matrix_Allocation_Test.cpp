@@ -0,0 +1,178 @@
+/// ------------------------------------------
+/// @file Matrix_Allocation_Test.cpp
+///
+/// @brief Counts the heap allocations of Matrix arithmetic by replacing the global operator new
+/// ------------------------------------------
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <iostream>
+#include <string>
+
+#include "Matrix.h"
+
+/// @brief Allocations made through any form of operator new since the program started
+static size_t allocation_count = 0;
+
+void* operator new(std::size_t size)
+{
+    allocation_count++;
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    allocation_count++;
+    size_t alignment = static_cast<size_t>(align);
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+/// @brief Number of failed checks
+static int failures = 0;
+
+///--------------------------------------------------------
+/// @brief Reports a check whose allocation count differs from the expected count
+///
+/// @param name what was counted
+/// @param expected allocations the operation should make
+/// @param counted allocations it made
+static void checkCount(const std::string& name, const size_t& expected, const size_t& counted)
+{
+    if (counted != expected)
+    {
+        std::cerr << name << ": expected " << expected << " allocations, counted " << counted << std::endl;
+        failures++;
+    }
+}
+
+///--------------------------------------------------------
+/// @brief Diagonally dominant (n,n) matrix, so it has an inverse without pivoting trouble
+///
+/// @param n side length
+/// @param seed offset of the off diagonal values
+///
+/// @return the matrix
+static Matrix<double> testMatrix(const size_t& n, const double& seed)
+{
+    Matrix<double> mat(n, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            mat.set(i, j, (i == j) ? 4.0 * n : seed + (double) ((i * 7 + j * 3) % 5));
+        }
+    }
+
+    return mat;
+}
+
+int main()
+{
+    const size_t n = 16;
+    Matrix<double> a = testMatrix(n, 0.5);
+    Matrix<double> b = testMatrix(n, 1.5);
+    Matrix<double> c = testMatrix(n, 2.5);
+    Matrix<double> currents(n, 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        currents.set(i, 0, 1.0 + i);
+    }
+
+    // One each for the identity, the LU copy, the pivot vector and the product
+    size_t before = allocation_count;
+    Matrix<double> voltages = a.inverse() % currents;
+    checkCount("inverse() % b", 4, allocation_count - before);
+
+    Matrix<double> residual = a % voltages - currents;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (std::fabs(residual.get(i, 0)) > 1e-9)
+        {
+            std::cerr << "inverse() % b: residual " << residual.get(i, 0) << " in row " << i << std::endl;
+            failures++;
+        }
+    }
+
+    // The whole chain is one expression, evaluated into the only new matrix
+    before = allocation_count;
+    Matrix<double> sum = a + b - c;
+    checkCount("a + b - c", 1, allocation_count - before);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            if (sum.get(i, j) != a.get(i, j) + b.get(i, j) - c.get(i, j))
+            {
+                std::cerr << "a + b - c: wrong value at (" << i << ", " << j << ")" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    // Assigning a chain to an existing matrix of the same size reuses its storage
+    before = allocation_count;
+    sum = a - b + c;
+    checkCount("sum = a - b + c", 0, allocation_count - before);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}